@@ -0,0 +1,59 @@
+# Simulation core: neural networks, subjects and the genetic algorithm,
+# without any graphics. Both the application and the unit tests link to it,
+# and it can be used to train on machines without a display.
+QT -= core gui
+
+TEMPLATE = lib
+CONFIG += staticlib c++17 thread
+TARGET = core
+
+SOURCES += \
+    ../shipyard/activation.cpp \
+    ../shipyard/batchengine.cpp \
+    ../shipyard/binary.cpp \
+    ../shipyard/crossover.cpp \
+    ../shipyard/encoding.cpp \
+    ../shipyard/exporter.cpp \
+    ../shipyard/fastmath.cpp \
+    ../shipyard/fitness.cpp \
+    ../shipyard/inputoutput.cpp \
+    ../shipyard/layerkernel.cpp \
+    ../shipyard/manager.cpp \
+    ../shipyard/math.cpp \
+    ../shipyard/mutation.cpp \
+    ../shipyard/networkpool.cpp \
+    ../shipyard/neuralnetwork.cpp \
+    ../shipyard/quantization.cpp \
+    ../shipyard/responsetable.cpp \
+    ../shipyard/scenario.cpp \
+    ../shipyard/settings.cpp \
+    ../shipyard/sparse.cpp \
+    ../shipyard/subjectcore.cpp \
+    ../shipyard/threadpool.cpp \
+    ../shipyard/weightset.cpp
+
+HEADERS += \
+    ../shipyard/activation.hh \
+    ../shipyard/batchengine.hh \
+    ../shipyard/binary.hh \
+    ../shipyard/crossover.hh \
+    ../shipyard/encoding.hh \
+    ../shipyard/exporter.hh \
+    ../shipyard/fastmath.hh \
+    ../shipyard/fitness.hh \
+    ../shipyard/inputoutput.hh \
+    ../shipyard/layerkernel.hh \
+    ../shipyard/manager.hh \
+    ../shipyard/math.hh \
+    ../shipyard/mutation.hh \
+    ../shipyard/networkpool.hh \
+    ../shipyard/neuralnetwork.hh \
+    ../shipyard/quantization.hh \
+    ../shipyard/responsetable.hh \
+    ../shipyard/scenario.hh \
+    ../shipyard/settings.hh \
+    ../shipyard/simulationobserver.hh \
+    ../shipyard/sparse.hh \
+    ../shipyard/subjectcore.hh \
+    ../shipyard/threadpool.hh \
+    ../shipyard/weightset.hh
@@ -0,0 +1,87 @@
+#include "activation.hh"
+#include "fastmath.hh"
+
+namespace
+{
+    template <typename T>
+    void activate_layer_fast_sigmoid(T *values, unsigned int count,
+                                     unsigned int)
+    {
+        fast_sigmoid_row(values, count);
+    }
+
+    template <typename T>
+    void activate_layer_fast_hyperbolic_tangent(T *values, unsigned int count,
+                                                unsigned int)
+    {
+        fast_hyperbolic_tangent_row(values, count);
+    }
+
+    template <typename T>
+    void activate_layer_fast_gaussian(T *values, unsigned int count,
+                                      unsigned int)
+    {
+        fast_gaussian_row(values, count);
+    }
+
+    template <typename T>
+    void activate_layer_fast_softmax(T *values, unsigned int count,
+                                     unsigned int width)
+    {
+        if (width == 0) return;
+        for (unsigned int start = 0; start + width <= count; start += width) {
+            fast_softmax_row(values + start, width);
+        }
+    }
+
+    template <typename T>
+    layer_activation<T> resolve_fast_activation(activation_type type)
+    {
+        switch(type) {
+        case HYPERBOLIC_TANGENT:
+            return activate_layer_fast_hyperbolic_tangent<T>;
+        case GAUSSIAN:
+            return activate_layer_fast_gaussian<T>;
+        case SOFTMAX:
+            return activate_layer_fast_softmax<T>;
+        default:
+            return activate_layer_fast_sigmoid<T>;
+        }
+    }
+}
+
+template <typename T>
+layer_activation<T> resolve_activation(activation_type type, bool fast)
+{
+    switch(type) {
+    case SIGMOID:
+        if (fast) return resolve_fast_activation<T>(type);
+        return activate_layer<SIGMOID, T>;
+    case HYPERBOLIC_TANGENT:
+        if (fast) return resolve_fast_activation<T>(type);
+        return activate_layer<HYPERBOLIC_TANGENT, T>;
+    case SIGN:
+        return activate_layer<SIGN, T>;
+    case HEAVISIDE:
+        return activate_layer<HEAVISIDE, T>;
+    case RELU:
+        return activate_layer<RELU, T>;
+    case RELU_LEAKY:
+        return activate_layer<RELU_LEAKY, T>;
+    case GAUSSIAN:
+        if (fast) return resolve_fast_activation<T>(type);
+        return activate_layer<GAUSSIAN, T>;
+    case SOFTMAX:
+        if (fast) return resolve_fast_activation<T>(type);
+        return activate_layer_softmax<T>;
+    case NO_ACTIVATION:
+        if (fast) return resolve_fast_activation<T>(SIGMOID);
+        return activate_layer<SIGMOID, T>;
+    }
+    return activate_layer<SIGMOID, T>;
+}
+
+template layer_activation<double>
+resolve_activation<double>(activation_type, bool);
+template layer_activation<float>
+resolve_activation<float>(activation_type, bool);
@@ -0,0 +1,187 @@
+#ifndef ACTIVATION_HH
+#define ACTIVATION_HH
+
+#include "settings.hh"
+#include <cmath>
+#include <limits>
+
+/*!
+ * \file activation.hh
+ * \brief Activation kernels that process a whole layer at once. Each
+ * activation function type has its own specialization, so the loops
+ * contain no branching on the type and can be inlined and vectorized.
+ * The kernel for a layer is resolved once, with resolve_activation.
+ * \author terratenff
+ */
+
+/*!
+ * \def layer_activation
+ * \brief Pointer to an activation kernel of given precision.
+ *
+ * The kernel activates "count" values in place. Element-wise
+ * activations ignore "width". Softmax normalizes every consecutive
+ * group of "width" values separately, which lets the values of
+ * several layers (of different networks) be activated in one call.
+ */
+template <typename T>
+using layer_activation = void (*)(T *values,
+                                  unsigned int count,
+                                  unsigned int width);
+
+/*!
+ * \def activation_function
+ * \brief Pointer to a double precision activation kernel.
+ */
+using activation_function = layer_activation<double>;
+
+/*!
+ * \def activation_function_float
+ * \brief Pointer to a single precision activation kernel.
+ */
+using activation_function_float = layer_activation<float>;
+
+/*!
+ * \struct Activation
+ * \brief Element-wise activation function for a single value.
+ * Matches the functions of math.hh.
+ * \author terratenff
+ */
+template <activation_type Type>
+struct Activation;
+
+template <>
+struct Activation<SIGMOID> {
+    template <typename T>
+    static T apply(T x)
+    {
+        return 1 / (1 + std::exp(-x));
+    }
+};
+
+template <>
+struct Activation<HYPERBOLIC_TANGENT> {
+    template <typename T>
+    static T apply(T x)
+    {
+        return (2 / (1 + std::exp(-2*x))) - 1;
+    }
+};
+
+template <>
+struct Activation<SIGN> {
+    template <typename T>
+    static T apply(T x)
+    {
+        if (std::abs(x) < T(std::numeric_limits<double>::epsilon())) return 0;
+        else if (x > 0) return 1;
+        else return -1;
+    }
+};
+
+template <>
+struct Activation<HEAVISIDE> {
+    template <typename T>
+    static T apply(T x)
+    {
+        if (std::abs(x) < T(std::numeric_limits<double>::epsilon())
+                || x > 0) return 1;
+        else return 0;
+    }
+};
+
+template <>
+struct Activation<RELU> {
+    template <typename T>
+    static T apply(T x)
+    {
+        return std::fmax(T(0), x);
+    }
+};
+
+template <>
+struct Activation<RELU_LEAKY> {
+    template <typename T>
+    static T apply(T x)
+    {
+        return x > 0 ? x : x * T(0.01);
+    }
+};
+
+template <>
+struct Activation<GAUSSIAN> {
+    template <typename T>
+    static T apply(T x)
+    {
+        return std::exp(-(x*x));
+    }
+};
+
+/*!
+ * \fn activate_layer
+ * \brief Activation kernel for an element-wise activation function.
+ * \param values Target values, activated in place.
+ * \param count Number of values.
+ */
+template <activation_type Type, typename T>
+void activate_layer(T *values, unsigned int count, unsigned int)
+{
+    for (unsigned int i = 0; i < count; i++) {
+        values[i] = Activation<Type>::apply(values[i]);
+    }
+}
+
+/*!
+ * \fn activate_layer_softmax
+ * \brief Activation kernel for softmax.
+ * \param values Target values, activated in place.
+ * \param count Number of values.
+ * \param width Size of a group of values that is normalized together.
+ */
+template <typename T>
+void activate_layer_softmax(T *values, unsigned int count, unsigned int width)
+{
+    if (width == 0) return;
+    for (unsigned int start = 0; start + width <= count; start += width) {
+        T *group = values + start;
+        T total = 0;
+        for (unsigned int i = 0; i < width; i++) {
+            group[i] = std::exp(group[i]);
+            total += group[i];
+        }
+        for (unsigned int i = 0; i < width; i++) {
+            group[i] /= total;
+        }
+    }
+}
+
+/*!
+ * \fn resolve_activation
+ * \brief Selects the activation kernel for an activation function type.
+ * \param type Activation function type. NO_ACTIVATION results in
+ * sigmoid.
+ * \param fast If true, sigmoid, hyperbolic tangent, gaussian and
+ * softmax use the approximations of fastmath.hh.
+ * \return Activation kernel of given precision (double by default).
+ */
+template <typename T = double>
+layer_activation<T> resolve_activation(activation_type type,
+                                       bool fast = false);
+
+/*!
+ * \fn is_binary_activation
+ * \brief Checks whether an activation function only produces values
+ * -1, 0 and 1, so that its results can be bit-packed (see binary.hh).
+ * \param type Activation function type.
+ * \return true for SIGN and HEAVISIDE.
+ */
+inline bool is_binary_activation(activation_type type)
+{
+    return type == SIGN || type == HEAVISIDE;
+}
+
+extern template layer_activation<double>
+resolve_activation<double>(activation_type, bool);
+extern template layer_activation<float>
+resolve_activation<float>(activation_type, bool);
+
+#endif // ACTIVATION_HH
@@ -0,0 +1,637 @@
+#include "batchengine.hh"
+#include "layerkernel.hh"
+#include <type_traits>
+
+namespace
+{
+    template <typename T>
+    const BasicWeightSet<T> &weight_set(const NeuralNetwork *network);
+
+    template <>
+    const BasicWeightSet<double> &weight_set(const NeuralNetwork *network)
+    {
+        return network->getWeightSet();
+    }
+
+    template <>
+    const BasicWeightSet<float> &weight_set(const NeuralNetwork *network)
+    {
+        return network->getFloatWeightSet();
+    }
+
+    template <>
+    const BasicWeightSet<int8_t> &weight_set(const NeuralNetwork *network)
+    {
+        return network->getQuantizedWeightSet().getWeights();
+    }
+}
+
+BatchEngine::BatchEngine():
+    population_(0),
+    precision_(DOUBLE_PRECISION),
+    workers_(1),
+    widest_(0),
+    widest_stride_(0),
+    chunk_size_(1),
+    binary_(false),
+    memoize_(false),
+    hidden_activation_(resolve_activation<double>(SIGMOID)),
+    output_activation_(resolve_activation<double>(SIGMOID)),
+    float_hidden_activation_(resolve_activation<float>(SIGMOID)),
+    float_output_activation_(resolve_activation<float>(SIGMOID))
+{
+}
+
+void BatchEngine::pack(const std::vector<NeuralNetwork*> &networks)
+{
+    unsigned int previous = population_;
+    population_ = static_cast<unsigned int>(networks.size());
+    if (population_ == 0) {
+        layers_.clear();
+        return;
+    }
+
+    const NeuralNetwork *first = networks[0];
+    bool reshaped = layers_ != first->getLayers()
+            || previous != population_
+            || precision_ != first->getPrecision()
+            || binary_ != first->isBinary();
+    layers_ = first->getLayers();
+    precision_ = first->getPrecision();
+    binary_ = first->isBinary();
+    hidden_activation_ =
+            resolve_activation<double>(first->getHiddenActivation(),
+                                       first->getFastMath());
+    output_activation_ =
+            resolve_activation<double>(first->getOutputActivation(),
+                                       first->getFastMath());
+    float_hidden_activation_ =
+            resolve_activation<float>(first->getHiddenActivation(),
+                                      first->getFastMath());
+    float_output_activation_ =
+            resolve_activation<float>(first->getOutputActivation(),
+                                      first->getFastMath());
+
+    if (reshaped) {
+        strides_.clear();
+        block_sizes_.clear();
+        weight_offsets_.clear();
+        neuron_widths_.clear();
+        neuron_offsets_.clear();
+
+        size_t weightTotal = 0;
+        for (unsigned int i = 1; i < layers_.size(); i++) {
+            // Rows are padded to the SIMD width of the precision in use.
+            unsigned int stride = first->getWeightSet().stride(i - 1);
+            size_t blockSize = first->getWeightSet().blockSize(i - 1);
+            if (precision_ == SINGLE_PRECISION) {
+                stride = first->getFloatWeightSet().stride(i - 1);
+                blockSize = first->getFloatWeightSet().blockSize(i - 1);
+            } else if (precision_ == QUANTIZED_PRECISION) {
+                const Int8WeightSet &weights =
+                        first->getQuantizedWeightSet().getWeights();
+                stride = weights.stride(i - 1);
+                blockSize = weights.blockSize(i - 1);
+            }
+            strides_.push_back(stride);
+            block_sizes_.push_back(blockSize);
+            weight_offsets_.push_back(weightTotal);
+            weightTotal += population_ * blockSize;
+        }
+
+        // Each network's neurons of a layer that feeds a weight block
+        // are padded with zeros up to the row stride, so that the
+        // kernels run over whole strides. Quantized inputs are
+        // padded when they are quantized instead.
+        size_t neuronTotal = 0;
+        for (unsigned int i = 0; i < layers_.size(); i++) {
+            unsigned int width = layers_[i];
+            if (i < strides_.size() && precision_ != QUANTIZED_PRECISION) {
+                width = strides_[i];
+            }
+            neuron_widths_.push_back(width);
+            neuron_offsets_.push_back(neuronTotal);
+            neuronTotal += static_cast<size_t>(population_) * width;
+        }
+
+        widest_ = 0;
+        for (unsigned int i = 0; i < layers_.size(); i++) {
+            if (layers_[i] > widest_) widest_ = layers_[i];
+        }
+        widest_stride_ = 0;
+        for (unsigned int stride : strides_) {
+            if (stride > widest_stride_) widest_stride_ = stride;
+        }
+
+        // Memory that processing a single network goes through.
+        size_t weightBytes = sizeof(double);
+        size_t neuronBytes = sizeof(double);
+        if (precision_ == SINGLE_PRECISION) {
+            weightBytes = sizeof(float);
+            neuronBytes = sizeof(float);
+        } else if (precision_ == QUANTIZED_PRECISION) {
+            weightBytes = sizeof(int8_t);
+            // Biases are laid out like the neurons.
+            neuronBytes = 2 * sizeof(float);
+        }
+        size_t networkBytes = weightTotal / population_ * weightBytes
+                + neuronTotal / population_ * neuronBytes;
+        chunk_size_ = static_cast<unsigned int>(CHUNK_BYTES / networkBytes);
+        if (chunk_size_ == 0) chunk_size_ = 1;
+
+        outputs_.assign(static_cast<size_t>(population_) * getOutputCount(), 0);
+        weights_.clear();
+        neurons_.clear();
+        float_weights_.clear();
+        float_neurons_.clear();
+        quantized_weights_.clear();
+        quantized_biases_.clear();
+        weight_scales_.clear();
+        quantized_inputs_.clear();
+        accumulators_.clear();
+        if (precision_ == DOUBLE_PRECISION) {
+            weights_.assign(weightTotal, 0);
+            neurons_.assign(neuronTotal, 0);
+        } else {
+            float_neurons_.assign(neuronTotal, 0);
+        }
+        if (precision_ == SINGLE_PRECISION) {
+            float_weights_.assign(weightTotal, 0);
+        } else if (precision_ == QUANTIZED_PRECISION) {
+            quantized_weights_.assign(weightTotal, 0);
+            quantized_biases_.assign(neuronTotal, 0);
+            weight_scales_.assign(static_cast<size_t>(population_)
+                                  * (layers_.size() - 1), 0);
+            quantized_inputs_.assign(static_cast<size_t>(workers_)
+                                     * widest_stride_, 0);
+            accumulators_.assign(static_cast<size_t>(workers_) * widest_, 0);
+        }
+
+        binary_words_.clear();
+        mask_offsets_.clear();
+        scale_offsets_.clear();
+        positive_masks_.clear();
+        negative_masks_.clear();
+        binary_scales_.clear();
+        sign_masks_.clear();
+        if (binary_) {
+            size_t maskTotal = 0;
+            size_t scaleTotal = 0;
+            for (unsigned int i = 1; i < layers_.size(); i++) {
+                unsigned int words = binary_words(layers_[i - 1]);
+                binary_words_.push_back(words);
+                mask_offsets_.push_back(maskTotal);
+                scale_offsets_.push_back(scaleTotal);
+                maskTotal += static_cast<size_t>(population_) * layers_[i]
+                        * words;
+                scaleTotal += static_cast<size_t>(population_) * layers_[i];
+            }
+            positive_masks_.assign(maskTotal, 0);
+            negative_masks_.assign(maskTotal, 0);
+            binary_scales_.assign(scaleTotal, 0);
+            sign_masks_.assign(2 * static_cast<size_t>(workers_)
+                               * binary_words(widest_), 0);
+        }
+    }
+
+    if (precision_ == SINGLE_PRECISION) {
+        packWeights(networks, float_weights_);
+    } else if (precision_ == QUANTIZED_PRECISION) {
+        packWeights(networks, quantized_weights_);
+        for (unsigned int n = 0; n < population_; n++) {
+            const QuantizedWeightSet &weights =
+                    networks[n]->getQuantizedWeightSet();
+            for (unsigned int i = 1; i < layers_.size(); i++) {
+                weight_scales_[(i - 1) * population_ + n] =
+                        weights.getScale(i - 1);
+                // Biases are laid out like the neurons they belong to.
+                const float *source = weights.getBiases(i - 1);
+                float *biases = quantized_biases_.data() + neuron_offsets_[i]
+                        + static_cast<size_t>(n) * neuron_widths_[i];
+                for (unsigned int j = 0; j < layers_[i]; j++) {
+                    biases[j] = source[j];
+                }
+            }
+        }
+    } else {
+        packWeights(networks, weights_);
+    }
+
+    // Layers that receive hidden neurons use the binarized weights.
+    if (binary_) {
+        for (unsigned int n = 0; n < population_; n++) {
+            const BinaryWeightSet &binary = networks[n]->getBinaryWeightSet();
+            for (unsigned int i = 1; i < layers_.size(); i++) {
+                unsigned int rows = layers_[i];
+                size_t maskSize = static_cast<size_t>(rows)
+                        * binary_words_[i - 1];
+                size_t maskStart = mask_offsets_[i - 1] + n * maskSize;
+                size_t scaleStart = scale_offsets_[i - 1]
+                        + static_cast<size_t>(n) * rows;
+                for (size_t w = 0; w < maskSize; w++) {
+                    positive_masks_[maskStart + w] = binary.positive(i - 1)[w];
+                    negative_masks_[maskStart + w] = binary.negative(i - 1)[w];
+                }
+                for (unsigned int j = 0; j < rows; j++) {
+                    binary_scales_[scaleStart + j] = binary.scales(i - 1)[j];
+                }
+            }
+        }
+    }
+
+    // Pruned networks keep their sparse blocks in CSR form.
+    bool sparse = false;
+    if (precision_ == DOUBLE_PRECISION) {
+        for (const NeuralNetwork *network : networks) {
+            for (unsigned int i = 1; i < layers_.size(); i++) {
+                if (network->getSparseWeightSet().isSparse(i - 1)) {
+                    sparse = true;
+                }
+            }
+        }
+    }
+    sparse_weights_.clear();
+    if (sparse) {
+        for (const NeuralNetwork *network : networks) {
+            sparse_weights_.push_back(&network->getSparseWeightSet());
+        }
+    }
+
+    // Remembered outputs are only valid for the packed weights.
+    input_type input = networks[0]->getInputCode();
+    memoize_ = layers_[0] == MEMOIZED_INPUTS
+            && (input == FOUR_WAY_SEARCH || input == FOUR_CORNER_SEARCH);
+    zero_inputs_.assign(population_, 0);
+    zero_ready_.assign(population_, 0);
+    zero_outputs_.assign(static_cast<size_t>(population_) * getOutputCount(),
+                         0);
+
+    tables_.clear();
+    for (unsigned int n = 0; n < population_; n++) {
+        if (!networks[n]->hasResponseTable()) {
+            tables_.clear();
+            break;
+        }
+        tables_.push_back(&networks[n]->getResponseTable());
+    }
+}
+
+void BatchEngine::setInputs(unsigned int n, const Row &inputs)
+{
+    unsigned int count = static_cast<unsigned int>(inputs.size());
+    if (count > layers_[0]) count = layers_[0];
+
+    size_t start = static_cast<size_t>(n) * neuron_widths_[0];
+    if (precision_ != DOUBLE_PRECISION) {
+        for (unsigned int i = 0; i < count; i++) {
+            float_neurons_[start + i] = static_cast<float>(inputs[i]);
+        }
+    } else {
+        for (unsigned int i = 0; i < count; i++) {
+            neurons_[start + i] = inputs[i];
+        }
+    }
+
+    if (memoize_) {
+        char zero = 1;
+        for (unsigned int i = 0; i < count; i++) {
+            if (inputs[i] != 0) zero = 0;
+        }
+        zero_inputs_[n] = zero;
+    }
+}
+
+void BatchEngine::run()
+{
+    run(0, population_, 0);
+}
+
+void BatchEngine::run(unsigned int first,
+                      unsigned int last,
+                      unsigned int worker)
+{
+    if (layers_.empty()) return;
+    if (last > population_) last = population_;
+    if (first >= last) return;
+
+    if (!tables_.empty()) {
+        runTables(first, last);
+        return;
+    }
+
+    if (precision_ == DOUBLE_PRECISION) {
+        runLayers(first,
+                  last,
+                  worker,
+                  weights_.data(),
+                  neurons_.data(),
+                  hidden_activation_,
+                  output_activation_);
+    } else {
+        if (precision_ == SINGLE_PRECISION) {
+            runLayers(first,
+                      last,
+                      worker,
+                      float_weights_.data(),
+                      float_neurons_.data(),
+                      float_hidden_activation_,
+                      float_output_activation_);
+        } else {
+            runQuantized(first, last, worker);
+        }
+
+        size_t width = getOutputCount();
+        const float *outputs = float_neurons_.data()
+                + neuron_offsets_[layers_.size() - 1];
+        for (size_t i = first * width; i < last * width; i++) {
+            outputs_[i] = outputs[i];
+        }
+    }
+
+    if (memoize_) memoizeOutputs(first, last);
+}
+
+void BatchEngine::setWorkerCount(unsigned int count)
+{
+    if (count == 0) count = 1;
+    if (count == workers_) return;
+    workers_ = count;
+    if (precision_ == QUANTIZED_PRECISION && !layers_.empty()) {
+        quantized_inputs_.assign(static_cast<size_t>(workers_)
+                                 * widest_stride_, 0);
+        accumulators_.assign(static_cast<size_t>(workers_) * widest_, 0);
+    }
+    if (binary_ && !layers_.empty()) {
+        sign_masks_.assign(2 * static_cast<size_t>(workers_)
+                           * binary_words(widest_), 0);
+    }
+}
+
+unsigned int BatchEngine::getChunkSize() const
+{
+    return chunk_size_;
+}
+
+const double *BatchEngine::getOutputs(unsigned int n) const
+{
+    unsigned int width = layers_[layers_.size() - 1];
+    if (precision_ != DOUBLE_PRECISION) {
+        return outputs_.data() + static_cast<size_t>(n) * width;
+    }
+    return neurons_.data() + neuron_offsets_[layers_.size() - 1]
+            + static_cast<size_t>(n) * width;
+}
+
+unsigned int BatchEngine::getOutputCount() const
+{
+    if (layers_.empty()) return 0;
+    return layers_[layers_.size() - 1];
+}
+
+unsigned int BatchEngine::getPopulation() const
+{
+    return population_;
+}
+
+precision_type BatchEngine::getPrecision() const
+{
+    return precision_;
+}
+
+bool BatchEngine::isMemoized(unsigned int n) const
+{
+    return memoize_ && zero_inputs_[n] && zero_ready_[n];
+}
+
+void BatchEngine::memoizeOutputs(unsigned int first, unsigned int last)
+{
+    unsigned int width = getOutputCount();
+    for (unsigned int n = first; n < last; n++) {
+        if (!zero_inputs_[n]) continue;
+        double *outputs = outputRow(n);
+        double *known = zero_outputs_.data() + static_cast<size_t>(n) * width;
+        if (zero_ready_[n]) {
+            for (unsigned int i = 0; i < width; i++) outputs[i] = known[i];
+        } else {
+            for (unsigned int i = 0; i < width; i++) known[i] = outputs[i];
+            zero_ready_[n] = 1;
+        }
+    }
+}
+
+double *BatchEngine::outputRow(unsigned int n)
+{
+    unsigned int width = getOutputCount();
+    if (precision_ != DOUBLE_PRECISION) {
+        return outputs_.data() + static_cast<size_t>(n) * width;
+    }
+    return neurons_.data() + neuron_offsets_[layers_.size() - 1]
+            + static_cast<size_t>(n) * width;
+}
+
+void BatchEngine::runTables(unsigned int first, unsigned int last)
+{
+    // Networks with a response table have a single input.
+    unsigned int width = getOutputCount();
+    double *outputs = outputs_.data();
+    if (precision_ == DOUBLE_PRECISION) {
+        outputs = neurons_.data() + neuron_offsets_[layers_.size() - 1];
+    }
+    for (unsigned int n = first; n < last; n++) {
+        size_t start = static_cast<size_t>(n) * neuron_widths_[0];
+        double input = precision_ == DOUBLE_PRECISION
+                ? neurons_[start] : static_cast<double>(float_neurons_[start]);
+        tables_[n]->lookup(input, outputs + static_cast<size_t>(n) * width);
+    }
+}
+
+void BatchEngine::runQuantized(unsigned int first,
+                               unsigned int last,
+                               unsigned int worker)
+{
+    int8_t *quantizedInputs = quantized_inputs_.data()
+            + static_cast<size_t>(worker) * widest_stride_;
+    int32_t *accumulators = accumulators_.data()
+            + static_cast<size_t>(worker) * widest_;
+    for (unsigned int i = 1; i < layers_.size(); i++) {
+        bool outputLayer = i == layers_.size() - 1;
+        activation_function_float activate = outputLayer
+                ? float_output_activation_ : float_hidden_activation_;
+        unsigned int rows = layers_[i];
+        unsigned int columns = layers_[i - 1];
+        unsigned int stride = strides_[i - 1];
+        size_t blockSize = block_sizes_[i - 1];
+
+        const int8_t *block = quantized_weights_.data()
+                + weight_offsets_[i - 1];
+        const float *scales = weight_scales_.data()
+                + static_cast<size_t>(i - 1) * population_;
+        const float *biases = quantized_biases_.data() + neuron_offsets_[i];
+        const float *input = float_neurons_.data() + neuron_offsets_[i - 1];
+        float *result = float_neurons_.data() + neuron_offsets_[i];
+
+        for (unsigned int n = first; n < last; n++) {
+            if (isMemoized(n)) continue;
+
+            // Stale inputs beyond the columns meet zero weights.
+            float inputScale =
+                    quantize_values(input + static_cast<size_t>(n) * columns,
+                                    columns,
+                                    quantizedInputs);
+            dense_layer_int8(block + n * blockSize,
+                             rows,
+                             stride,
+                             stride,
+                             quantizedInputs,
+                             accumulators);
+
+            float scale = inputScale * scales[n];
+            float *output = result + static_cast<size_t>(n) * rows;
+            const float *bias = biases + static_cast<size_t>(n) * rows;
+            for (unsigned int j = 0; j < rows; j++) {
+                output[j] = accumulators[j] * scale + bias[j];
+            }
+        }
+
+        activateLayer(activate, result, first, last, rows, rows);
+    }
+}
+
+template <typename T>
+void BatchEngine::packWeights(const std::vector<NeuralNetwork*> &networks,
+                              AlignedVector<T> &target)
+{
+    for (unsigned int n = 0; n < population_; n++) {
+        const BasicWeightSet<T> &weights = weight_set<T>(networks[n]);
+        for (unsigned int i = 0; i < weights.layerCount(); i++) {
+            // The groups of a block, the biases last, are laid back to
+            // back.
+            T *block = target.data() + weight_offsets_[i]
+                    + n * block_sizes_[i];
+            for (unsigned int g = 0; g < weights.groupCount(i); g++) {
+                const T *source = weights.group(i, g);
+                size_t groupSize = weights.groupSize(i, g);
+                for (size_t w = 0; w < groupSize; w++) {
+                    block[w] = source[w];
+                }
+                block += groupSize;
+            }
+        }
+    }
+}
+
+template <typename T>
+void BatchEngine::runLayers(unsigned int first,
+                            unsigned int last,
+                            unsigned int worker,
+                            const T *weights,
+                            T *neurons,
+                            layer_activation<T> hidden,
+                            layer_activation<T> output)
+{
+    for (unsigned int i = 1; i < layers_.size(); i++) {
+        bool outputLayer = i == layers_.size() - 1;
+        layer_activation<T> activate = outputLayer ? output : hidden;
+        unsigned int rows = layers_[i];
+        unsigned int stride = strides_[i - 1];
+        size_t blockSize = block_sizes_[i - 1];
+
+        const T *block = weights + weight_offsets_[i - 1];
+        const T *input = neurons + neuron_offsets_[i - 1];
+        T *result = neurons + neuron_offsets_[i];
+
+        unsigned int inputWidth = neuron_widths_[i - 1];
+        unsigned int width = neuron_widths_[i];
+        unsigned int words = 0;
+        uint64_t *positive = nullptr;
+        uint64_t *negative = nullptr;
+        if (binary_) {
+            words = binary_words_[i - 1];
+            positive = sign_masks_.data()
+                    + 2 * static_cast<size_t>(worker) * binary_words(widest_);
+            negative = positive + binary_words(widest_);
+        }
+        for (unsigned int n = first; n < last; n++) {
+            if (isMemoized(n)) continue;
+
+            // Biases follow the rows of each network's block.
+            const T *networkBlock = block + n * blockSize;
+            const T *networkInput =
+                    input + static_cast<size_t>(n) * inputWidth;
+            const T *bias = networkBlock + static_cast<size_t>(rows) * stride;
+            T *networkResult = result + static_cast<size_t>(n) * width;
+            if constexpr (std::is_same<T, double>::value) {
+                if (binary_ && i > 1) {
+                    // Inputs are hidden neurons, i.e. -1, 0 or 1.
+                    size_t maskStart = mask_offsets_[i - 1]
+                            + static_cast<size_t>(n) * rows * words;
+                    size_t scaleStart = scale_offsets_[i - 1]
+                            + static_cast<size_t>(n) * rows;
+                    pack_signs(networkInput, layers_[i - 1],
+                               positive, negative);
+                    binary_layer(positive_masks_.data() + maskStart,
+                                 negative_masks_.data() + maskStart,
+                                 binary_scales_.data() + scaleStart,
+                                 rows,
+                                 words,
+                                 positive,
+                                 negative,
+                                 bias,
+                                 networkResult);
+                    continue;
+                }
+                if (!sparse_weights_.empty()
+                        && sparse_weights_[n]->isSparse(i - 1)) {
+                    const SparseWeightSet &sparse = *sparse_weights_[n];
+                    sparse_layer(sparse.values(i - 1),
+                                 sparse.columnIndices(i - 1),
+                                 sparse.rowStarts(i - 1),
+                                 rows,
+                                 networkInput,
+                                 bias,
+                                 networkResult);
+                    continue;
+                }
+            }
+            dense_layer(networkBlock,
+                        rows,
+                        stride,
+                        stride,
+                        networkInput,
+                        bias,
+                        networkResult);
+        }
+
+        activateLayer(activate, result, first, last, rows, width);
+    }
+}
+
+template <typename T>
+void BatchEngine::activateLayer(layer_activation<T> activate,
+                                T *neurons,
+                                unsigned int first,
+                                unsigned int last,
+                                unsigned int rows,
+                                unsigned int width)
+{
+    // Softmax normalizes each network's layer on its own, every
+    // other activation treats a run of networks as one row. Padded
+    // layers are activated network by network, so that the padding
+    // stays zero. Memoized networks were not computed, so they are
+    // left out.
+    unsigned int n = first;
+    while (n < last) {
+        if (isMemoized(n)) {
+            n++;
+            continue;
+        }
+        unsigned int end = n + 1;
+        if (width == rows) {
+            while (end < last && !isMemoized(end)) end++;
+        }
+        activate(neurons + static_cast<size_t>(n) * width,
+                 (end - n) * rows,
+                 rows);
+        n = end;
+    }
+}
@@ -0,0 +1,507 @@
+#ifndef BATCHENGINE_HH
+#define BATCHENGINE_HH
+
+#include "neuralnetwork.hh"
+#include "weightset.hh"
+#include <vector>
+
+/*!
+ * \class BatchEngine
+ * \brief Evaluates the Neural Networks of a whole population at once.
+ *
+ * Every network in a simulation shares the same structure, so their
+ * weights can be packed layer by layer into one buffer: all weight
+ * blocks between layers 0 and 1 first, then all blocks between layers
+ * 1 and 2 and so on. Each block carries the biases of its network
+ * (see weightset.hh). Neurons are packed the same way. A single call to
+ * run() then processes the population one layer at a time, streaming
+ * through contiguous memory instead of visiting each network
+ * separately.
+ *
+ * Networks in single precision mode are packed and evaluated in
+ * single precision, and networks in quantized precision mode with
+ * their 8-bit weights. Outputs are always returned in double
+ * precision. Weight blocks that a network in double precision mode
+ * keeps in sparse form (see sparse.hh) are processed with the sparse
+ * kernel, and networks whose activations are binary with the
+ * bit-packed kernel (see binary.hh), as feedForward does. If every
+ * network has an up-to-date response table (see
+ * NeuralNetwork::compileResponseTable), the tables are used instead
+ * of the layers.
+ *
+ * For input types FOUR_WAY_SEARCH and FOUR_CORNER_SEARCH, the inputs
+ * of a network are all zero most of the time, and then always give
+ * the same outputs. These outputs are remembered per network after
+ * they are first computed and looked up afterwards, until the next
+ * call to pack().
+ *
+ * Networks can also be processed a range at a time, e.g. one chunk of
+ * getChunkSize() networks per thread. Ranges do not share memory that
+ * they write into, so different ranges can be processed in parallel.
+ *
+ * \author terratenff
+ */
+class BatchEngine
+{
+public:
+
+    /*!
+     * \brief Constructor for an empty batch engine.
+     */
+    BatchEngine();
+
+    /*!
+     * \fn pack
+     * \brief Copies the weights and biases of given networks into
+     * the engine. Has to be called again whenever the networks
+     * change (new generation, mutation, bias change).
+     * \param networks Population of Neural Networks.
+     * \pre Every network must have the same structure and activation
+     * functions.
+     */
+    void pack(const std::vector<NeuralNetwork*> &networks);
+
+    /*!
+     * \fn setInputs
+     * \brief Sets the inputs of a single network.
+     * \param n Index of the network.
+     * \param inputs Inputs of the network. Extra values are ignored.
+     */
+    void setInputs(unsigned int n, const Row &inputs);
+
+    /*!
+     * \fn run
+     * \brief Processes the inputs of every network into outputs.
+     */
+    void run();
+
+    /*!
+     * \fn run
+     * \brief Processes the inputs of a range of networks into outputs.
+     * Ranges that do not overlap may be processed at the same time,
+     * as long as each thread uses a worker of its own.
+     * \param first Index of the first network of the range.
+     * \param last Index past the last network of the range.
+     * \param worker Number of the thread, below the worker count.
+     */
+    void run(unsigned int first, unsigned int last, unsigned int worker);
+
+    /*!
+     * \fn setWorkerCount
+     * \brief Setter for the number of threads that may process ranges
+     * at the same time. Each one needs buffers of its own in
+     * quantized precision.
+     * \param count Number of workers.
+     */
+    void setWorkerCount(unsigned int count);
+
+    /*!
+     * \fn getChunkSize
+     * \brief Getter for the number of networks whose weights and
+     * neurons fit into a chunk of CHUNK_BYTES. Depends only on the
+     * structure and precision of the networks.
+     * \return Number of networks, at least 1.
+     */
+    unsigned int getChunkSize() const;
+
+    /*!
+     * \var CHUNK_BYTES
+     * \brief Memory that a chunk of networks should fit into, so that
+     * the chunk stays in the cache of a core while it is processed.
+     */
+    static constexpr size_t CHUNK_BYTES = 64 * 1024;
+
+    /*!
+     * \fn getOutputs
+     * \brief Getter for the outputs of a single network.
+     * \param n Index of the network.
+     * \return Pointer to the outputs, valid until next call to pack().
+     */
+    const double *getOutputs(unsigned int n) const;
+
+    /*!
+     * \fn getOutputCount
+     * \brief Getter for the size of the output layer.
+     * \return Number of outputs of each network.
+     */
+    unsigned int getOutputCount() const;
+
+    /*!
+     * \fn getPopulation
+     * \brief Getter for the number of packed networks.
+     * \return Population size.
+     */
+    unsigned int getPopulation() const;
+
+    /*!
+     * \fn getPrecision
+     * \brief Getter for the precision of the packed networks.
+     * \return Precision type.
+     */
+    precision_type getPrecision() const;
+private:
+
+    /*!
+     * \fn packWeights
+     * \brief Copies the weight blocks of each network into the
+     * weight buffer of given precision.
+     * \param networks Population of Neural Networks.
+     * \param target Weight buffer.
+     */
+    template <typename T>
+    void packWeights(const std::vector<NeuralNetwork*> &networks,
+                     AlignedVector<T> &target);
+
+    /*!
+     * \fn runLayers
+     * \brief Processes every layer of a range of networks in given
+     * precision.
+     * \param first Index of the first network of the range.
+     * \param last Index past the last network of the range.
+     * \param worker Number of the thread, for its buffers.
+     * \param weights Packed weights.
+     * \param neurons Packed neurons.
+     * \param hidden Activation kernel for the hidden layers.
+     * \param output Activation kernel for the output layer.
+     */
+    template <typename T>
+    void runLayers(unsigned int first,
+                   unsigned int last,
+                   unsigned int worker,
+                   const T *weights,
+                   T *neurons,
+                   layer_activation<T> hidden,
+                   layer_activation<T> output);
+
+    /*!
+     * \fn isMemoized
+     * \brief Checks whether the outputs of a network can be looked up
+     * instead of computed.
+     * \param n Index of the network.
+     * \return true, if the inputs of the network are all zero and its
+     * outputs for them are known.
+     */
+    bool isMemoized(unsigned int n) const;
+
+    /*!
+     * \fn memoizeOutputs
+     * \brief Looks up the outputs of the networks of a range whose
+     * inputs are all zero, or remembers them if they were computed
+     * for the first time.
+     * \param first Index of the first network of the range.
+     * \param last Index past the last network of the range.
+     */
+    void memoizeOutputs(unsigned int first, unsigned int last);
+
+    /*!
+     * \fn outputRow
+     * \brief Getter for the writable outputs of a single network.
+     * \param n Index of the network.
+     * \return Pointer to the outputs.
+     */
+    double *outputRow(unsigned int n);
+
+    /*!
+     * \fn activateLayer
+     * \brief Applies an activation kernel to a layer of a range of
+     * networks, leaving out the memoized ones.
+     * \param activate Activation kernel.
+     * \param neurons Packed neurons of the layer.
+     * \param first Index of the first network of the range.
+     * \param last Index past the last network of the range.
+     * \param rows Number of neurons in the layer.
+     * \param width Space taken by the neurons of a single network.
+     */
+    template <typename T>
+    void activateLayer(layer_activation<T> activate,
+                       T *neurons,
+                       unsigned int first,
+                       unsigned int last,
+                       unsigned int rows,
+                       unsigned int width);
+
+    /*!
+     * \fn runTables
+     * \brief Looks up the outputs of a range of networks from their
+     * response tables.
+     * \param first Index of the first network of the range.
+     * \param last Index past the last network of the range.
+     */
+    void runTables(unsigned int first, unsigned int last);
+
+    /*!
+     * \fn runQuantized
+     * \brief Processes every layer of a range of networks with the
+     * 8-bit weights.
+     * \param first Index of the first network of the range.
+     * \param last Index past the last network of the range.
+     * \param worker Number of the thread, for its buffers.
+     */
+    void runQuantized(unsigned int first,
+                      unsigned int last,
+                      unsigned int worker);
+
+    /*!
+     * \var population_
+     * \brief Number of packed networks.
+     */
+    unsigned int population_;
+
+    /*!
+     * \var precision_
+     * \brief Precision of the packed networks.
+     */
+    precision_type precision_;
+
+    /*!
+     * \var layers_
+     * \brief Shared structure of the packed networks.
+     */
+    std::vector<unsigned int> layers_;
+
+    /*!
+     * \var strides_
+     * \brief Padded row length of each weight block.
+     */
+    std::vector<unsigned int> strides_;
+
+    /*!
+     * \var block_sizes_
+     * \brief Size of each weight block of a single network, biases
+     * and padding included.
+     */
+    std::vector<size_t> block_sizes_;
+
+    /*!
+     * \var weight_offsets_
+     * \brief Position of the first weight block of each layer
+     * within the weight buffer.
+     */
+    std::vector<size_t> weight_offsets_;
+
+    /*!
+     * \var neuron_widths_
+     * \brief Space taken by the neurons of a single network on each
+     * layer, padding included.
+     */
+    std::vector<unsigned int> neuron_widths_;
+
+    /*!
+     * \var neuron_offsets_
+     * \brief Position of the first neuron of each layer within the
+     * neuron buffer.
+     */
+    std::vector<size_t> neuron_offsets_;
+
+    /*!
+     * \var weights_
+     * \brief Weights of every network, grouped by layer.
+     */
+    AlignedRow weights_;
+
+    /*!
+     * \var neurons_
+     * \brief Neurons of every network, grouped by layer.
+     */
+    Row neurons_;
+
+    /*!
+     * \var float_weights_
+     * \brief Weights of every network in single precision mode.
+     */
+    AlignedVector<float> float_weights_;
+
+    /*!
+     * \var float_neurons_
+     * \brief Neurons of every network in single precision mode.
+     */
+    std::vector<float> float_neurons_;
+
+    /*!
+     * \var quantized_weights_
+     * \brief Weights of every network in quantized precision mode.
+     */
+    AlignedVector<int8_t> quantized_weights_;
+
+    /*!
+     * \var quantized_biases_
+     * \brief Biases of every network in quantized precision mode,
+     * grouped by layer like the neurons.
+     */
+    std::vector<float> quantized_biases_;
+
+    /*!
+     * \var weight_scales_
+     * \brief Scale of each weight block, grouped by layer like the
+     * weights.
+     */
+    std::vector<float> weight_scales_;
+
+    /*!
+     * \var quantized_inputs_
+     * \brief Quantized neurons of the layer that is being processed,
+     * one buffer of widest_stride_ per worker.
+     */
+    std::vector<int8_t> quantized_inputs_;
+
+    /*!
+     * \var accumulators_
+     * \brief Integer sums of the layer that is being processed, one
+     * buffer of widest_ per worker.
+     */
+    std::vector<int32_t> accumulators_;
+
+    /*!
+     * \var workers_
+     * \brief Number of threads that may process ranges at once.
+     */
+    unsigned int workers_;
+
+    /*!
+     * \var widest_
+     * \brief Size of the widest layer.
+     */
+    unsigned int widest_;
+
+    /*!
+     * \var widest_stride_
+     * \brief Length of the longest padded row.
+     */
+    unsigned int widest_stride_;
+
+    /*!
+     * \var chunk_size_
+     * \brief Number of networks that fit into CHUNK_BYTES.
+     */
+    unsigned int chunk_size_;
+
+    /*!
+     * \var outputs_
+     * \brief Outputs of every network, converted to double precision
+     * in single precision mode.
+     */
+    Row outputs_;
+
+    /*!
+     * \var sparse_weights_
+     * \brief Sparse copy of the weights of each network, or empty if
+     * no network has a sparse weight block. Valid until next call to
+     * pack(), like the networks themselves.
+     */
+    std::vector<const SparseWeightSet*> sparse_weights_;
+
+    /*!
+     * \var binary_
+     * \brief Whether the packed networks use the bit-packed kernels
+     * for every layer that receives hidden neurons.
+     */
+    bool binary_;
+
+    /*!
+     * \var binary_words_
+     * \brief Words per row of each binarized weight block.
+     */
+    std::vector<unsigned int> binary_words_;
+
+    /*!
+     * \var mask_offsets_
+     * \brief Position of the first binarized block of each layer
+     * within the weight masks.
+     */
+    std::vector<size_t> mask_offsets_;
+
+    /*!
+     * \var scale_offsets_
+     * \brief Position of the first row scale of each layer within
+     * binary_scales_.
+     */
+    std::vector<size_t> scale_offsets_;
+
+    /*!
+     * \var positive_masks_
+     * \brief Masks of the positive binarized weights of every
+     * network, grouped by layer like the weights.
+     */
+    std::vector<uint64_t> positive_masks_;
+
+    /*!
+     * \var negative_masks_
+     * \brief Masks of the negative binarized weights of every
+     * network, grouped by layer like the weights.
+     */
+    std::vector<uint64_t> negative_masks_;
+
+    /*!
+     * \var binary_scales_
+     * \brief Row scales of the binarized weights of every network,
+     * grouped by layer like the weights.
+     */
+    Row binary_scales_;
+
+    /*!
+     * \var sign_masks_
+     * \brief Masks of the positive and the negative neurons of the
+     * layer that is being processed, two buffers of
+     * binary_words(widest_) per worker.
+     */
+    std::vector<uint64_t> sign_masks_;
+
+    /*!
+     * \var memoize_
+     * \brief Whether the outputs for inputs that are all zero are
+     * remembered.
+     */
+    bool memoize_;
+
+    /*!
+     * \var zero_inputs_
+     * \brief Whether the latest inputs of each network are all zero.
+     */
+    std::vector<char> zero_inputs_;
+
+    /*!
+     * \var zero_ready_
+     * \brief Whether the outputs of each network for inputs that are
+     * all zero are known.
+     */
+    std::vector<char> zero_ready_;
+
+    /*!
+     * \var zero_outputs_
+     * \brief Outputs of each network for inputs that are all zero.
+     */
+    Row zero_outputs_;
+
+    /*!
+     * \var tables_
+     * \brief Response table of each network, or empty if some
+     * network does not have one.
+     */
+    std::vector<const ResponseTable*> tables_;
+
+    /*!
+     * \var hidden_activation_
+     * \brief Activation kernel for the hidden layers.
+     */
+    activation_function hidden_activation_;
+
+    /*!
+     * \var output_activation_
+     * \brief Activation kernel for the output layer.
+     */
+    activation_function output_activation_;
+
+    /*!
+     * \var float_hidden_activation_
+     * \brief Single precision activation kernel for the hidden layers.
+     */
+    activation_function_float float_hidden_activation_;
+
+    /*!
+     * \var float_output_activation_
+     * \brief Single precision activation kernel for the output layer.
+     */
+    activation_function_float float_output_activation_;
+};
+
+#endif // BATCHENGINE_HH
@@ -0,0 +1,169 @@
+#include "binary.hh"
+#include "layerkernel.hh"
+#include <cmath>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define BINARY_X86
+#endif
+
+namespace
+{
+    int popcount(uint64_t bits)
+    {
+        return __builtin_popcountll(bits);
+    }
+
+    template <int (*Count)(uint64_t)>
+    void binary_rows(const uint64_t *positive,
+                     const uint64_t *negative,
+                     const double *scales,
+                     unsigned int rows,
+                     unsigned int words,
+                     const uint64_t *inputPositive,
+                     const uint64_t *inputNegative,
+                     const double *bias,
+                     double *output)
+    {
+        for (unsigned int j = 0; j < rows; j++) {
+            size_t start = static_cast<size_t>(j) * words;
+            const uint64_t *rowPositive = positive + start;
+            const uint64_t *rowNegative = negative + start;
+            int sum = 0;
+            for (unsigned int w = 0; w < words; w++) {
+                sum += Count(inputPositive[w] & rowPositive[w]);
+                sum -= Count(inputPositive[w] & rowNegative[w]);
+                sum -= Count(inputNegative[w] & rowPositive[w]);
+                sum += Count(inputNegative[w] & rowNegative[w]);
+            }
+            output[j] = bias[j] + scales[j] * sum;
+        }
+    }
+
+#ifdef BINARY_X86
+    // Every CPU with AVX2 has the popcnt instruction as well.
+    __attribute__((target("popcnt")))
+    int popcount_native(uint64_t bits)
+    {
+        return __builtin_popcountll(bits);
+    }
+
+    __attribute__((target("popcnt")))
+    void binary_rows_native(const uint64_t *positive,
+                            const uint64_t *negative,
+                            const double *scales,
+                            unsigned int rows,
+                            unsigned int words,
+                            const uint64_t *inputPositive,
+                            const uint64_t *inputNegative,
+                            const double *bias,
+                            double *output)
+    {
+        binary_rows<popcount_native>(positive, negative, scales, rows, words,
+                                     inputPositive, inputNegative, bias,
+                                     output);
+    }
+#endif
+}
+
+unsigned int binary_words(unsigned int count)
+{
+    return (count + BINARY_WORD_BITS - 1) / BINARY_WORD_BITS;
+}
+
+void pack_signs(const double *values,
+                unsigned int count,
+                uint64_t *positive,
+                uint64_t *negative)
+{
+    unsigned int words = binary_words(count);
+    for (unsigned int w = 0; w < words; w++) {
+        positive[w] = 0;
+        negative[w] = 0;
+    }
+    for (unsigned int k = 0; k < count; k++) {
+        uint64_t bit = uint64_t(1) << (k % BINARY_WORD_BITS);
+        if (values[k] > 0) positive[k / BINARY_WORD_BITS] |= bit;
+        else if (values[k] < 0) negative[k / BINARY_WORD_BITS] |= bit;
+    }
+}
+
+void binary_layer(const uint64_t *positive,
+                  const uint64_t *negative,
+                  const double *scales,
+                  unsigned int rows,
+                  unsigned int words,
+                  const uint64_t *inputPositive,
+                  const uint64_t *inputNegative,
+                  const double *bias,
+                  double *output)
+{
+#ifdef BINARY_X86
+    if (get_kernel() == KERNEL_AVX2) {
+        binary_rows_native(positive, negative, scales, rows, words,
+                           inputPositive, inputNegative, bias, output);
+        return;
+    }
+#endif
+    binary_rows<popcount>(positive, negative, scales, rows, words,
+                          inputPositive, inputNegative, bias, output);
+}
+
+BinaryWeightSet::BinaryWeightSet()
+{
+}
+
+void BinaryWeightSet::binarize(const WeightSet &weights)
+{
+    unsigned int layerCount = weights.layerCount();
+    words_.resize(layerCount);
+    positive_.resize(layerCount);
+    negative_.resize(layerCount);
+    scales_.resize(layerCount);
+
+    for (unsigned int i = 0; i < layerCount; i++) {
+        unsigned int rows = weights.rows(i);
+        unsigned int columns = weights.columns(i);
+        unsigned int words = binary_words(columns);
+        words_[i] = words;
+        positive_[i].assign(static_cast<size_t>(rows) * words, 0);
+        negative_[i].assign(static_cast<size_t>(rows) * words, 0);
+        scales_[i].assign(rows, 0);
+
+        for (unsigned int j = 0; j < rows; j++) {
+            const double *row = weights.row(i, j);
+            size_t start = static_cast<size_t>(j) * words;
+            uint64_t *rowPositive = positive_[i].data() + start;
+            uint64_t *rowNegative = negative_[i].data() + start;
+            pack_signs(row, columns, rowPositive, rowNegative);
+
+            double magnitude = 0;
+            unsigned int nonzero = 0;
+            for (unsigned int k = 0; k < columns; k++) {
+                if (row[k] == 0) continue;
+                magnitude += std::fabs(row[k]);
+                nonzero++;
+            }
+            scales_[i][j] = nonzero == 0 ? 0 : magnitude / nonzero;
+        }
+    }
+}
+
+unsigned int BinaryWeightSet::words(unsigned int layer) const
+{
+    return words_[layer];
+}
+
+const uint64_t *BinaryWeightSet::positive(unsigned int layer) const
+{
+    return positive_[layer].data();
+}
+
+const uint64_t *BinaryWeightSet::negative(unsigned int layer) const
+{
+    return negative_[layer].data();
+}
+
+const double *BinaryWeightSet::scales(unsigned int layer) const
+{
+    return scales_[layer].data();
+}
@@ -0,0 +1,161 @@
+#ifndef BINARY_HH
+#define BINARY_HH
+
+#include "weightset.hh"
+
+/*!
+ * \file binary.hh
+ * \brief Bit-packed kernels for layers whose inputs are the outputs
+ * of activation function SIGN (-1, 0 or 1) or HEAVISIDE (0 or 1).
+ *
+ * Inputs are packed into two bit masks, one for the positive and one
+ * for the negative values. Weights are binarized: every weight of a
+ * row is replaced with its sign times the mean magnitude of the
+ * nonzero weights of that row, and the signs are packed into bit
+ * masks likewise. A dot product then takes four AND/popcount
+ * operations per 64 inputs:
+ *
+ *   sum = scale * (|P & W+| - |P & W-| - |N & W+| + |N & W-|)
+ *
+ * where P and N are the input masks and W+ and W- the weight masks.
+ * The result is exact whenever the nonzero weights of each row share
+ * the same magnitude.
+ * \author terratenff
+ */
+
+/*!
+ * \var BINARY_WORD_BITS
+ * \brief Number of neurons or weights packed into one word.
+ */
+const unsigned int BINARY_WORD_BITS = 64;
+
+/*!
+ * \fn binary_words
+ * \brief Calculates the number of words needed for a bit mask.
+ * \param count Number of bits.
+ * \return Number of words.
+ */
+unsigned int binary_words(unsigned int count);
+
+/*!
+ * \fn pack_signs
+ * \brief Packs the signs of values into bit masks. Unused bits of the
+ * last word are cleared.
+ * \param values Source values.
+ * \param count Number of values.
+ * \param positive Bit k is set if value k is positive. At least
+ * binary_words(count) words.
+ * \param negative Bit k is set if value k is negative. At least
+ * binary_words(count) words.
+ */
+void pack_signs(const double *values,
+                unsigned int count,
+                uint64_t *positive,
+                uint64_t *negative);
+
+/*!
+ * \fn binary_layer
+ * \brief Computes output[j] = bias[j] + scales[j] * sum(sign(w[j][k]) *
+ * sign(input[k])) for every row j of a binarized weight block.
+ * \param positive Masks of the positive weights, row by row.
+ * \param negative Masks of the negative weights, row by row.
+ * \param scales Scale of each row.
+ * \param rows Number of rows (output neurons).
+ * \param words Number of words per row.
+ * \param inputPositive Mask of the positive inputs.
+ * \param inputNegative Mask of the negative inputs.
+ * \param bias Bias of each output neuron, at least "rows" of them.
+ * \param output Output neurons, at least "rows" of them.
+ */
+void binary_layer(const uint64_t *positive,
+                  const uint64_t *negative,
+                  const double *scales,
+                  unsigned int rows,
+                  unsigned int words,
+                  const uint64_t *inputPositive,
+                  const uint64_t *inputNegative,
+                  const double *bias,
+                  double *output);
+
+/*!
+ * \class BinaryWeightSet
+ * \brief Binarized copy of the weight blocks of a weight set.
+ * \author terratenff
+ */
+class BinaryWeightSet
+{
+public:
+
+    /*!
+     * \brief Constructor for an empty binary weight set.
+     */
+    BinaryWeightSet();
+
+    /*!
+     * \fn binarize
+     * \brief Replaces the contents with binarized copies of the
+     * weight blocks. Storage is reused, so memory is allocated only
+     * when the layout changes.
+     * \param weights Source weights.
+     */
+    void binarize(const WeightSet &weights);
+
+    /*!
+     * \fn words
+     * \brief Getter for the number of words per row of a block.
+     * \param layer Target weight block.
+     * \return Words per row.
+     */
+    unsigned int words(unsigned int layer) const;
+
+    /*!
+     * \fn positive
+     * \brief Getter for the masks of the positive weights of a block.
+     * \param layer Target weight block.
+     * \return Masks, row by row.
+     */
+    const uint64_t *positive(unsigned int layer) const;
+
+    /*!
+     * \fn negative
+     * \brief Getter for the masks of the negative weights of a block.
+     * \param layer Target weight block.
+     * \return Masks, row by row.
+     */
+    const uint64_t *negative(unsigned int layer) const;
+
+    /*!
+     * \fn scales
+     * \brief Getter for the row scales of a block.
+     * \param layer Target weight block.
+     * \return Mean magnitude of the nonzero weights of each row.
+     */
+    const double *scales(unsigned int layer) const;
+private:
+
+    /*!
+     * \var words_
+     * \brief Words per row of each weight block.
+     */
+    vector<unsigned int> words_;
+
+    /*!
+     * \var positive_
+     * \brief Masks of the positive weights of each weight block.
+     */
+    vector<vector<uint64_t> > positive_;
+
+    /*!
+     * \var negative_
+     * \brief Masks of the negative weights of each weight block.
+     */
+    vector<vector<uint64_t> > negative_;
+
+    /*!
+     * \var scales_
+     * \brief Row scales of each weight block.
+     */
+    vector<vector<double> > scales_;
+};
+
+#endif // BINARY_HH
@@ -0,0 +1,350 @@
+#include "crossover.hh"
+#include "layerkernel.hh"
+#include <algorithm>
+#include <cstdint>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define CROSSOVER_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    // A random byte below THIRD picks the first of three parents,
+    // below TWO_THIRDS the second and otherwise the third. The split
+    // is 85 / 85 / 86, which is as close to even as a byte allows.
+    const unsigned int THIRD = 85;
+    const unsigned int TWO_THIRDS = 170;
+
+    // Weights chosen by one 64-bit draw.
+    const unsigned int TWO_PARENT_CHUNK = 64;
+    const unsigned int THREE_PARENT_CHUNK = 8;
+
+    typedef void (*two_parent_blend)(const double *,
+                                     const double *,
+                                     double *,
+                                     unsigned int,
+                                     uint64_t);
+
+    typedef void (*three_parent_blend)(const double *,
+                                       const double *,
+                                       const double *,
+                                       double *,
+                                       unsigned int,
+                                       uint64_t);
+
+    void blend_two_scalar(const double *weights1,
+                          const double *weights2,
+                          double *target,
+                          unsigned int count,
+                          uint64_t bits)
+    {
+        for (unsigned int k = 0; k < count; k++) {
+            target[k] = ((bits >> k) & 1) ? weights2[k] : weights1[k];
+        }
+    }
+
+    void blend_three_scalar(const double *weights1,
+                            const double *weights2,
+                            const double *weights3,
+                            double *target,
+                            unsigned int count,
+                            uint64_t bits)
+    {
+        for (unsigned int k = 0; k < count; k++) {
+            unsigned int selector = (bits >> (8 * k)) & 255;
+            double weight = selector < TWO_THIRDS ? weights2[k] : weights3[k];
+            target[k] = selector < THIRD ? weights1[k] : weight;
+        }
+    }
+
+#ifdef CROSSOVER_X86
+    // Lane masks for every combination of four selection bits.
+    alignas(32) const int64_t BLEND_MASKS[16][4] = {
+        { 0,  0,  0,  0},
+        {-1,  0,  0,  0},
+        { 0, -1,  0,  0},
+        {-1, -1,  0,  0},
+        { 0,  0, -1,  0},
+        {-1,  0, -1,  0},
+        { 0, -1, -1,  0},
+        {-1, -1, -1,  0},
+        { 0,  0,  0, -1},
+        {-1,  0,  0, -1},
+        { 0, -1,  0, -1},
+        {-1, -1,  0, -1},
+        { 0,  0, -1, -1},
+        {-1,  0, -1, -1},
+        { 0, -1, -1, -1},
+        {-1, -1, -1, -1}
+    };
+
+    __attribute__((target("avx2")))
+    void blend_two_avx2(const double *weights1,
+                        const double *weights2,
+                        double *target,
+                        unsigned int count,
+                        uint64_t bits)
+    {
+        unsigned int vectorCount = count & ~3u;
+        unsigned int k = 0;
+        for (; k < vectorCount; k += 4) {
+            __m256d mask = _mm256_castsi256_pd(_mm256_load_si256(
+                        reinterpret_cast<const __m256i*>(
+                            BLEND_MASKS[(bits >> k) & 15])));
+            __m256d w1 = _mm256_loadu_pd(weights1 + k);
+            __m256d w2 = _mm256_loadu_pd(weights2 + k);
+            _mm256_storeu_pd(target + k, _mm256_blendv_pd(w1, w2, mask));
+        }
+        if (k == count) return;
+        blend_two_scalar(weights1 + k, weights2 + k, target + k,
+                         count - k, bits >> k);
+    }
+
+    __attribute__((target("avx2")))
+    void blend_three_avx2(const double *weights1,
+                          const double *weights2,
+                          const double *weights3,
+                          double *target,
+                          unsigned int count,
+                          uint64_t bits)
+    {
+        const __m256i firstLimit = _mm256_set1_epi64x(THIRD - 1);
+        const __m256i secondLimit = _mm256_set1_epi64x(TWO_THIRDS - 1);
+
+        unsigned int vectorCount = count & ~3u;
+        unsigned int k = 0;
+        for (; k < vectorCount; k += 4) {
+            int selectors = static_cast<int>((bits >> (8 * k)) & 0xFFFFFFFF);
+            __m256i bytes = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(selectors));
+            __m256d notFirst = _mm256_castsi256_pd(
+                        _mm256_cmpgt_epi64(bytes, firstLimit));
+            __m256d isThird = _mm256_castsi256_pd(
+                        _mm256_cmpgt_epi64(bytes, secondLimit));
+            __m256d w1 = _mm256_loadu_pd(weights1 + k);
+            __m256d w2 = _mm256_loadu_pd(weights2 + k);
+            __m256d w3 = _mm256_loadu_pd(weights3 + k);
+            __m256d blend = _mm256_blendv_pd(w1, w2, notFirst);
+            _mm256_storeu_pd(target + k, _mm256_blendv_pd(blend, w3, isThird));
+        }
+        if (k == count) return;
+        blend_three_scalar(weights1 + k, weights2 + k, weights3 + k,
+                           target + k, count - k, bits >> (8 * k));
+    }
+#endif
+
+    two_parent_blend two_parent_kernel()
+    {
+#ifdef CROSSOVER_X86
+        if (get_kernel() == KERNEL_AVX2) return blend_two_avx2;
+#endif
+        return blend_two_scalar;
+    }
+
+    three_parent_blend three_parent_kernel()
+    {
+#ifdef CROSSOVER_X86
+        if (get_kernel() == KERNEL_AVX2) return blend_three_avx2;
+#endif
+        return blend_three_scalar;
+    }
+
+    // Padding is zero in every parent, so whole groups, padding
+    // included, can be blended.
+    void uniform_crossover(const WeightSet &weights1,
+                           const WeightSet &weights2,
+                           WeightSet &target,
+                           Random &rand)
+    {
+        two_parent_blend blend = two_parent_kernel();
+        for (unsigned int i = 0; i < target.layerCount(); i++) {
+            for (unsigned int g = 0; g < target.groupCount(i); g++) {
+                const double *group1 = weights1.group(i, g);
+                const double *group2 = weights2.group(i, g);
+                double *group = target.mutableGroup(i, g, false);
+                size_t size = target.groupSize(i, g);
+                for (size_t n = 0; n < size; n += TWO_PARENT_CHUNK) {
+                    unsigned int count = static_cast<unsigned int>(
+                                std::min<size_t>(TWO_PARENT_CHUNK, size - n));
+                    blend(group1 + n, group2 + n, group + n,
+                          count, rand.random_bits());
+                }
+            }
+        }
+    }
+
+    void uniform_crossover(const WeightSet &weights1,
+                           const WeightSet &weights2,
+                           const WeightSet &weights3,
+                           WeightSet &target,
+                           Random &rand)
+    {
+        three_parent_blend blend = three_parent_kernel();
+        for (unsigned int i = 0; i < target.layerCount(); i++) {
+            for (unsigned int g = 0; g < target.groupCount(i); g++) {
+                const double *group1 = weights1.group(i, g);
+                const double *group2 = weights2.group(i, g);
+                const double *group3 = weights3.group(i, g);
+                double *group = target.mutableGroup(i, g, false);
+                size_t size = target.groupSize(i, g);
+                for (size_t n = 0; n < size; n += THREE_PARENT_CHUNK) {
+                    unsigned int count = static_cast<unsigned int>(
+                                std::min<size_t>(THREE_PARENT_CHUNK,
+                                                 size - n));
+                    blend(group1 + n, group2 + n, group3 + n, group + n,
+                          count, rand.random_bits());
+                }
+            }
+        }
+    }
+
+    // Number of weights and biases in a block, padding excluded.
+    size_t gene_count(const WeightSet &weights, unsigned int i)
+    {
+        return static_cast<size_t>(weights.rows(i)) * weights.columns(i)
+                + weights.rows(i);
+    }
+
+    // Picks a random crossover point among the actual weights and
+    // biases (not the padding) and returns its position as if all
+    // blocks were stored back to back.
+    size_t random_point(const WeightSet &weights, Random &rand)
+    {
+        size_t total = 0;
+        for (unsigned int i = 0; i < weights.layerCount(); i++) {
+            total += gene_count(weights, i);
+        }
+        if (total == 0) return 0;
+
+        size_t index = static_cast<size_t>(
+                    rand.random_int(0, static_cast<int>(total) + 1));
+        size_t offset = 0;
+        for (unsigned int i = 0; i < weights.layerCount(); i++) {
+            size_t weightCount =
+                    static_cast<size_t>(weights.rows(i)) * weights.columns(i);
+            if (index < weightCount) {
+                size_t row = index / weights.columns(i);
+                size_t column = index % weights.columns(i);
+                return offset + row * weights.stride(i) + column;
+            }
+            if (index < gene_count(weights, i)) {
+                size_t biases =
+                        static_cast<size_t>(weights.rows(i)) * weights.stride(i);
+                return offset + biases + (index - weightCount);
+            }
+            index -= gene_count(weights, i);
+            offset += weights.blockSize(i);
+        }
+        return weights.size();
+    }
+
+    // Copies a range of positions from source to target. Groups that
+    // fall entirely within the range are shared instead of copied.
+    // The ranges given to the target must cover all of it.
+    void copy_range(const WeightSet &source,
+                    WeightSet &target,
+                    size_t begin,
+                    size_t end)
+    {
+        size_t offset = 0;
+        for (unsigned int i = 0; i < target.layerCount() && offset < end; i++) {
+            for (unsigned int g = 0; g < target.groupCount(i); g++) {
+                size_t size = target.groupSize(i, g);
+                size_t first = std::max(begin, offset);
+                size_t last = std::min(end, offset + size);
+                if (first < last) {
+                    if (first == offset && last == offset + size) {
+                        target.shareGroup(i, g, source);
+                    } else {
+                        std::copy(source.group(i, g) + (first - offset),
+                                  source.group(i, g) + (last - offset),
+                                  target.mutableGroup(i, g, false)
+                                  + (first - offset));
+                    }
+                }
+                offset += size;
+            }
+        }
+    }
+
+    void single_point_crossover(const WeightSet &weights1,
+                                const WeightSet &weights2,
+                                WeightSet &target,
+                                Random &rand)
+    {
+        size_t point = random_point(target, rand);
+        copy_range(weights1, target, 0, point);
+        copy_range(weights2, target, point, target.size());
+    }
+
+    void single_point_crossover(const WeightSet &weights1,
+                                const WeightSet &weights2,
+                                const WeightSet &weights3,
+                                WeightSet &target,
+                                Random &rand)
+    {
+        size_t point1 = random_point(target, rand);
+        size_t point2 = random_point(target, rand);
+        if (point2 < point1) std::swap(point1, point2);
+        copy_range(weights1, target, 0, point1);
+        copy_range(weights2, target, point1, point2);
+        copy_range(weights3, target, point2, target.size());
+    }
+
+    // Every block is shared with the chosen parent.
+    void layer_crossover(const WeightSet *const *parents,
+                         int parentCount,
+                         WeightSet &target,
+                         Random &rand)
+    {
+        for (unsigned int i = 0; i < target.layerCount(); i++) {
+            const WeightSet &source = *parents[rand.random_int(0, parentCount)];
+            target.shareBlock(i, source);
+        }
+    }
+}
+
+void crossover(crossover_type type,
+               const WeightSet &weights1,
+               const WeightSet &weights2,
+               WeightSet &target,
+               Random &rand)
+{
+    switch(type) {
+    case SINGLE_POINT_CROSSOVER:
+        single_point_crossover(weights1, weights2, target, rand);
+        break;
+    case LAYER_CROSSOVER:
+    {
+        const WeightSet *parents[] = {&weights1, &weights2};
+        layer_crossover(parents, 2, target, rand);
+        break;
+    }
+    default:
+        uniform_crossover(weights1, weights2, target, rand);
+        break;
+    }
+}
+
+void crossover(crossover_type type,
+               const WeightSet &weights1,
+               const WeightSet &weights2,
+               const WeightSet &weights3,
+               WeightSet &target,
+               Random &rand)
+{
+    switch(type) {
+    case SINGLE_POINT_CROSSOVER:
+        single_point_crossover(weights1, weights2, weights3, target, rand);
+        break;
+    case LAYER_CROSSOVER:
+    {
+        const WeightSet *parents[] = {&weights1, &weights2, &weights3};
+        layer_crossover(parents, 3, target, rand);
+        break;
+    }
+    default:
+        uniform_crossover(weights1, weights2, weights3, target, rand);
+        break;
+    }
+}
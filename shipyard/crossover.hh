@@ -0,0 +1,55 @@
+#ifndef CROSSOVER_HH
+#define CROSSOVER_HH
+
+#include "settings.hh"
+#include "weightset.hh"
+
+/*!
+ * \file crossover.hh
+ * \brief Crossover functions that combine the weights of two or three
+ * parents into a child. Biases are treated like any other weight.
+ *
+ * Random decisions are made in bulk: a single 64-bit draw selects
+ * the parent of 64 weights (two parents) or 8 weights (three
+ * parents). The selections are applied over the flat weight buffer
+ * with blends instead of branches, using AVX2 whenever it is the
+ * dense layer kernel in use (see layerkernel.hh). Groups of weights
+ * that come entirely from one parent are shared with it instead of
+ * copied (see weightset.hh). Parents and child must share the same
+ * layout.
+ * \author terratenff
+ */
+
+/*!
+ * \fn crossover
+ * \brief Combines the weights of two parents into a child.
+ * \param type Crossover method.
+ * \param weights1 Weights of the first parent.
+ * \param weights2 Weights of the second parent.
+ * \param target Weights of the child.
+ * \param rand Random number generator.
+ */
+void crossover(crossover_type type,
+               const WeightSet &weights1,
+               const WeightSet &weights2,
+               WeightSet &target,
+               Random &rand);
+
+/*!
+ * \fn crossover
+ * \brief Combines the weights of three parents into a child.
+ * \param type Crossover method.
+ * \param weights1 Weights of the first parent.
+ * \param weights2 Weights of the second parent.
+ * \param weights3 Weights of the third parent.
+ * \param target Weights of the child.
+ * \param rand Random number generator.
+ */
+void crossover(crossover_type type,
+               const WeightSet &weights1,
+               const WeightSet &weights2,
+               const WeightSet &weights3,
+               WeightSet &target,
+               Random &rand);
+
+#endif // CROSSOVER_HH
@@ -0,0 +1,158 @@
+#include "encoding.hh"
+#include "subjectcore.hh"
+
+void InputEncoder<NO_INPUT>::encode(SubjectCore &subject,
+                                    SubjectCore &target,
+                                    double *inputs)
+{
+    Input::angular_difference(subject.getAngle(),
+                              subject.getCoordinates(),
+                              target.getCoordinates(),
+                              inputs);
+}
+
+void InputEncoder<ANGULAR_DIFFERENCE>::encode(SubjectCore &subject,
+                                              SubjectCore &target,
+                                              double *inputs)
+{
+    Input::angular_difference(subject.getAngle(),
+                              subject.getCoordinates(),
+                              target.getCoordinates(),
+                              inputs);
+}
+
+void InputEncoder<SPACE_TOTAL_DIFFERENCE>::encode(SubjectCore &subject,
+                                                  SubjectCore &target,
+                                                  double *inputs)
+{
+    Input::space_scalar_difference(subject.getCoordinates(),
+                                   target.getCoordinates(),
+                                   inputs);
+}
+
+void InputEncoder<SPACE_AXIS_DIFFERENCE>::encode(SubjectCore &subject,
+                                                 SubjectCore &target,
+                                                 double *inputs)
+{
+    Input::space_axis_difference(subject.getCoordinates(),
+                                 target.getCoordinates(),
+                                 inputs);
+}
+
+void InputEncoder<WALL_DISTANCES>::encode(SubjectCore &subject,
+                                          SubjectCore &,
+                                          double *inputs)
+{
+    Input::wall_distances(subject.getCoordinates(), inputs);
+}
+
+void InputEncoder<FOUR_WAY_SEARCH>::encode(SubjectCore &subject,
+                                           SubjectCore &target,
+                                           double *inputs)
+{
+    Input::four_way_search(subject.getCoordinates(),
+                           target.getCoordinates(),
+                           inputs);
+}
+
+void InputEncoder<FOUR_CORNER_SEARCH>::encode(SubjectCore &subject,
+                                              SubjectCore &target,
+                                              double *inputs)
+{
+    Input::four_corner_search(subject.getCoordinates(),
+                              target.getCoordinates(),
+                              inputs);
+}
+
+void OutputDecoder<NO_OUTPUT>::decode(SubjectCore &, const double *)
+{
+}
+
+void OutputDecoder<ANGULAR_VELOCITY>::decode(SubjectCore &subject,
+                                             const double *outputs)
+{
+    double outputValues[ARITY];
+    Output::angular_velocity(outputs,
+                             subject.getAngularVelocityFactor(),
+                             outputValues);
+    subject.setAngularVelocity(outputValues[0]);
+}
+
+void OutputDecoder<DIRECT_ANGLE>::decode(SubjectCore &subject,
+                                         const double *outputs)
+{
+    double outputValues[ARITY];
+    Output::direct_angle(outputs, outputValues);
+    subject.setAngle(outputValues[0]);
+}
+
+void OutputDecoder<ANGLE_VELOCITY>::decode(SubjectCore &subject,
+                                           const double *outputs)
+{
+    double outputValues[ARITY];
+    Output::angle_velocity(outputs,
+                           subject.getAngularVelocityFactor(),
+                           subject.getVelocityFactor(),
+                           outputValues);
+    subject.setAngularVelocity(outputValues[0]);
+    subject.setVelocity(outputValues[1]);
+}
+
+void OutputDecoder<ANGLE_ACCELERATION>::decode(SubjectCore &subject,
+                                               const double *outputs)
+{
+    double outputValues[ARITY];
+    Output::angle_acceleration(outputs,
+                               subject.getAngularVelocityFactor(),
+                               subject.getAccelerationFactor(),
+                               outputValues);
+    subject.setAngularVelocity(outputValues[0]);
+    subject.setAcceleration(outputValues[1]);
+}
+
+void OutputDecoder<AXIS_VELOCITY>::decode(SubjectCore &subject,
+                                          const double *outputs)
+{
+    double outputValues[ARITY];
+    Output::axis_velocity(outputs,
+                          subject.getAxisVelocityFactor(),
+                          outputValues);
+    subject.setAxisVelocity(XY(outputValues[0], outputValues[1]));
+}
+
+void OutputDecoder<AXIS_ACCELERATION>::decode(SubjectCore &subject,
+                                              const double *outputs)
+{
+    double outputValues[ARITY];
+    Output::axis_acceleration(outputs,
+                              subject.getAxisAccelerationFactor(),
+                              outputValues);
+    subject.setAxisAcceleration(XY(outputValues[0], outputValues[1]));
+}
+
+void OutputDecoder<SMALL_HOPS>::decode(SubjectCore &subject,
+                                       const double *outputs)
+{
+    double outputValues[ARITY];
+    Output::small_hops(outputs, outputValues);
+    XY xy = subject.getCoordinates();
+    subject.setCoordinates(XY(xy.x + outputValues[0],
+                              xy.y + outputValues[1]));
+    subject.setAngle(calculate_angle(XY(outputValues[0], outputValues[1])));
+}
+
+void OutputDecoder<FIXED_MOVEMENT>::decode(SubjectCore &subject,
+                                           const double *outputs)
+{
+    double outputValues[ARITY];
+    Output::fixed_movement(outputs, outputValues);
+    double targetAngle = 0;
+    for (double i : outputValues) {
+        if (!near_zero(i)) {
+            subject.setAngle(targetAngle);
+            break;
+        } else {
+            targetAngle += 90;
+        }
+    }
+}
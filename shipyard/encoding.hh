@@ -0,0 +1,359 @@
+#ifndef ENCODING_HH
+#define ENCODING_HH
+
+#include "settings.hh"
+#include "math.hh"
+
+class SubjectCore;
+
+/*!
+ * \struct InputEncoding
+ * \brief Description of an input type: how many inputs it produces,
+ * the range of their values and the function that produces them.
+ * \author terratenff
+ */
+struct InputEncoding {
+
+    /*!
+     * \var type
+     * \brief Input type being described.
+     */
+    input_type type;
+
+    /*!
+     * \var arity
+     * \brief Number of inputs, i.e. the size of the input layer.
+     */
+    unsigned int arity;
+
+    /*!
+     * \var minimum
+     * \brief Smallest value an input can have.
+     */
+    double minimum;
+
+    /*!
+     * \var maximum
+     * \brief Largest value an input can have.
+     */
+    double maximum;
+
+    /*!
+     * \fn encode
+     * \brief Fills in the inputs of the subject in place.
+     * \param subject Subject the inputs are made for.
+     * \param target Primary target of the subject.
+     * \param inputs Inputs, with room for arity of them.
+     */
+    void (*encode)(SubjectCore &subject, SubjectCore &target,
+                   double *inputs);
+};
+
+/*!
+ * \struct OutputEncoding
+ * \brief Description of an output type: how many outputs it reads,
+ * the range of outputs it expects and the function that applies them
+ * to a subject.
+ * \author terratenff
+ */
+struct OutputEncoding {
+
+    /*!
+     * \var type
+     * \brief Output type being described.
+     */
+    output_type type;
+
+    /*!
+     * \var arity
+     * \brief Number of outputs, i.e. the size of the output layer.
+     */
+    unsigned int arity;
+
+    /*!
+     * \var minimum
+     * \brief Lower end of the outputs the type expects.
+     */
+    double minimum;
+
+    /*!
+     * \var maximum
+     * \brief Upper end of the outputs the type expects.
+     */
+    double maximum;
+
+    /*!
+     * \fn decode
+     * \brief Modifies the state of the subject based on the outputs.
+     * \param subject Subject to modify.
+     * \param outputs Outputs, arity of them.
+     */
+    void (*decode)(SubjectCore &subject, const double *outputs);
+};
+
+/*!
+ * \struct InputEncoder
+ * \brief Input function of an input type. Every input type has a
+ * specialization with a fixed ARITY, the value range and encode().
+ * \author terratenff
+ */
+template <input_type T>
+struct InputEncoder;
+
+/*!
+ * \struct OutputDecoder
+ * \brief Output function of an output type. Every output type has a
+ * specialization with a fixed ARITY, the output range and decode().
+ * \author terratenff
+ */
+template <output_type T>
+struct OutputDecoder;
+
+template <>
+struct InputEncoder<NO_INPUT> {
+    static constexpr unsigned int ARITY = 1;
+    static constexpr double MINIMUM = 0.0;
+    static constexpr double MAXIMUM = 1.0;
+    static void encode(SubjectCore &subject, SubjectCore &target,
+                       double *inputs);
+};
+
+template <>
+struct InputEncoder<ANGULAR_DIFFERENCE> {
+    static constexpr unsigned int ARITY = 1;
+    static constexpr double MINIMUM = 0.0;
+    static constexpr double MAXIMUM = 1.0;
+    static void encode(SubjectCore &subject, SubjectCore &target,
+                       double *inputs);
+};
+
+template <>
+struct InputEncoder<SPACE_TOTAL_DIFFERENCE> {
+    static constexpr unsigned int ARITY = 1;
+    static constexpr double MINIMUM = 0.0;
+    static constexpr double MAXIMUM = 1.0;
+    static void encode(SubjectCore &subject, SubjectCore &target,
+                       double *inputs);
+};
+
+template <>
+struct InputEncoder<SPACE_AXIS_DIFFERENCE> {
+    static constexpr unsigned int ARITY = 2;
+    static constexpr double MINIMUM = -1.0;
+    static constexpr double MAXIMUM = 1.0;
+    static void encode(SubjectCore &subject, SubjectCore &target,
+                       double *inputs);
+};
+
+template <>
+struct InputEncoder<WALL_DISTANCES> {
+    static constexpr unsigned int ARITY = 4;
+    static constexpr double MINIMUM = 0.0;
+    static constexpr double MAXIMUM = 1.0;
+    static void encode(SubjectCore &subject, SubjectCore &target,
+                       double *inputs);
+};
+
+template <>
+struct InputEncoder<FOUR_WAY_SEARCH> {
+    static constexpr unsigned int ARITY = 4;
+    static constexpr double MINIMUM = 0.0;
+    static constexpr double MAXIMUM = 1.0;
+    static void encode(SubjectCore &subject, SubjectCore &target,
+                       double *inputs);
+};
+
+template <>
+struct InputEncoder<FOUR_CORNER_SEARCH> {
+    static constexpr unsigned int ARITY = 4;
+    static constexpr double MINIMUM = 0.0;
+    static constexpr double MAXIMUM = 1.0;
+    static void encode(SubjectCore &subject, SubjectCore &target,
+                       double *inputs);
+};
+
+template <>
+struct OutputDecoder<NO_OUTPUT> {
+    static constexpr unsigned int ARITY = 1;
+    static constexpr double MINIMUM = 0.0;
+    static constexpr double MAXIMUM = 0.0;
+    static void decode(SubjectCore &subject, const double *outputs);
+};
+
+template <>
+struct OutputDecoder<ANGULAR_VELOCITY> {
+    static constexpr unsigned int ARITY = 1;
+    static constexpr double MINIMUM = -1.0;
+    static constexpr double MAXIMUM = 1.0;
+    static void decode(SubjectCore &subject, const double *outputs);
+};
+
+template <>
+struct OutputDecoder<DIRECT_ANGLE> {
+    static constexpr unsigned int ARITY = 1;
+    static constexpr double MINIMUM = 0.0;
+    static constexpr double MAXIMUM = 1.0;
+    static void decode(SubjectCore &subject, const double *outputs);
+};
+
+template <>
+struct OutputDecoder<ANGLE_VELOCITY> {
+    static constexpr unsigned int ARITY = 2;
+    static constexpr double MINIMUM = -1.0;
+    static constexpr double MAXIMUM = 1.0;
+    static void decode(SubjectCore &subject, const double *outputs);
+};
+
+template <>
+struct OutputDecoder<ANGLE_ACCELERATION> {
+    static constexpr unsigned int ARITY = 2;
+    static constexpr double MINIMUM = -1.0;
+    static constexpr double MAXIMUM = 1.0;
+    static void decode(SubjectCore &subject, const double *outputs);
+};
+
+template <>
+struct OutputDecoder<AXIS_VELOCITY> {
+    static constexpr unsigned int ARITY = 2;
+    static constexpr double MINIMUM = -1.0;
+    static constexpr double MAXIMUM = 1.0;
+    static void decode(SubjectCore &subject, const double *outputs);
+};
+
+template <>
+struct OutputDecoder<AXIS_ACCELERATION> {
+    static constexpr unsigned int ARITY = 2;
+    static constexpr double MINIMUM = -1.0;
+    static constexpr double MAXIMUM = 1.0;
+    static void decode(SubjectCore &subject, const double *outputs);
+};
+
+template <>
+struct OutputDecoder<SMALL_HOPS> {
+    static constexpr unsigned int ARITY = 2;
+    static constexpr double MINIMUM = -1.0;
+    static constexpr double MAXIMUM = 1.0;
+    static void decode(SubjectCore &subject, const double *outputs);
+};
+
+template <>
+struct OutputDecoder<FIXED_MOVEMENT> {
+    static constexpr unsigned int ARITY = 4;
+    static constexpr double MINIMUM = 0.0;
+    static constexpr double MAXIMUM = 1.0;
+    static void decode(SubjectCore &subject, const double *outputs);
+};
+
+/*!
+ * \namespace Encoding
+ * \brief Registry of the input and output types, indexed by type.
+ * Subjects and neural networks resolve their types from here once,
+ * instead of branching on them whenever they are used.
+ * \author terratenff
+ */
+namespace Encoding
+{
+    /*!
+     * \fn describe_input
+     * \brief Creates the description of an input type.
+     * \return Description built from the specialization of the type.
+     */
+    template <input_type T>
+    constexpr InputEncoding describe_input()
+    {
+        return {T,
+                InputEncoder<T>::ARITY,
+                InputEncoder<T>::MINIMUM,
+                InputEncoder<T>::MAXIMUM,
+                &InputEncoder<T>::encode};
+    }
+
+    /*!
+     * \fn describe_output
+     * \brief Creates the description of an output type.
+     * \return Description built from the specialization of the type.
+     */
+    template <output_type T>
+    constexpr OutputEncoding describe_output()
+    {
+        return {T,
+                OutputDecoder<T>::ARITY,
+                OutputDecoder<T>::MINIMUM,
+                OutputDecoder<T>::MAXIMUM,
+                &OutputDecoder<T>::decode};
+    }
+
+    /*!
+     * \var INPUTS
+     * \brief Descriptions of the input types, in enum order.
+     */
+    inline constexpr InputEncoding INPUTS[] = {
+        describe_input<NO_INPUT>(),
+        describe_input<ANGULAR_DIFFERENCE>(),
+        describe_input<SPACE_TOTAL_DIFFERENCE>(),
+        describe_input<SPACE_AXIS_DIFFERENCE>(),
+        describe_input<WALL_DISTANCES>(),
+        describe_input<FOUR_WAY_SEARCH>(),
+        describe_input<FOUR_CORNER_SEARCH>()
+    };
+
+    /*!
+     * \var OUTPUTS
+     * \brief Descriptions of the output types, in enum order.
+     */
+    inline constexpr OutputEncoding OUTPUTS[] = {
+        describe_output<NO_OUTPUT>(),
+        describe_output<ANGULAR_VELOCITY>(),
+        describe_output<DIRECT_ANGLE>(),
+        describe_output<ANGLE_VELOCITY>(),
+        describe_output<ANGLE_ACCELERATION>(),
+        describe_output<AXIS_VELOCITY>(),
+        describe_output<AXIS_ACCELERATION>(),
+        describe_output<SMALL_HOPS>(),
+        describe_output<FIXED_MOVEMENT>()
+    };
+
+    /*!
+     * \fn in_order
+     * \brief Checks that every description sits at the index of its
+     * type, so that types can be looked up by index.
+     * \return true, if the registry is in enum order.
+     */
+    constexpr bool in_order()
+    {
+        for (unsigned int i = 0; i < sizeof(INPUTS) / sizeof(*INPUTS); i++) {
+            if (INPUTS[i].type != static_cast<input_type>(i)) return false;
+        }
+        for (unsigned int i = 0; i < sizeof(OUTPUTS) / sizeof(*OUTPUTS);
+             i++) {
+            if (OUTPUTS[i].type != static_cast<output_type>(i)) return false;
+        }
+        return true;
+    }
+
+    static_assert(in_order(), "Encodings must be listed in enum order");
+
+    /*!
+     * \fn input_encoding
+     * \brief Looks up an input type.
+     * \param type Input type.
+     * \return Description of the input type.
+     */
+    constexpr const InputEncoding &input_encoding(input_type type)
+    {
+        return INPUTS[type];
+    }
+
+    /*!
+     * \fn output_encoding
+     * \brief Looks up an output type.
+     * \param type Output type.
+     * \return Description of the output type.
+     */
+    constexpr const OutputEncoding &output_encoding(output_type type)
+    {
+        return OUTPUTS[type];
+    }
+}
+
+#endif // ENCODING_HH
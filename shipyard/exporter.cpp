@@ -0,0 +1,287 @@
+#include "exporter.hh"
+#include <cctype>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace
+{
+    std::string identifier(const std::string &name)
+    {
+        std::string result;
+        for (char c : name) {
+            unsigned char u = static_cast<unsigned char>(c);
+            result += std::isalnum(u) ? c : '_';
+        }
+        if (result.empty() || std::isdigit(
+                    static_cast<unsigned char>(result[0]))) {
+            result = "_" + result;
+        }
+        return result;
+    }
+
+    std::string literal(double value)
+    {
+        std::ostringstream text;
+        text << std::setprecision(std::numeric_limits<double>::max_digits10)
+             << value;
+        std::string result = text.str();
+        if (result.find_first_of(".e") == std::string::npos) result += ".0";
+        return result;
+    }
+
+    // Body of the activation function, in terms of x. Softmax is
+    // applied over whole layers instead, see write_layer().
+    std::string activation_body(activation_type type)
+    {
+        std::string epsilon =
+                literal(std::numeric_limits<double>::epsilon());
+        switch(type) {
+        case HYPERBOLIC_TANGENT:
+            return "return (2 / (1 + std::exp(-2*x))) - 1;";
+        case SIGN:
+            return "if (std::abs(x) < " + epsilon + ") return 0;\n"
+                   "        else if (x > 0) return 1;\n"
+                   "        else return -1;";
+        case HEAVISIDE:
+            return "if (std::abs(x) < " + epsilon + " || x > 0) return 1;\n"
+                   "        else return 0;";
+        case RELU:
+            return "return std::fmax(0.0, x);";
+        case RELU_LEAKY:
+            return "return x > 0 ? x : x * 0.01;";
+        case GAUSSIAN:
+            return "return std::exp(-(x*x));";
+        case SIGMOID:
+        case SOFTMAX:
+        case NO_ACTIVATION:
+            break;
+        }
+        return "return 1 / (1 + std::exp(-x));";
+    }
+
+    void write_activation(std::ostringstream &out,
+                          const std::string &name,
+                          activation_type type)
+    {
+        if (type == SOFTMAX) return;
+        out << "    inline double " << name << "(double x)\n"
+            << "    {\n"
+            << "        " << activation_body(type) << "\n"
+            << "    }\n\n";
+    }
+
+    void write_arrays(std::ostringstream &out,
+                      unsigned int layer,
+                      const Matrix &weights,
+                      const Row &biases)
+    {
+        size_t columns = weights.empty() ? 0 : weights[0].size();
+        out << "    constexpr double WEIGHTS_" << layer
+            << "[" << weights.size() << "][" << columns << "] = {\n";
+        for (const Row &row : weights) {
+            out << "        {";
+            for (size_t i = 0; i < row.size(); i++) {
+                if (i > 0) out << ", ";
+                out << literal(row[i]);
+            }
+            out << "},\n";
+        }
+        out << "    };\n\n";
+
+        out << "    constexpr double BIASES_" << layer
+            << "[" << biases.size() << "] = {\n        ";
+        for (size_t j = 0; j < biases.size(); j++) {
+            if (j > 0) out << ", ";
+            out << literal(biases[j]);
+        }
+        out << "\n    };\n\n";
+    }
+
+    // Whether any weight of the next layer reads the neuron. Output
+    // neurons, with no next layer, are always read.
+    bool is_read(const Matrix *next, size_t neuron)
+    {
+        if (next == nullptr) return true;
+        for (const Row &row : *next) {
+            if (row[neuron] != 0) return true;
+        }
+        return false;
+    }
+
+    // Neurons are named n<layer>_<index>. Weights of exactly 0, such as
+    // pruned ones, are left out of the sums, and so are neurons that
+    // only such weights read.
+    void write_layer(std::ostringstream &out,
+                     unsigned int layer,
+                     const Matrix &weights,
+                     const Matrix *next,
+                     const std::string &activation,
+                     activation_type type)
+    {
+        for (size_t j = 0; j < weights.size(); j++) {
+            if (type != SOFTMAX && !is_read(next, j)) continue;
+            out << "        const double s" << layer << "_" << j
+                << " = BIASES_" << layer - 1 << "[" << j << "]";
+            for (size_t i = 0; i < weights[j].size(); i++) {
+                if (weights[j][i] == 0) continue;
+                out << "\n                + WEIGHTS_" << layer - 1
+                    << "[" << j << "][" << i << "] * n"
+                    << layer - 1 << "_" << i;
+            }
+            out << ";\n";
+        }
+
+        if (type != SOFTMAX) {
+            for (size_t j = 0; j < weights.size(); j++) {
+                if (!is_read(next, j)) continue;
+                out << "        const double n" << layer << "_" << j
+                    << " = " << activation << "(s" << layer << "_" << j
+                    << ");\n";
+            }
+            return;
+        }
+
+        for (size_t j = 0; j < weights.size(); j++) {
+            out << "        const double e" << layer << "_" << j
+                << " = std::exp(s" << layer << "_" << j << ");\n";
+        }
+        out << "        const double total" << layer << " = ";
+        for (size_t j = 0; j < weights.size(); j++) {
+            if (j > 0) out << " + ";
+            out << "e" << layer << "_" << j;
+        }
+        out << ";\n";
+        for (size_t j = 0; j < weights.size(); j++) {
+            out << "        const double n" << layer << "_" << j
+                << " = e" << layer << "_" << j << " / total" << layer
+                << ";\n";
+        }
+    }
+}
+
+std::string Exporter::inference_header(const NeuralNetwork &nn,
+                                       const std::string &name)
+{
+    std::string space = identifier(name);
+    std::string guard;
+    for (char c : space) {
+        unsigned char u = static_cast<unsigned char>(c);
+        guard += static_cast<char>(std::toupper(u));
+    }
+    guard += "_HH";
+
+    const vector<unsigned int> &layers = nn.getLayers();
+    vector<Matrix> weights = nn.getWeights();
+    vector<Row> biases = nn.getBiases();
+    unsigned int last = static_cast<unsigned int>(layers.size()) - 1;
+
+    // Binary networks run the blocks after the first one with
+    // binarized weights both in feedForward() and in the batch engine
+    // of the simulation, see "binary.hh".
+    if (nn.isBinary()) {
+        const BinaryWeightSet &binary = nn.getBinaryWeightSet();
+        for (unsigned int i = 1; i < weights.size(); i++) {
+            const double *scales = binary.scales(i);
+            for (unsigned int j = 0; j < weights[i].size(); j++) {
+                for (double &weight : weights[i][j]) {
+                    if (weight > 0) weight = scales[j];
+                    else if (weight < 0) weight = -scales[j];
+                }
+            }
+        }
+    }
+
+    std::ostringstream out;
+    out << "// Generated by Neural Networks Demonstrator.\n"
+        << "// Layers:";
+    for (unsigned int width : layers) out << " " << width;
+    out << "\n\n"
+        << "#ifndef " << guard << "\n"
+        << "#define " << guard << "\n\n"
+        << "#include <cmath>\n\n"
+        << "namespace " << space << "\n"
+        << "{\n"
+        << "    constexpr unsigned int INPUT_COUNT = " << layers[0] << ";\n"
+        << "    constexpr unsigned int OUTPUT_COUNT = " << layers[last]
+        << ";\n\n";
+
+    for (unsigned int i = 0; i < weights.size(); i++) {
+        write_arrays(out, i, weights[i], biases[i]);
+    }
+    write_activation(out, "hidden_activation", nn.getHiddenActivation());
+    write_activation(out, "output_activation", nn.getOutputActivation());
+
+    out << "    inline void feed_forward(const double *inputs, "
+           "double *outputs)\n"
+        << "    {\n";
+    for (unsigned int i = 0; i < layers[0]; i++) {
+        if (!is_read(&weights[0], i)) continue;
+        out << "        const double n0_" << i << " = inputs[" << i << "];\n";
+    }
+    for (unsigned int l = 1; l <= last; l++) {
+        bool output = l == last;
+        write_layer(out, l, weights[l - 1],
+                    output ? nullptr : &weights[l],
+                    output ? "output_activation" : "hidden_activation",
+                    output ? nn.getOutputActivation()
+                           : nn.getHiddenActivation());
+    }
+    for (unsigned int j = 0; j < layers[last]; j++) {
+        out << "        outputs[" << j << "] = n" << last << "_" << j
+            << ";\n";
+    }
+    out << "    }\n"
+        << "}\n\n"
+        << "#endif // " << guard << "\n";
+    return out.str();
+}
+
+int Exporter::save_inference_header(const NeuralNetwork &nn,
+                                    const std::string &path,
+                                    const std::string &name)
+{
+    std::ofstream file;
+    file.open(path);
+    if (!file.is_open()) return 1;
+    file << inference_header(nn, name);
+    file.close();
+    return 0;
+}
+
+int Exporter::save_population(const std::vector<NeuralNetwork*> &networks,
+                              const std::string &path)
+{
+    std::ofstream file;
+    file.open(path);
+    if (!file.is_open()) return 1;
+    file << std::setprecision(std::numeric_limits<double>::max_digits10);
+    for (unsigned int n = 0; n < networks.size(); n++) {
+        const NeuralNetwork &nn = *networks[n];
+        file << "NETWORK " << n << "\n"
+             << "FITNESS " << nn.getFitness() << "\n"
+             << "LAYERS";
+        for (unsigned int width : nn.getLayers()) file << " " << width;
+        file << "\n";
+
+        vector<Matrix> weights = nn.getWeights();
+        vector<Row> biases = nn.getBiases();
+        for (unsigned int i = 0; i < weights.size(); i++) {
+            file << "WEIGHTS " << i << "\n";
+            for (const Row &row : weights[i]) {
+                for (unsigned int k = 0; k < row.size(); k++) {
+                    file << (k > 0 ? " " : "") << row[k];
+                }
+                file << "\n";
+            }
+            file << "BIASES " << i << "\n";
+            for (unsigned int j = 0; j < biases[i].size(); j++) {
+                file << (j > 0 ? " " : "") << biases[i][j];
+            }
+            file << "\n";
+        }
+    }
+    file.close();
+    return 0;
+}
@@ -0,0 +1,72 @@
+#ifndef EXPORTER_HH
+#define EXPORTER_HH
+
+#include "neuralnetwork.hh"
+#include <string>
+#include <vector>
+
+/*!
+ * \namespace Exporter
+ * \brief Turns a neural network into a self-contained C++ header for
+ * use outside of the application. The header holds the weights and
+ * biases as constexpr arrays, along with a fully unrolled inference
+ * function that has the activation functions of the network built
+ * in. It depends on nothing but <cmath>.
+ *
+ * Binary networks are exported with their binarized weights. The
+ * header computes in double precision with exact activation
+ * functions, so it matches feedForward() of networks that use double
+ * precision without fast math. Networks running in lower precision or
+ * with fast math differ from it by their rounding and approximations.
+ *
+ * Whole populations can also be written into a text file.
+ * \author terratenff
+ */
+namespace Exporter
+{
+    /*!
+     * \fn inference_header
+     * \brief Creates the header for a neural network.
+     * \param nn Target neural network.
+     * \param name Name of the namespace that holds the network in the
+     * header. Characters that cannot appear in an identifier are
+     * replaced with underscores.
+     * \return Contents of the header. The namespace provides
+     * INPUT_COUNT, OUTPUT_COUNT and
+     * feed_forward(const double *inputs, double *outputs).
+     */
+    std::string inference_header(const NeuralNetwork &nn,
+                                 const std::string &name);
+
+    /*!
+     * \fn save_inference_header
+     * \brief Creates the header for a neural network and writes it
+     * into a file.
+     * \param nn Target neural network.
+     * \param path Path to the file.
+     * \param name Name of the namespace, see inference_header().
+     * \return Integer code for the outcome: 0 for success,
+     * 1 for a file that could not be opened.
+     */
+    int save_inference_header(const NeuralNetwork &nn,
+                              const std::string &path,
+                              const std::string &name);
+
+    /*!
+     * \fn save_population
+     * \brief Writes the weights and biases of neural networks into a
+     * text file. Every network starts with a "NETWORK <index>" line,
+     * followed by "FITNESS <value>" and "LAYERS <widths>". Every
+     * weight block follows as a "WEIGHTS <layer>" line with one line
+     * per row, and a "BIASES <layer>" line with the biases below it.
+     * Values are written with enough digits to read them back exactly.
+     * \param networks Target neural networks.
+     * \param path Path to the file.
+     * \return Integer code for the outcome: 0 for success,
+     * 1 for a file that could not be opened.
+     */
+    int save_population(const std::vector<NeuralNetwork*> &networks,
+                        const std::string &path);
+}
+
+#endif // EXPORTER_HH
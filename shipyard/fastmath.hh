@@ -0,0 +1,89 @@
+#ifndef FASTMATH_HH
+#define FASTMATH_HH
+
+/*!
+ * \file fastmath.hh
+ * \brief Fast approximations of the exponential function and the
+ * activation functions built on it. Functions operate on whole rows
+ * in place and use AVX2 or SSE2 whenever it is the dense layer kernel
+ * in use (see layerkernel.hh).
+ *
+ * The exponential function is computed by splitting x into
+ * n * ln(2) + r, where |r| <= ln(2) / 2, and evaluating a polynomial
+ * for exp(r) that is then scaled by 2^n. Inputs are clamped so that
+ * the result is always a normal number: very large inputs give the
+ * largest representable power instead of infinity, very small inputs
+ * a tiny positive number instead of zero.
+ * \author terratenff
+ */
+
+/*!
+ * \var FAST_EXP_TOLERANCE
+ * \brief Largest relative error of fast_exp compared with std::exp,
+ * for inputs within the clamped range.
+ */
+const double FAST_EXP_TOLERANCE = 1e-15;
+
+/*!
+ * \var FAST_EXP_TOLERANCE_FLOAT
+ * \brief Same as FAST_EXP_TOLERANCE, for single precision.
+ */
+const float FAST_EXP_TOLERANCE_FLOAT = 1e-6f;
+
+/*!
+ * \fn fast_exp
+ * \brief Approximation of the exponential function.
+ * \param x Target value.
+ * \return e to the power of x.
+ */
+double fast_exp(double x);
+float fast_exp(float x);
+
+/*!
+ * \fn fast_exp_row
+ * \brief Approximation of the exponential function for a row.
+ * \param values Target values, replaced with their exponentials.
+ * \param count Number of values.
+ */
+void fast_exp_row(double *values, unsigned int count);
+void fast_exp_row(float *values, unsigned int count);
+
+/*!
+ * \fn fast_sigmoid_row
+ * \brief Activation function "sigmoid" for a row.
+ * \param values Target values, activated in place.
+ * \param count Number of values.
+ */
+void fast_sigmoid_row(double *values, unsigned int count);
+void fast_sigmoid_row(float *values, unsigned int count);
+
+/*!
+ * \fn fast_hyperbolic_tangent_row
+ * \brief Activation function "hyperbolic tangent" for a row.
+ * \param values Target values, activated in place.
+ * \param count Number of values.
+ */
+void fast_hyperbolic_tangent_row(double *values, unsigned int count);
+void fast_hyperbolic_tangent_row(float *values, unsigned int count);
+
+/*!
+ * \fn fast_gaussian_row
+ * \brief Activation function "gaussian" for a row.
+ * \param values Target values, activated in place.
+ * \param count Number of values.
+ */
+void fast_gaussian_row(double *values, unsigned int count);
+void fast_gaussian_row(float *values, unsigned int count);
+
+/*!
+ * \fn fast_softmax_row
+ * \brief Activation function "softmax" for a row. The largest value
+ * is subtracted before exponentiation, which does not change the
+ * result but keeps it finite.
+ * \param values Target values, activated in place.
+ * \param count Number of values.
+ */
+void fast_softmax_row(double *values, unsigned int count);
+void fast_softmax_row(float *values, unsigned int count);
+
+#endif // FASTMATH_HH
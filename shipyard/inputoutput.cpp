@@ -2,12 +2,11 @@
 #include <algorithm>
 
 
-Row Input::angular_difference(double angle,
-                              XY position,
-                              XY target_position)
+void Input::angular_difference(double angle,
+                               XY position,
+                               XY target_position,
+                               double *inputs)
 {
-    Row inputs;
-
     double target_angle = calculate_angle(position, target_position);
     double semiInput = abs(angle - target_angle);
     if (semiInput > 180) {
@@ -15,27 +14,24 @@ Row Input::angular_difference(double angle,
     }
     semiInput = semiInput / 180;
 
-    inputs.push_back(semiInput);
-
-    return inputs;
+    inputs[0] = semiInput;
 }
 
-Row Input::space_scalar_difference(XY position,
-                                   XY target_position)
+void Input::space_scalar_difference(XY position,
+                                    XY target_position,
+                                    double *inputs)
 {
-    Row inputs;
     double difference = distance(position, target_position);
     double scaled_difference = min(1.0, difference / 2000.0);
     double semiInput = scaled_difference;
 
-    inputs.push_back(semiInput);
-    return inputs;
+    inputs[0] = semiInput;
 }
 
-Row Input::space_axis_difference(XY position,
-                                 XY target_position)
+void Input::space_axis_difference(XY position,
+                                  XY target_position,
+                                  double *inputs)
 {
-    Row inputs;
     XY difference = target_position - position;
     XY scaled_difference(difference.x / 1920.0, difference.y / 1080.0);
     if (scaled_difference.x < -1.0) scaled_difference.x = -1.0;
@@ -43,14 +39,12 @@ Row Input::space_axis_difference(XY position,
     if (scaled_difference.x > 1.0) scaled_difference.x = 1.0;
     if (scaled_difference.y > 1.0) scaled_difference.y = 1.0;
 
-    inputs.push_back(scaled_difference.x);
-    inputs.push_back(scaled_difference.y);
-    return inputs;
+    inputs[0] = scaled_difference.x;
+    inputs[1] = scaled_difference.y;
 }
 
-Row Input::wall_distances(XY position)
+void Input::wall_distances(XY position, double *inputs)
 {
-    Row inputs;
     double left = (1920.0 - position.x) / 1920.0;
     double right = position.x / 1920.0;
     double up = (1080.0 - position.y) / 1080.0;
@@ -64,17 +58,16 @@ Row Input::wall_distances(XY position)
     if (up < 0.0) up = 0.0;
     if (down < 0.0) down = 0.0;
 
-    inputs.push_back(left);
-    inputs.push_back(right);
-    inputs.push_back(up);
-    inputs.push_back(down);
-    return inputs;
+    inputs[0] = left;
+    inputs[1] = right;
+    inputs[2] = up;
+    inputs[3] = down;
 }
 
-Row Input::four_way_search(XY position,
-                           XY target_position)
+void Input::four_way_search(XY position,
+                            XY target_position,
+                            double *inputs)
 {
-    Row inputs;
     bool left = near_double(position.y, target_position.y, 100)
             && position.x >= target_position.x;
     bool right = near_double(position.y, target_position.y, 100)
@@ -84,119 +77,104 @@ Row Input::four_way_search(XY position,
     bool down = near_double(position.x, target_position.x, 100)
             && position.y < target_position.y;
 
-    double dist = space_scalar_difference(position, target_position)[0];
-
-    if (left)  inputs.push_back(dist);
-    else       inputs.push_back(0.0);
-    if (right) inputs.push_back(dist);
-    else       inputs.push_back(0.0);
-    if (up)    inputs.push_back(dist);
-    else       inputs.push_back(0.0);
-    if (down)  inputs.push_back(dist);
-    else       inputs.push_back(0.0);
-    return inputs;
+    double dist;
+    space_scalar_difference(position, target_position, &dist);
+
+    inputs[0] = left ? dist : 0.0;
+    inputs[1] = right ? dist : 0.0;
+    inputs[2] = up ? dist : 0.0;
+    inputs[3] = down ? dist : 0.0;
 }
 
-Row Input::four_corner_search(XY position, XY target_position)
+void Input::four_corner_search(XY position,
+                               XY target_position,
+                               double *inputs)
 {
-    Row inputs;
-
     XY difference = target_position - position;
-    inputs.push_back(0.0);
-    inputs.push_back(0.0);
-    inputs.push_back(0.0);
-    inputs.push_back(0.0);
+    inputs[0] = 0.0;
+    inputs[1] = 0.0;
+    inputs[2] = 0.0;
+    inputs[3] = 0.0;
     bool left = difference.x < 0.0;
     bool right = difference.x > 0.0;
     bool up = difference.y < 0.0;
     bool down = difference.y > 0.0;
 
-    double dist = space_scalar_difference(position, target_position)[0];
+    double dist;
+    space_scalar_difference(position, target_position, &dist);
 
     if      (left && up)    inputs[0] = dist;
     else if (left && down)  inputs[1] = dist;
     else if (right && up)   inputs[2] = dist;
     else if (right && down) inputs[3] = dist;
-
-    return inputs;
 }
 
-Row Output::angular_velocity(const Row &outputs, double factor)
+void Output::angular_velocity(const double *outputs,
+                              double factor,
+                              double *values)
 {
-    Row outputValues;
-    outputValues.push_back(outputs[0] * factor);
-    return outputValues;
+    values[0] = outputs[0] * factor;
 }
 
-Row Output::direct_angle(const Row &outputs)
+void Output::direct_angle(const double *outputs,
+                          double *values)
 {
-    Row outputValues;
-    outputValues.push_back(outputs[0] * 360);
-    return outputValues;
+    values[0] = outputs[0] * 360;
 }
 
-Row Output::angle_velocity(const Row &outputs,
-                           double factor_angular_velocity,
-                           double factor_velocity)
+void Output::angle_velocity(const double *outputs,
+                            double factor_angular_velocity,
+                            double factor_velocity,
+                            double *values)
 {
-    Row outputValues;
-    outputValues.push_back(outputs[0] * factor_angular_velocity);
-    outputValues.push_back(outputs[1] * factor_velocity);
-    return outputValues;
+    values[0] = outputs[0] * factor_angular_velocity;
+    values[1] = outputs[1] * factor_velocity;
 }
 
-Row Output::angle_acceleration(const Row &outputs,
-                               double factor_angular_velocity,
-                               double factor_acceleration)
+void Output::angle_acceleration(const double *outputs,
+                                double factor_angular_velocity,
+                                double factor_acceleration,
+                                double *values)
 {
-    Row outputValues;
-    outputValues.push_back(outputs[0] * factor_angular_velocity);
-    outputValues.push_back(outputs[1] * factor_acceleration);
-    return outputValues;
+    values[0] = outputs[0] * factor_angular_velocity;
+    values[1] = outputs[1] * factor_acceleration;
 }
 
-Row Output::axis_velocity(const Row &outputs, XY factor)
+void Output::axis_velocity(const double *outputs,
+                           XY factor,
+                           double *values)
 {
-    Row outputValues;
-    outputValues.push_back(outputs[0] * factor.x);
-    outputValues.push_back(outputs[1] * factor.y);
-    return outputValues;
+    values[0] = outputs[0] * factor.x;
+    values[1] = outputs[1] * factor.y;
 }
 
-Row Output::axis_acceleration(const Row &outputs, XY factor)
+void Output::axis_acceleration(const double *outputs,
+                               XY factor,
+                               double *values)
 {
-    Row outputValues;
-    outputValues.push_back(outputs[0] * factor.x);
-    outputValues.push_back(outputs[1] * factor.y);
-    return outputValues;
+    values[0] = outputs[0] * factor.x;
+    values[1] = outputs[1] * factor.y;
 }
 
-Row Output::small_hops(const Row &outputs)
+void Output::small_hops(const double *outputs,
+                        double *values)
 {
-    Row outputValues;
-    if (near_zero(outputs[0])) outputValues.push_back(0.0);
-    else if (outputs[0] > 0.0) outputValues.push_back(1.0);
-    else if (outputs[0] < 0.0) outputValues.push_back(-1.0);
-    else outputValues.push_back(0.0);
-
-    if (near_zero(outputs[1])) outputValues.push_back(0.0);
-    else if (outputs[1] > 0.0) outputValues.push_back(1.0);
-    else if (outputs[1] < 0.0) outputValues.push_back(-1.0);
-    else outputValues.push_back(0.0);
-
-    return outputValues;
+    for (int i = 0; i < 2; i++) {
+        if (near_zero(outputs[i])) values[i] = 0.0;
+        else if (outputs[i] > 0.0) values[i] = 1.0;
+        else if (outputs[i] < 0.0) values[i] = -1.0;
+        else values[i] = 0.0;
+    }
 }
 
-Row Output::fixed_movement(const Row &outputs)
+void Output::fixed_movement(const double *outputs,
+                            double *values)
 {
-    Row outputValues;
-    auto iter = std::max_element(outputs.begin(), outputs.end());
-    int index = static_cast<int>(std::distance(outputs.begin(), iter));
+    const double *iter = std::max_element(outputs, outputs + 4);
+    int index = static_cast<int>(iter - outputs);
 
     for (int i = 0; i < 4; i++) {
-        if (i == index) outputValues.push_back(1.0);
-        else outputValues.push_back(0.0);
+        if (i == index) values[i] = 1.0;
+        else values[i] = 0.0;
     }
-
-    return outputValues;
 }
@@ -18,13 +18,14 @@ namespace Input
      * \param angle Current angle.
      * \param position Current position.
      * \param target_position Target position.
-     * \return Angular difference, reduced to range (0,1). 0 implies
-     * equal angles, and 1 implies opposite angles.
-     * \post Input vector size should be 1.
+     * \param inputs Angular difference, reduced to range (0,1). 0
+     * implies equal angles, and 1 implies opposite angles.
+     * \pre Inputs should have room for 1 value.
      */
-    Row angular_difference(double angle,
-                           XY position,
-                           XY target_position);
+    void angular_difference(double angle,
+                            XY position,
+                            XY target_position,
+                            double *inputs);
 
     /*!
      * \fn space_scalar_difference
@@ -33,13 +34,14 @@ namespace Input
      * between the subject and the target.
      * \param position Current position.
      * \param target_position Target position.
-     * \return Scalar spatial difference, reduced to range (0,1]. 0
-     * implies zero distance, and 1 implies a distance of 2000
+     * \param inputs Scalar spatial difference, reduced to range (0,1].
+     * 0 implies zero distance, and 1 implies a distance of 2000
      * or greater.
-     * \post Input vector size should be 1.
+     * \pre Inputs should have room for 1 value.
      */
-    Row space_scalar_difference(XY position,
-                                XY target_position);
+    void space_scalar_difference(XY position,
+                                 XY target_position,
+                                 double *inputs);
 
     /*!
      * \fn space_axis_difference
@@ -49,15 +51,16 @@ namespace Input
      * and the second for the y-axis.
      * \param position Current position.
      * \param target_position Target position.
-     * \return 2D spatial difference, reduced to range [-1, 1]. -1
+     * \param inputs 2D spatial difference, reduced to range [-1, 1]. -1
      * implies that the target is of distance 1920+ to the left (x),
      * or of distance 1080+ upwards (y). 1 implies that the target is
      * of distance 1920+ to the right (x), or of distance 1080+
      * downwards (y).
-     * \post Input vector size should be 2.
+     * \pre Inputs should have room for 2 values.
      */
-    Row space_axis_difference(XY position,
-                              XY target_position);
+    void space_axis_difference(XY position,
+                               XY target_position,
+                               double *inputs);
 
     /*!
      * \fn wall_distances
@@ -65,13 +68,13 @@ namespace Input
      * consists of four values, those being distances to the four
      * walls that confine the subjects.
      * \param position Current position
-     * \return Subject distances to four walls, reduced to range [0,1].
-     * 0 implies not being past a wall, but rather, being past some other
+     * \param inputs Subject distances to four walls, reduced to range
+     * [0,1]. 0 implies not being past a wall, but rather, being past some other
      * wall. 1 implies being past a wall (resulting in a 0 on some other
      * value). Reduced distances by order: left, right, up, down.
-     * \post Input vector size should be 4.
+     * \pre Inputs should have room for 4 values.
      */
-    Row wall_distances(XY position);
+    void wall_distances(XY position, double *inputs);
 
     /*!
      * \fn four_way_search
@@ -80,15 +83,16 @@ namespace Input
      * in horizontal + vertical directions.
      * \param position Current position.
      * \param target_position Target position.
-     * \return Detection values to the target, as two different possible
-     * values: 0 implies no detection, and any number greater than 0
+     * \param inputs Detection values to the target, as two different
+     * possible values: 0 implies no detection, and any number greater than 0
      * implies a detection. Magnitude of the number determines
      * how close the detection is.
      * Directions by order: left, right, up, down.
-     * \post Input vector size should be 4.
+     * \pre Inputs should have room for 4 values.
      */
-    Row four_way_search(XY position,
-                        XY target_position);
+    void four_way_search(XY position,
+                         XY target_position,
+                         double *inputs);
 
     /*!
      * \fn four_corner_search
@@ -97,15 +101,16 @@ namespace Input
      * in the subject's four corners.
      * \param position Current position.
      * \param target_position Target position.
-     * \return Detection values to the target, as two different possible
-     * values: 0 implies no detection, and any number greater than 0
+     * \param inputs Detection values to the target, as two different
+     * possible values: 0 implies no detection, and any number greater than 0
      * implies a detection. Magnitude of the number determines how
      * close the detection is.
      * Corners by order: top-left, bottom-left, top-right, bottom-right.
-     * \post Input vector size should be 4.
+     * \pre Inputs should have room for 4 values.
      */
-    Row four_corner_search(XY position,
-                           XY target_position);
+    void four_corner_search(XY position,
+                            XY target_position,
+                            double *inputs);
 }
 
 /*!
@@ -121,22 +126,23 @@ namespace Output
      * The output consists of one value, that being angular velocity.
      * \param outputs Output values from the neural network.
      * \param factor Scale for angular velocity (Maximum Change).
-     * \return Angular velocity, scaled by provided factor.
-     * \pre Output vector size should be 1.
-     * \post Returned vector size should be 1.
+     * \param values Angular velocity, scaled by provided factor.
+     * \pre Outputs should hold 1 value, and values have room for 1.
      */
-    Row angular_velocity(const Row &outputs, double factor);
+    void angular_velocity(const double *outputs,
+                          double factor,
+                          double *values);
 
     /*!
      * \fn direct_angle
      * \brief Creates outputs from the neural network, for the subject.
      * The output consists of one value, that being a specific angle.
      * \param outputs Output values from the neural network.
-     * \return An angle in degrees, varying in range [0,360].
-     * \pre Output vector size should be 1.
-     * \post Returned vector size should be 1.
+     * \param values An angle in degrees, varying in range [0,360].
+     * \pre Outputs should hold 1 value, and values have room for 1.
      */
-    Row direct_angle(const Row &outputs);
+    void direct_angle(const double *outputs,
+                      double *values);
 
     /*!
      * \fn angle_velocity
@@ -147,13 +153,14 @@ namespace Output
      * \param factor_angular_velocity Scale for angular velocity
      * (Maximum Change).
      * \param factor_velocity Scale for velocity (Maximum Change).
-     * \return Angular velocity and velocity, scaled by provided factors.
-     * \pre Output vector size should be 2.
-     * \post Returned vector size should be 2.
+     * \param values Angular velocity and velocity, scaled by provided
+     * factors.
+     * \pre Outputs should hold 2 values, and values have room for 2.
      */
-    Row angle_velocity(const Row &outputs,
-                       double factor_angular_velocity,
-                       double factor_velocity);
+    void angle_velocity(const double *outputs,
+                        double factor_angular_velocity,
+                        double factor_velocity,
+                        double *values);
 
     /*!
      * \fn angle_acceleration
@@ -165,13 +172,14 @@ namespace Output
      * (Maximum Change).
      * \param factor_acceleration Scale for acceleration
      * (Maximum Change).
-     * \return Angular velocity and acceleration, scaled by provided factors.
-     * \pre Output vector size should be 2.
-     * \post Returned vector size should be 2.
+     * \param values Angular velocity and acceleration, scaled by
+     * provided factors.
+     * \pre Outputs should hold 2 values, and values have room for 2.
      */
-    Row angle_acceleration(const Row &outputs,
-                           double factor_angular_velocity,
-                           double factor_acceleration);
+    void angle_acceleration(const double *outputs,
+                            double factor_angular_velocity,
+                            double factor_acceleration,
+                            double *values);
 
     /*!
      * \fn axis_velocity
@@ -180,11 +188,12 @@ namespace Output
      * axes x and y, respectively.
      * \param outputs Output values from the neural network.
      * \param factor Scale for axis-wise velocities (Maximum Change).
-     * \return Axis-wise velocities, scaled by provided factor.
-     * \pre Output vector size should be 2.
-     * \post Returned vector size should be 2.
+     * \param values Axis-wise velocities, scaled by provided factor.
+     * \pre Outputs should hold 2 values, and values have room for 2.
      */
-    Row axis_velocity(const Row &outputs, XY factor);
+    void axis_velocity(const double *outputs,
+                       XY factor,
+                       double *values);
 
     /*!
      * \fn axis_acceleration
@@ -193,11 +202,12 @@ namespace Output
      * axes x and y, respectively.
      * \param outputs Output values from the neural network.
      * \param factor Scale for axis-wise accelerations (Maximum Change).
-     * \return Axis-wise accelerations, scaled by provided factor.
-     * \pre Output vector size should be 2.
-     * \post Returned vector size should be 2.
+     * \param values Axis-wise accelerations, scaled by provided factor.
+     * \pre Outputs should hold 2 values, and values have room for 2.
      */
-    Row axis_acceleration(const Row &outputs, XY factor);
+    void axis_acceleration(const double *outputs,
+                           XY factor,
+                           double *values);
 
     /*!
      * \fn small_hops
@@ -205,11 +215,11 @@ namespace Output
      * The output consists of two values, those being small steps for
      * axes x and y, respectively.
      * \param outputs Output values from the neural network.
-     * \return Small hops, unaffected by any factors.
-     * \pre Output vector size should be 2.
-     * \post Returned vector size should be 2.
+     * \param values Small hops, unaffected by any factors.
+     * \pre Outputs should hold 2 values, and values have room for 2.
      */
-    Row small_hops(const Row &outputs);
+    void small_hops(const double *outputs,
+                    double *values);
 
     /*!
      * \fn fixed_movement
@@ -217,12 +227,12 @@ namespace Output
      * The output consists of four values, those being both horizontal
      * and vertical directions that the subject is allowed to move in.
      * \param outputs Output values from the neural network.
-     * \return Direction, where the subject is allowed to go. The
+     * \param values Direction, where the subject is allowed to go. The
      * highest-valued output element is selected.
-     * \pre Output vector size should be 4.
-     * \post Returned vector size should be 4.
+     * \pre Outputs should hold 4 values, and values have room for 4.
      */
-    Row fixed_movement(const Row &outputs);
+    void fixed_movement(const double *outputs,
+                        double *values);
 }
 
 #endif // INPUTOUTPUT_HH
@@ -0,0 +1,360 @@
+#include "layerkernel.hh"
+#include <cstddef>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define LAYERKERNEL_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    template <typename T>
+    using kernel_function = void (*)(const T *,
+                                     unsigned int,
+                                     unsigned int,
+                                     unsigned int,
+                                     const T *,
+                                     const T *,
+                                     T *);
+
+    using int8_kernel_function = void (*)(const int8_t *,
+                                          unsigned int,
+                                          unsigned int,
+                                          unsigned int,
+                                          const int8_t *,
+                                          int32_t *);
+
+    template <typename T>
+    void dense_layer_scalar(const T *weights,
+                            unsigned int rows,
+                            unsigned int columns,
+                            unsigned int stride,
+                            const T *input,
+                            const T *bias,
+                            T *output)
+    {
+        for (unsigned int j = 0; j < rows; j++) {
+            const T *row = weights + static_cast<size_t>(j) * stride;
+            T value = bias[j];
+            for (unsigned int k = 0; k < columns; k++) {
+                value += row[k] * input[k];
+            }
+            output[j] = value;
+        }
+    }
+
+    void dense_layer_int8_scalar(const int8_t *weights,
+                                 unsigned int rows,
+                                 unsigned int columns,
+                                 unsigned int stride,
+                                 const int8_t *input,
+                                 int32_t *output)
+    {
+        for (unsigned int j = 0; j < rows; j++) {
+            const int8_t *row = weights + static_cast<size_t>(j) * stride;
+            int32_t value = 0;
+            for (unsigned int k = 0; k < columns; k++) {
+                value += static_cast<int32_t>(row[k]) * input[k];
+            }
+            output[j] = value;
+        }
+    }
+
+#ifdef LAYERKERNEL_X86
+    // SSE2 is part of the x86-64 baseline, so no target attribute
+    // is needed here.
+    void dense_layer_sse2(const double *weights,
+                          unsigned int rows,
+                          unsigned int columns,
+                          unsigned int stride,
+                          const double *input,
+                          const double *bias,
+                          double *output)
+    {
+        unsigned int vectorColumns = columns & ~1u;
+        for (unsigned int j = 0; j < rows; j++) {
+            const double *row = weights + static_cast<size_t>(j) * stride;
+            __m128d sum = _mm_setzero_pd();
+            unsigned int k = 0;
+            for (; k < vectorColumns; k += 2) {
+                __m128d w = _mm_load_pd(row + k);
+                __m128d x = _mm_loadu_pd(input + k);
+                sum = _mm_add_pd(sum, _mm_mul_pd(w, x));
+            }
+            double lanes[2];
+            _mm_storeu_pd(lanes, sum);
+            double value = bias[j] + lanes[0] + lanes[1];
+            for (; k < columns; k++) {
+                value += row[k] * input[k];
+            }
+            output[j] = value;
+        }
+    }
+
+    void dense_layer_sse2(const float *weights,
+                          unsigned int rows,
+                          unsigned int columns,
+                          unsigned int stride,
+                          const float *input,
+                          const float *bias,
+                          float *output)
+    {
+        unsigned int vectorColumns = columns & ~3u;
+        for (unsigned int j = 0; j < rows; j++) {
+            const float *row = weights + static_cast<size_t>(j) * stride;
+            __m128 sum = _mm_setzero_ps();
+            unsigned int k = 0;
+            for (; k < vectorColumns; k += 4) {
+                __m128 w = _mm_load_ps(row + k);
+                __m128 x = _mm_loadu_ps(input + k);
+                sum = _mm_add_ps(sum, _mm_mul_ps(w, x));
+            }
+            float lanes[4];
+            _mm_storeu_ps(lanes, sum);
+            float value = bias[j] + (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+            for (; k < columns; k++) {
+                value += row[k] * input[k];
+            }
+            output[j] = value;
+        }
+    }
+
+    __attribute__((target("avx2,fma")))
+    void dense_layer_avx2(const double *weights,
+                          unsigned int rows,
+                          unsigned int columns,
+                          unsigned int stride,
+                          const double *input,
+                          const double *bias,
+                          double *output)
+    {
+        unsigned int vectorColumns = columns & ~3u;
+        for (unsigned int j = 0; j < rows; j++) {
+            const double *row = weights + static_cast<size_t>(j) * stride;
+            __m256d sum = _mm256_setzero_pd();
+            unsigned int k = 0;
+            for (; k < vectorColumns; k += 4) {
+                __m256d w = _mm256_load_pd(row + k);
+                __m256d x = _mm256_loadu_pd(input + k);
+                sum = _mm256_fmadd_pd(w, x, sum);
+            }
+            __m128d half = _mm_add_pd(_mm256_castpd256_pd128(sum),
+                                      _mm256_extractf128_pd(sum, 1));
+            double lanes[2];
+            _mm_storeu_pd(lanes, half);
+            double value = bias[j] + lanes[0] + lanes[1];
+            for (; k < columns; k++) {
+                value += row[k] * input[k];
+            }
+            output[j] = value;
+        }
+    }
+
+    __attribute__((target("avx2,fma")))
+    void dense_layer_avx2(const float *weights,
+                          unsigned int rows,
+                          unsigned int columns,
+                          unsigned int stride,
+                          const float *input,
+                          const float *bias,
+                          float *output)
+    {
+        unsigned int vectorColumns = columns & ~7u;
+        for (unsigned int j = 0; j < rows; j++) {
+            const float *row = weights + static_cast<size_t>(j) * stride;
+            __m256 sum = _mm256_setzero_ps();
+            unsigned int k = 0;
+            for (; k < vectorColumns; k += 8) {
+                __m256 w = _mm256_load_ps(row + k);
+                __m256 x = _mm256_loadu_ps(input + k);
+                sum = _mm256_fmadd_ps(w, x, sum);
+            }
+            __m128 half = _mm_add_ps(_mm256_castps256_ps128(sum),
+                                     _mm256_extractf128_ps(sum, 1));
+            float lanes[4];
+            _mm_storeu_ps(lanes, half);
+            float value = bias[j] + (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+            for (; k < columns; k++) {
+                value += row[k] * input[k];
+            }
+            output[j] = value;
+        }
+    }
+    // Both SSE2 and AVX2 widen 8-bit values to 16 bits and let
+    // madd multiply the pairs and sum them into 32-bit lanes.
+    void dense_layer_int8_sse2(const int8_t *weights,
+                               unsigned int rows,
+                               unsigned int columns,
+                               unsigned int stride,
+                               const int8_t *input,
+                               int32_t *output)
+    {
+        unsigned int vectorColumns = columns & ~15u;
+        for (unsigned int j = 0; j < rows; j++) {
+            const int8_t *row = weights + static_cast<size_t>(j) * stride;
+            __m128i sum = _mm_setzero_si128();
+            unsigned int k = 0;
+            for (; k < vectorColumns; k += 16) {
+                __m128i w = _mm_load_si128(
+                            reinterpret_cast<const __m128i*>(row + k));
+                __m128i x = _mm_loadu_si128(
+                            reinterpret_cast<const __m128i*>(input + k));
+                __m128i wLow = _mm_srai_epi16(_mm_unpacklo_epi8(w, w), 8);
+                __m128i wHigh = _mm_srai_epi16(_mm_unpackhi_epi8(w, w), 8);
+                __m128i xLow = _mm_srai_epi16(_mm_unpacklo_epi8(x, x), 8);
+                __m128i xHigh = _mm_srai_epi16(_mm_unpackhi_epi8(x, x), 8);
+                sum = _mm_add_epi32(sum, _mm_madd_epi16(wLow, xLow));
+                sum = _mm_add_epi32(sum, _mm_madd_epi16(wHigh, xHigh));
+            }
+            int32_t lanes[4];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), sum);
+            int32_t value = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+            for (; k < columns; k++) {
+                value += static_cast<int32_t>(row[k]) * input[k];
+            }
+            output[j] = value;
+        }
+    }
+
+    __attribute__((target("avx2")))
+    void dense_layer_int8_avx2(const int8_t *weights,
+                               unsigned int rows,
+                               unsigned int columns,
+                               unsigned int stride,
+                               const int8_t *input,
+                               int32_t *output)
+    {
+        unsigned int vectorColumns = columns & ~15u;
+        for (unsigned int j = 0; j < rows; j++) {
+            const int8_t *row = weights + static_cast<size_t>(j) * stride;
+            __m256i sum = _mm256_setzero_si256();
+            unsigned int k = 0;
+            for (; k < vectorColumns; k += 16) {
+                __m256i w = _mm256_cvtepi8_epi16(_mm_load_si128(
+                            reinterpret_cast<const __m128i*>(row + k)));
+                __m256i x = _mm256_cvtepi8_epi16(_mm_loadu_si128(
+                            reinterpret_cast<const __m128i*>(input + k)));
+                sum = _mm256_add_epi32(sum, _mm256_madd_epi16(w, x));
+            }
+            __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum),
+                                         _mm256_extracti128_si256(sum, 1));
+            int32_t lanes[4];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), half);
+            int32_t value = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+            for (; k < columns; k++) {
+                value += static_cast<int32_t>(row[k]) * input[k];
+            }
+            output[j] = value;
+        }
+    }
+#endif
+
+    bool kernel_supported(kernel_type type)
+    {
+        switch(type) {
+        case KERNEL_SCALAR:
+            return true;
+#ifdef LAYERKERNEL_X86
+        case KERNEL_SSE2:
+            return true;
+        case KERNEL_AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2")
+                    && __builtin_cpu_supports("fma");
+#else
+        case KERNEL_SSE2:
+            return false;
+        case KERNEL_AVX2:
+            return false;
+#endif
+        }
+        return false;
+    }
+
+    template <typename T>
+    kernel_function<T> kernel_for(kernel_type type)
+    {
+        switch(type) {
+#ifdef LAYERKERNEL_X86
+        case KERNEL_AVX2:
+            return dense_layer_avx2;
+        case KERNEL_SSE2:
+            return dense_layer_sse2;
+#endif
+        default:
+            return dense_layer_scalar<T>;
+        }
+    }
+
+    int8_kernel_function int8_kernel_for(kernel_type type)
+    {
+        switch(type) {
+#ifdef LAYERKERNEL_X86
+        case KERNEL_AVX2:
+            return dense_layer_int8_avx2;
+        case KERNEL_SSE2:
+            return dense_layer_int8_sse2;
+#endif
+        default:
+            return dense_layer_int8_scalar;
+        }
+    }
+
+    kernel_type active_type = detect_kernel();
+    kernel_function<double> active_kernel = kernel_for<double>(active_type);
+    kernel_function<float> active_kernel_float = kernel_for<float>(active_type);
+    int8_kernel_function active_kernel_int8 = int8_kernel_for(active_type);
+}
+
+kernel_type detect_kernel()
+{
+    if (kernel_supported(KERNEL_AVX2)) return KERNEL_AVX2;
+    if (kernel_supported(KERNEL_SSE2)) return KERNEL_SSE2;
+    return KERNEL_SCALAR;
+}
+
+void set_kernel(kernel_type type)
+{
+    if (!kernel_supported(type)) type = detect_kernel();
+    active_type = type;
+    active_kernel = kernel_for<double>(type);
+    active_kernel_float = kernel_for<float>(type);
+    active_kernel_int8 = int8_kernel_for(type);
+}
+
+kernel_type get_kernel()
+{
+    return active_type;
+}
+
+void dense_layer(const double *weights,
+                 unsigned int rows,
+                 unsigned int columns,
+                 unsigned int stride,
+                 const double *input,
+                 const double *bias,
+                 double *output)
+{
+    active_kernel(weights, rows, columns, stride, input, bias, output);
+}
+
+void dense_layer(const float *weights,
+                 unsigned int rows,
+                 unsigned int columns,
+                 unsigned int stride,
+                 const float *input,
+                 const float *bias,
+                 float *output)
+{
+    active_kernel_float(weights, rows, columns, stride, input, bias, output);
+}
+
+void dense_layer_int8(const int8_t *weights,
+                      unsigned int rows,
+                      unsigned int columns,
+                      unsigned int stride,
+                      const int8_t *input,
+                      int32_t *output)
+{
+    active_kernel_int8(weights, rows, columns, stride, input, output);
+}
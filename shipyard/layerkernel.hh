@@ -0,0 +1,125 @@
+#ifndef LAYERKERNEL_HH
+#define LAYERKERNEL_HH
+
+#include <cstdint>
+
+/*!
+ * \file layerkernel.hh
+ * \brief Dense layer kernels (matrix-vector product plus biases) used
+ * by the Neural Networks. The fastest kernel supported by the CPU is
+ * selected at runtime.
+ * \author terratenff
+ */
+
+/*!
+ * \enum kernel_type
+ * \brief Enums that represent the available dense layer kernels.
+ * \author terratenff
+ */
+enum kernel_type {
+    KERNEL_SCALAR,
+    KERNEL_SSE2,
+    KERNEL_AVX2
+};
+
+/*!
+ * \var KERNEL_TOLERANCE
+ * \brief Vectorized kernels sum the products in a different order
+ * than the scalar kernel (and AVX2 fuses multiply and add), so the
+ * results are not bit-identical. For every neuron the difference to
+ * the scalar kernel stays below KERNEL_TOLERANCE * (|bias| + sum of
+ * |weight * input|).
+ */
+const double KERNEL_TOLERANCE = 1e-12;
+
+/*!
+ * \var KERNEL_TOLERANCE_FLOAT
+ * \brief Same as KERNEL_TOLERANCE, for the single precision kernels.
+ */
+const float KERNEL_TOLERANCE_FLOAT = 1e-5f;
+
+/*!
+ * \fn detect_kernel
+ * \brief Checks which kernels the CPU supports.
+ * \return The fastest kernel that can be used.
+ */
+kernel_type detect_kernel();
+
+/*!
+ * \fn set_kernel
+ * \brief Overrides the kernel used by dense_layer. Mostly useful
+ * for comparing kernels against one another.
+ * \param type Target kernel. If the CPU does not support it, the
+ * fastest supported kernel is used instead.
+ */
+void set_kernel(kernel_type type);
+
+/*!
+ * \fn get_kernel
+ * \brief Getter for the kernel currently used by dense_layer.
+ * \return Kernel in use.
+ */
+kernel_type get_kernel();
+
+/*!
+ * \fn dense_layer
+ * \brief Computes output[j] = bias[j] + sum(weights[j][k] * input[k])
+ * for every row j of a weight block.
+ * \param weights First weight of the block. Rows must start on
+ * 32-byte boundaries.
+ * \param rows Number of rows (output neurons).
+ * \param columns Number of columns (input neurons).
+ * \param stride Distance between two consecutive rows.
+ * \param input Input neurons, at least "columns" of them.
+ * \param bias Bias of each output neuron, at least "rows" of them.
+ * \param output Output neurons, at least "rows" of them.
+ */
+void dense_layer(const double *weights,
+                 unsigned int rows,
+                 unsigned int columns,
+                 unsigned int stride,
+                 const double *input,
+                 const double *bias,
+                 double *output);
+
+/*!
+ * \fn dense_layer
+ * \brief Single precision version of the dense layer kernel.
+ * \param weights First weight of the block. Rows must start on
+ * 32-byte boundaries.
+ * \param rows Number of rows (output neurons).
+ * \param columns Number of columns (input neurons).
+ * \param stride Distance between two consecutive rows.
+ * \param input Input neurons, at least "columns" of them.
+ * \param bias Bias of each output neuron, at least "rows" of them.
+ * \param output Output neurons, at least "rows" of them.
+ */
+void dense_layer(const float *weights,
+                 unsigned int rows,
+                 unsigned int columns,
+                 unsigned int stride,
+                 const float *input,
+                 const float *bias,
+                 float *output);
+
+/*!
+ * \fn dense_layer_int8
+ * \brief Integer version of the dense layer kernel. Computes
+ * output[j] = sum(weights[j][k] * input[k]) with 32-bit accumulation
+ * and no bias, which is exact as long as the sum fits into 32 bits.
+ * \param weights First weight of the block. Rows must start on
+ * 32-byte boundaries.
+ * \param rows Number of rows (output neurons).
+ * \param columns Number of columns (input neurons).
+ * \param stride Distance between two consecutive rows.
+ * \param input Input neurons, at least "columns" of them.
+ * \param output Output accumulators, at least "rows" of them.
+ */
+void dense_layer_int8(const int8_t *weights,
+                      unsigned int rows,
+                      unsigned int columns,
+                      unsigned int stride,
+                      const int8_t *input,
+                      int32_t *output);
+
+#endif // LAYERKERNEL_HH
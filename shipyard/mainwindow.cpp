@@ -1,9 +1,11 @@
 #include "mainwindow.hh"
 #include "ui_mainwindow.h"
+#include "exporter.hh"
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QDebug>
 #include <QDir>
+#include <QFileInfo>
 
 MainWindow::MainWindow(QWidget *parent) :
     QMainWindow(parent),
@@ -24,6 +26,10 @@ MainWindow::MainWindow(QWidget *parent) :
                      SIGNAL(triggered()),
                      this,
                      SLOT(fileSaveScenario()));
+    QObject::connect(ui->actionExport,
+                     SIGNAL(triggered()),
+                     this,
+                     SLOT(fileExportNetwork()));
     QObject::connect(ui->actionExit,
                      SIGNAL(triggered()),
                      this,
@@ -48,7 +54,9 @@ MainWindow::MainWindow(QWidget *parent) :
     settings_ = Settings::get_settings();
     scenario_ = new Scenario(settings_);
     scene_ = new QGraphicsScene();
-    manager_ = new Manager(settings_, scene_, rand_);
+    manager_ = new Manager(settings_, rand_);
+    observer_ = new SceneObserver(scene_);
+    manager_->set_observer(observer_);
 
     target_ = new Target(scene_, PRIMARY);
     mousePoint_ = new Target(scene_, MOUSE_POINT);
@@ -160,6 +168,7 @@ MainWindow::~MainWindow()
 {
     delete settings_;
     delete manager_;
+    delete observer_;
     delete scene_;
     delete timer_;
     delete ui;
@@ -264,8 +273,13 @@ void MainWindow::setControls()
     ui->sliderInstance->setValue(instance);
     ui->sliderOffspring->setValue(offspring);
     ui->sliderTime->setValue(time);
-    ui->sliderHiddenLayer->setValue(hiddenLayer);
-    ui->sliderHiddenNeuron->setValue(hiddenNeuron);
+    {
+        // Showing the counts must not clear the widths of a scenario.
+        QSignalBlocker layerBlocker(ui->sliderHiddenLayer);
+        QSignalBlocker neuronBlocker(ui->sliderHiddenNeuron);
+        ui->sliderHiddenLayer->setValue(hiddenLayer);
+        ui->sliderHiddenNeuron->setValue(hiddenNeuron);
+    }
     ui->sliderBias->setValue(initialBias);
     ui->labelInstanceCount->setText(QString::number(instance));
     ui->labelOffspringCount->setText(QString::number(offspring));
@@ -389,13 +403,17 @@ void MainWindow::timeChanged(int change)
 
 void MainWindow::hiddenLayerChanged(int change)
 {
+    // The sliders shape every hidden layer alike, which a width list
+    // of a loaded scenario would override.
     settings_->set_hidden_layer_count(static_cast<unsigned>(change));
+    settings_->set_hidden_layer_widths({});
     ui->labelHiddenLayerCount->setText(QString::number(change));
 }
 
 void MainWindow::hiddenNeuronChanged(int change)
 {
     settings_->set_hidden_neuron_count(static_cast<unsigned>(change));
+    settings_->set_hidden_layer_widths({});
     ui->labelHiddenNeuronCount->setText(QString::number(change));
 }
 
@@ -553,6 +571,44 @@ void MainWindow::fileSaveScenario()
     scenario_->save_scenario(filename.toStdString());
 }
 
+void MainWindow::fileExportNetwork()
+{
+    const NeuralNetwork *best = manager_->get_best_network();
+    if (best == nullptr) {
+        QMessageBox msgBox;
+        msgBox.setWindowTitle("Neural Networks Demonstrator");
+        msgBox.setIcon(QMessageBox::Information);
+        msgBox.setText("There is no neural network to export.");
+        msgBox.setInformativeText("Run a simulation first.");
+        msgBox.setStandardButtons(QMessageBox::Ok);
+        msgBox.setDefaultButton(QMessageBox::Ok);
+        msgBox.exec();
+        return;
+    }
+
+    QString filename = QFileDialog::getSaveFileName(
+                this,
+                tr("Export Network"),
+                QDir::homePath() + "/desktop",
+                tr("C++ Header Files (*.hh *.h)")
+    );
+    if (filename.isEmpty()) return;
+    std::string name = QFileInfo(filename).completeBaseName().toStdString();
+    int outcome = Exporter::save_inference_header(*best,
+                                                  filename.toStdString(),
+                                                  name);
+    if (outcome > 0) {
+        QMessageBox msgBox;
+        msgBox.setWindowTitle("Neural Networks Demonstrator");
+        msgBox.setIcon(QMessageBox::Critical);
+        msgBox.setText("Could not open file.");
+        msgBox.setInformativeText("Something prevented the opening of selected file.");
+        msgBox.setStandardButtons(QMessageBox::Ok);
+        msgBox.setDefaultButton(QMessageBox::Ok);
+        msgBox.exec();
+    }
+}
+
 void MainWindow::fileExit()
 {
     this->close();
@@ -14,6 +14,7 @@
 #include "settings.hh"
 #include "scenario.hh"
 #include "manager.hh"
+#include "sceneobserver.hh"
 #include "target.hh"
 
 namespace Ui {
@@ -133,6 +134,12 @@ private:
      */
     Manager *manager_;
 
+    /*!
+     * \var observer_
+     * \brief Draws the subjects of the simulation onto the scene.
+     */
+    SceneObserver *observer_;
+
     /*!
      * \var target_
      * \brief Player's Ship.
@@ -269,6 +276,13 @@ private slots:
      */
     void fileSaveScenario();
 
+    /*!
+     * \fn fileExportNetwork
+     * \brief Functionality for when the menu button for exporting
+     * the best neural network as a C++ header is clicked.
+     */
+    void fileExportNetwork();
+
     /*!
      * \fn fileExit
      * \brief Functionality for when the menu button for exiting
@@ -1,10 +1,20 @@
 #include "manager.hh"
+#include <chrono>
 
-Manager::Manager(Settings *settings,
-                 QGraphicsScene *scene,
-                 Random &rand):
+namespace
+{
+    typedef std::chrono::steady_clock clock_type;
+
+    double seconds_since(clock_type::time_point start)
+    {
+        return std::chrono::duration<double>(clock_type::now() - start)
+                .count();
+    }
+}
+
+Manager::Manager(Settings *settings, Random &rand):
     settings_(settings),
-    scene_(scene),
+    observer_(nullptr),
     rand_(rand),
     random_point_(0,0)
 {
@@ -13,6 +23,17 @@ Manager::Manager(Settings *settings,
     tertiaryTarget_ = nullptr;
     mousePoint_ = nullptr;
     adversary_ = nullptr;
+    response_table_error_ = 0;
+}
+
+Manager::~Manager()
+{
+    clear_subjects();
+}
+
+void Manager::set_observer(SimulationObserver *observer)
+{
+    observer_ = observer;
 }
 
 void Manager::initialize(SubjectCore *p,
@@ -35,21 +56,20 @@ void Manager::initialize(SubjectCore *p,
     unsigned int instances = settings_->get_instance_count();
 
     // Initialize neural networks.
-    for (unsigned int i = 0; i < instances; i++) {
-        NeuralNetwork *nn = new NeuralNetwork(settings_, rand_);
-        nn->mutate();
-        networks_.push_back(nn);
-    }
+    pool_.initialize(settings_, rand_, instances);
+    networks_ = pool_.getNetworks();
 
     // Initialize subjects.
     for (unsigned int i = 0; i < instances; i++) {
-        Subject *subject = new Subject(scene_);
-        subject->setNeuralNetwork(networks_[i]);
-        set_subject_parameters(subject);
-        subject->update();
-        subjects_.push_back(subject);
+        subjects_.push_back(new SubjectCore());
     }
 
+    set_thread_count();
+    workers_.resetStatistics();
+    start_subjects(false);
+    engine_.pack(networks_);
+    if (observer_ != nullptr) observer_->subjectsCreated(subjects_);
+
     generation_count_ = 1;
     iteration_count_ = 0;
     iteration_max_ = settings_->get_iteration_count();
@@ -57,10 +77,19 @@ void Manager::initialize(SubjectCore *p,
 
 void Manager::update()
 {
-    // Update each subject.
-    for (Subject *subject : subjects_) {
-        subject->update();
-    }
+    // Update the subjects a chunk at a time. Chunks are cut the same
+    // way for any number of threads and share no memory, so the
+    // outcome does not depend on which thread updates which chunk.
+    set_thread_count();
+    unsigned int count = static_cast<unsigned int>(subjects_.size());
+    unsigned int chunk = engine_.getChunkSize();
+    unsigned int chunkCount = (count + chunk - 1) / chunk;
+    active_.assign(count, 0);
+    workers_.run(chunkCount, [this, chunk, count](unsigned int c,
+                                                 unsigned int worker) {
+        unsigned int last = (c + 1) * chunk;
+        update_chunk(c * chunk, last < count ? last : count, worker);
+    });
 
     ++iteration_count_;
 
@@ -80,6 +109,13 @@ void Manager::update()
 
         // Sort networks in descending order fitness-wise.
         sort_networks();
+        if (observer_ != nullptr) {
+            observer_->generationFinished(generation_count_ - 1, networks_);
+        }
+
+        TransitionTiming timing;
+        timing.generation = generation_count_ - 1;
+        clock_type::time_point start = clock_type::now();
 
         // Select the most fit subjects into the next generation.
         std::vector<int> topSubjects =
@@ -105,72 +141,52 @@ void Manager::update()
                                   topSubjects,
                                   retentionSubjects);
 
-        // Creating the children one by one via selected crossover function.
-        unsigned int j = 0;
-        for (unsigned int i = population - offspringCount; i < population; i++) {
-            if (std::find(retentionSubjects.begin(), retentionSubjects.end(), i) != retentionSubjects.end()) {
-                // Skip subjects that were selected via population retention.
-                continue;
-            }
-
-            switch(breedingMethod) {
-            case COPY:
-            {
-                unsigned int slot = static_cast<unsigned int>(breeders[j][0]);
-                networks_[i] = new NeuralNetwork(*networks_[slot]);
-                break;
-            }
-            case HEAVILY_MUTATED_COPY:
-            {
-                unsigned int slot = static_cast<unsigned int>(breeders[j][0]);
-                networks_[i] = new NeuralNetwork(*networks_[slot], true);
-                break;
-            }
-            case CHILD_OF_TWO:
-            {
-                unsigned int slot1 = static_cast<unsigned int>(breeders[j][0]);
-                unsigned int slot2 = static_cast<unsigned int>(breeders[j][1]);
-                networks_[i] = new NeuralNetwork(*networks_[slot1],
-                                                 *networks_[slot2]);
-                break;
-            }
-            case CHILD_OF_THREE:
-            {
-                unsigned int slot1 = static_cast<unsigned int>(breeders[j][0]);
-                unsigned int slot2 = static_cast<unsigned int>(breeders[j][1]);
-                unsigned int slot3 = static_cast<unsigned int>(breeders[j][2]);
-                networks_[i] = new NeuralNetwork(*networks_[slot1],
-                                                 *networks_[slot2],
-                                                 *networks_[slot3]);
-                break;
-            }
-            case NO_BREEDING:
-            {
-                // Default crossover function: Copy
-                unsigned int slot = static_cast<unsigned int>(breeders[j][0]);
-                networks_[i] = new NeuralNetwork(*networks_[slot]);
-                break;
-            }
-            }
+        timing.selection = seconds_since(start);
+        clock_type::time_point stage = clock_type::now();
 
-            // Mutate upon creation.
-            networks_[i]->mutate();
+        // Children are written over the networks that did not make it
+        // into the next generation. Subjects selected via population
+        // retention are skipped.
+        std::vector<unsigned int> children;
+        for (unsigned int i = population - offspringCount; i < population; i++) {
+            bool retained = std::find(retentionSubjects.begin(),
+                                      retentionSubjects.end(),
+                                      i) != retentionSubjects.end();
+            if (!retained) children.push_back(i);
+        }
 
+        // Each child draws from a random stream of its own, seeded in
+        // order, so that it comes out the same on any thread.
+        std::vector<unsigned int> seeds(children.size());
+        for (unsigned int &seed : seeds) {
+            seed = static_cast<unsigned int>(rand_.random_bits());
+        }
+        workers_.run(static_cast<unsigned int>(children.size()),
+                     [&](unsigned int j, unsigned int worker) {
+            Random &rand = *streams_[worker];
+            rand.seed(seeds[j]);
+            breed_child(children[j], breedingMethod, breeders[j], rand);
+        });
+
+        // Survivors start the next generation with cleared neurons.
+        for (unsigned int j = 0; j < children.size(); j++) {
             if (j < population - offspringCount) {
                 networks_[j]->resetNeurons();
             }
-            ++j;
         }
+        timing.breeding = seconds_since(stage);
+        stage = clock_type::now();
 
         // Recreate subjects now that neural networks for next generation
         // have been set.
-        for (unsigned int i = 0; i < population; i++) {
-            Subject *subject = subjects_[i];
-            subject->setNeuralNetwork(networks_[i]);
-            set_subject_parameters(subject);
-            subject->update();
-        }
+        start_subjects(true);
+        engine_.pack(networks_);
+        timing.restart = seconds_since(stage);
+        timing.total = seconds_since(start);
+        if (observer_ != nullptr) observer_->transitionFinished(timing);
     }
+
+    if (observer_ != nullptr) observer_->subjectsUpdated(subjects_);
 }
 
 unsigned int Manager::get_generation_count()
@@ -193,14 +209,158 @@ void Manager::skip_generation()
     iteration_count_ = iteration_max_;
 }
 
+double Manager::get_response_table_error()
+{
+    return response_table_error_;
+}
+
+std::vector<WorkerStatistics> Manager::get_worker_statistics() const
+{
+    return workers_.getStatistics();
+}
+
+const NeuralNetwork *Manager::get_best_network() const
+{
+    // Scans for the highest fitness. Fitness is reset when a generation
+    // starts, so mid-generation this is the fitness gathered so far.
+    const NeuralNetwork *best = nullptr;
+    for (NeuralNetwork *nn : networks_) {
+        if (best == nullptr || nn->getFitness() > best->getFitness()) {
+            best = nn;
+        }
+    }
+    return best;
+}
+
+void Manager::update_chunk(unsigned int first,
+                           unsigned int last,
+                           unsigned int worker)
+{
+    // Move the subjects and collect their inputs, evaluate their
+    // networks at once and hand the outputs back.
+    for (unsigned int i = first; i < last; i++) {
+        active_[i] = subjects_[i]->prepareUpdate();
+        if (active_[i]) engine_.setInputs(i, subjects_[i]->getInputs());
+    }
+
+    engine_.run(first, last, worker);
+
+    unsigned int outputCount = engine_.getOutputCount();
+    for (unsigned int i = first; i < last; i++) {
+        if (active_[i]) {
+            subjects_[i]->finishUpdate(engine_.getOutputs(i), outputCount);
+        }
+    }
+}
+
+void Manager::start_subjects(bool prune)
+{
+    // Each subject draws its starting parameters from a random stream
+    // of its own, seeded in order, so that it starts out the same on
+    // any thread.
+    unsigned int count = static_cast<unsigned int>(subjects_.size());
+    std::vector<unsigned int> seeds(count);
+    for (unsigned int &seed : seeds) {
+        seed = static_cast<unsigned int>(rand_.random_bits());
+    }
+    table_errors_.assign(count, 0);
+    workers_.run(count, [&](unsigned int i, unsigned int worker) {
+        Random &rand = *streams_[worker];
+        rand.seed(seeds[i]);
+        start_subject(i, prune, rand);
+    });
+
+    response_table_error_ = 0;
+    for (double error : table_errors_) {
+        if (error > response_table_error_) response_table_error_ = error;
+    }
+}
+
+void Manager::start_subject(unsigned int i, bool prune, Random &rand)
+{
+    // Weights that evolution has driven close to zero are cut off, so
+    // that the networks can get sparser over time.
+    if (prune) networks_[i]->prune();
+
+    subjects_[i]->setNeuralNetwork(networks_[i]);
+    set_subject_parameters(subjects_[i], rand);
+    subjects_[i]->update();
+    table_errors_[i] = networks_[i]->compileResponseTable();
+}
+
+void Manager::breed_child(unsigned int child,
+                          breeding_type method,
+                          const std::vector<int> &parents,
+                          Random &rand)
+{
+    switch(method) {
+    case COPY:
+    {
+        unsigned int slot = static_cast<unsigned int>(parents[0]);
+        networks_[child]->copyFrom(*networks_[slot], false, rand);
+        break;
+    }
+    case HEAVILY_MUTATED_COPY:
+    {
+        unsigned int slot = static_cast<unsigned int>(parents[0]);
+        networks_[child]->copyFrom(*networks_[slot], true, rand);
+        break;
+    }
+    case CHILD_OF_TWO:
+    {
+        unsigned int slot1 = static_cast<unsigned int>(parents[0]);
+        unsigned int slot2 = static_cast<unsigned int>(parents[1]);
+        networks_[child]->breedFrom(*networks_[slot1],
+                                    *networks_[slot2],
+                                    rand);
+        break;
+    }
+    case CHILD_OF_THREE:
+    {
+        unsigned int slot1 = static_cast<unsigned int>(parents[0]);
+        unsigned int slot2 = static_cast<unsigned int>(parents[1]);
+        unsigned int slot3 = static_cast<unsigned int>(parents[2]);
+        networks_[child]->breedFrom(*networks_[slot1],
+                                    *networks_[slot2],
+                                    *networks_[slot3],
+                                    rand);
+        break;
+    }
+    case NO_BREEDING:
+    {
+        // Default crossover function: Copy
+        unsigned int slot = static_cast<unsigned int>(parents[0]);
+        networks_[child]->copyFrom(*networks_[slot], false, rand);
+        break;
+    }
+    }
+
+    // Mutate upon creation.
+    networks_[child]->mutate(rand);
+}
+
+void Manager::set_thread_count()
+{
+    workers_.setThreadCount(settings_->get_thread_count());
+    unsigned int threads = workers_.getThreadCount();
+    engine_.setWorkerCount(threads);
+    while (streams_.size() < threads) {
+        streams_.emplace_back(new Random(0));
+    }
+}
+
 void Manager::clear_subjects()
 {
+    if (observer_ != nullptr && !subjects_.empty()) {
+        observer_->subjectsCleared();
+    }
     for (auto subject : subjects_)
     {
         delete subject;
     }
     subjects_.clear();
     networks_.clear();
+    pool_.clear();
 }
 
 void Manager::sort_networks()
@@ -208,10 +368,11 @@ void Manager::sort_networks()
     std::sort(networks_.begin(), networks_.end(), NeuralNetwork::compare);
 }
 
-void Manager::set_subject_parameters(Subject *subject)
+void Manager::set_subject_parameters(SubjectCore *subject, Random &rand)
 {
+    // Biases evolve along with the weights, so the initial bias is
+    // only applied when the networks are created.
     subject->getNeuralNetwork()->setFitness(0);
-    subject->getNeuralNetwork()->setBias(static_cast<double>(settings_->get_initial_bias()) / 1000);
 
     // Setting spawn location.
     switch (settings_->get_spawn_location()) {
@@ -228,7 +389,7 @@ void Manager::set_subject_parameters(Subject *subject)
         subject->setCoordinates(random_point_);
         break;
     case SCATTERED:
-        subject->setCoordinates(rand_.random_coordinates());
+        subject->setCoordinates(rand.random_coordinates());
         break;
     case NO_SPAWN_POINT:
         // Default spawn point: Center.
@@ -237,7 +398,7 @@ void Manager::set_subject_parameters(Subject *subject)
     }
 
     // Movement parameters.
-    subject->setAngle(rand_.random_int(0,360));
+    subject->setAngle(rand.random_int(0,360));
     subject->setVelocity(settings_->get_velocity_initial());
     subject->setAcceleration(settings_->get_acceleration_initial());
     subject->setAngularVelocity(settings_->get_angular_velocity_initial());
@@ -2,14 +2,19 @@
 #define MANAGER_HH
 
 #include "settings.hh"
-#include "subject.hh"
-#include <QGraphicsScene>
+#include "subjectcore.hh"
+#include "simulationobserver.hh"
+#include "batchengine.hh"
+#include "networkpool.hh"
+#include "threadpool.hh"
+#include <memory>
 #include <vector>
 
 /*!
  * \class Manager
  * \brief Conducts a simulation (iterations of the neural networks
- * and the genetic algorithm) behind the scenes.
+ * and the genetic algorithm) behind the scenes. Needs no graphics:
+ * an observer can be set to follow the subjects.
  * \author terratenff
  */
 class Manager
@@ -19,13 +24,22 @@ public:
     /*!
      * \brief Creates an instance of a Manager that runs simulations.
      * \param settings Pointer to simulation settings.
-     * \param scene Pointer to a graphics scene (Manager creates the
-     * subjects that are to be seen in the graphics view).
      * \param rand Reference to a random number generating object.
      */
-    Manager(Settings *settings,
-            QGraphicsScene *scene,
-            Random &rand);
+    Manager(Settings *settings, Random &rand);
+
+    /*!
+     * \brief ~Manager Destructor. Deletes the subjects.
+     */
+    ~Manager();
+
+    /*!
+     * \fn set_observer
+     * \brief Setter for the observer of the subjects.
+     * \param observer Target observer, or nullptr for none. Not owned
+     * by the manager.
+     */
+    void set_observer(SimulationObserver *observer);
 
     /*!
      * \fn initialize
@@ -48,7 +62,9 @@ public:
     /*!
      * \fn update
      * \brief Updates the state of the simulation by one
-     * iteration.
+     * iteration. Subjects are updated in parallel chunks, with the
+     * same outcome for any number of threads (see
+     * Settings::set_thread_count).
      * \pre Simulation must be initialized.
      * \post One iteration is performed.
      */
@@ -90,8 +106,89 @@ public:
      * begin immediately.
      */
     void skip_generation();
+
+    /*!
+     * \fn get_response_table_error
+     * \brief Getter for the largest error of the response tables of
+     * current generation, i.e. how far the interpolated outputs of a
+     * network strayed from its true outputs.
+     * \return Largest error. 0, if response tables are not in use.
+     */
+    double get_response_table_error();
+
+    /*!
+     * \fn get_best_network
+     * \brief Getter for the neural network with the highest fitness
+     * value of current generation. At the start of a generation, this
+     * is the best network of the previous one.
+     * \return Best neural network, or nullptr if there are none.
+     */
+    const NeuralNetwork *get_best_network() const;
+
+    /*!
+     * \fn get_worker_statistics
+     * \brief Getter for the counters of the threads that run the
+     * simulation, since the simulation was initialized. Shows how
+     * evenly the work was spread over the threads.
+     * \return Counters of each thread.
+     */
+    std::vector<WorkerStatistics> get_worker_statistics() const;
 private:
 
+    /*!
+     * \fn update_chunk
+     * \brief Updates a range of subjects: moves them, evaluates
+     * their networks and applies the outputs.
+     * \param first Index of the first subject of the range.
+     * \param last Index past the last subject of the range.
+     * \param worker Number of the thread doing the update.
+     */
+    void update_chunk(unsigned int first,
+                      unsigned int last,
+                      unsigned int worker);
+
+    /*!
+     * \fn start_subjects
+     * \brief Gives every subject its network and starting
+     * parameters, and runs its first update. Networks are also
+     * sampled into their response tables, if response tables are in
+     * use, and the largest error is recorded.
+     * \param prune Whether the networks are pruned first.
+     */
+    void start_subjects(bool prune);
+
+    /*!
+     * \fn start_subject
+     * \brief Work of start_subjects() that is done for each subject
+     * on its own, on any thread.
+     * \param i Index of the subject.
+     * \param prune Whether the network is pruned first.
+     * \param rand Random number generator of the subject.
+     */
+    void start_subject(unsigned int i, bool prune, Random &rand);
+
+    /*!
+     * \fn breed_child
+     * \brief Writes a child of given parents over a network, and
+     * mutates it. Children can be bred on any thread, as long as
+     * none of them is a parent of another.
+     * \param child Index of the network to be written over.
+     * \param method Breeding method.
+     * \param parents Indexes of the parents.
+     * \param rand Random number generator of the child.
+     */
+    void breed_child(unsigned int child,
+                     breeding_type method,
+                     const std::vector<int> &parents,
+                     Random &rand);
+
+    /*!
+     * \fn set_thread_count
+     * \brief Applies the thread count of the settings to the
+     * threads, and gives every thread a random number generator.
+     */
+    void set_thread_count();
+
     /*!
      * \fn clear_subjects
      * \brief Deletes current list of subjects completely.
@@ -108,8 +205,9 @@ private:
      * \fn set_subject_parameters
      * \brief Configures a subject with application settings.
      * \param subject Target subject.
+     * \param rand Random number generator of the subject.
      */
-    void set_subject_parameters(Subject *subject);
+    void set_subject_parameters(SubjectCore *subject, Random &rand);
 
     /*!
      * \fn get_top_subjects
@@ -203,7 +301,7 @@ private:
      * \brief List of subjects. Acts as the population of the simulation.
      * \invariant Indexes should match with those of neural networks (networks_).
      */
-    std::vector<Subject*> subjects_;
+    std::vector<SubjectCore*> subjects_;
 
     /*!
      * \var networks_
@@ -213,10 +311,46 @@ private:
     std::vector<NeuralNetwork*> networks_;
 
     /*!
-     * \var scene_
-     * \brief Pointer to the graphics scene, situated in the main window.
+     * \var pool_
+     * \brief Owner of the neural networks. networks_ refers to the
+     * same networks, sorted by fitness.
+     */
+    NetworkPool pool_;
+
+    /*!
+     * \var engine_
+     * \brief Evaluates the networks of the whole population at once.
+     * \invariant Packed networks should match those of the subjects.
+     */
+    BatchEngine engine_;
+
+    /*!
+     * \var workers_
+     * \brief Threads that update the chunks of subjects.
+     */
+    ThreadPool workers_;
+
+    /*!
+     * \var streams_
+     * \brief Random number generator of each thread. Reseeded for
+     * every child and subject, so that random numbers do not depend
+     * on which thread draws them.
      */
-    QGraphicsScene *scene_;
+    std::vector<std::unique_ptr<Random>> streams_;
+
+    /*!
+     * \var active_
+     * \brief Subjects whose networks were evaluated during the current
+     * update. Kept as a member so that updates do not allocate memory.
+     * A byte per subject, so that threads can write them side by side.
+     */
+    std::vector<char> active_;
+
+    /*!
+     * \var observer_
+     * \brief Follows the subjects, e.g. to draw them. May be nullptr.
+     */
+    SimulationObserver *observer_;
 
     /*!
      * \var rand_
@@ -230,6 +364,20 @@ private:
      */
     unsigned int generation_count_;
 
+    /*!
+     * \var response_table_error_
+     * \brief Largest error of the response tables of current
+     * generation.
+     */
+    double response_table_error_;
+
+    /*!
+     * \var table_errors_
+     * \brief Error of the response table of each network, gathered
+     * by the threads before the largest one is picked.
+     */
+    std::vector<double> table_errors_;
+
     /*!
      * \var iteration_count_
      * \brief Keeps track of the current iteration of the current generation.
@@ -330,6 +330,24 @@ Random::Random():
 
 }
 
+Random::Random(unsigned int seed):
+    rd_(),
+    rng_(seed),
+    uni_(),
+    unif_(),
+    re_(seed)
+{
+
+}
+
+void Random::seed(unsigned int seed)
+{
+    rng_.seed(seed);
+    re_.seed(seed);
+    uni_.reset();
+    unif_.reset();
+}
+
 int Random::random_int(int min, int max)
 {
     int result = min + (uni_(rng_) % (max - min));
@@ -342,6 +360,13 @@ double Random::random_double(double min, double max)
     return result;
 }
 
+uint64_t Random::random_bits()
+{
+    uint64_t high = rng_();
+    uint64_t low = rng_();
+    return (high << 32) | low;
+}
+
 XY Random::random_coordinates(int x_min,
                               int x_max,
                               int y_min,
@@ -5,6 +5,7 @@
 #include <cmath>
 #include <algorithm>
 #include <random>
+#include <cstdint>
 
 using namespace std;
 
@@ -457,6 +458,23 @@ public:
      */
     Random();
 
+    /*!
+     * \brief Random number generator constructor for repeatable
+     * sequences of random numbers.
+     * \param seed Seed of the generator. Generators with the same
+     * seed produce the same numbers.
+     */
+    explicit Random(unsigned int seed);
+
+    /*!
+     * \fn seed
+     * \brief Restarts the generator from given seed, as if it had
+     * just been constructed with it. Cheaper than constructing a new
+     * generator.
+     * \param seed Seed of the generator.
+     */
+    void seed(unsigned int seed);
+
     /*!
      * \fn random_int
      * \brief Generates a random integer within given
@@ -477,6 +495,15 @@ public:
      */
     double random_double(double min, double max);
 
+    /*!
+     * \fn random_bits
+     * \brief Generates 64 random bits at once. Useful for making
+     * many random binary decisions with a single draw.
+     * \return Random 64-bit integer, every bit of which is equally
+     * likely to be 0 or 1.
+     */
+    uint64_t random_bits();
+
     /*!
      * \fn random_coordinates
      * \brief Generates random coordinates within given
@@ -0,0 +1,94 @@
+#include "mutation.hh"
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    // Top 8 bits of a draw pick the kind of mutation, the lowest 53
+    // bits form the random factor.
+    const unsigned int KIND_SHIFT = 56;
+    const unsigned int FRACTION_BITS = 53;
+
+    double unit_interval(uint64_t bits)
+    {
+        uint64_t fraction = bits & ((uint64_t(1) << FRACTION_BITS) - 1);
+        return std::ldexp(static_cast<double>(fraction),
+                          -static_cast<int>(FRACTION_BITS));
+    }
+
+    // Number of weights skipped before the next mutating one.
+    size_t next_gap(double logComplement, Random &rand)
+    {
+        // Uniform in (0, 1], so that the logarithm stays finite.
+        double u = unit_interval(rand.random_bits())
+                + std::ldexp(1.0, -static_cast<int>(FRACTION_BITS));
+        double gap = std::floor(std::log(u) / logComplement);
+        if (!(gap < static_cast<double>(std::numeric_limits<size_t>::max() / 2))) {
+            return std::numeric_limits<size_t>::max() / 2;
+        }
+        return static_cast<size_t>(gap);
+    }
+
+    double mutate_weight(double weight,
+                         double scaleMin,
+                         double scaleMax,
+                         uint64_t bits)
+    {
+        unsigned int kind = static_cast<unsigned int>(
+                    ((bits >> KIND_SHIFT) * MUTATION_KIND_COUNT) >> 8);
+        double u = unit_interval(bits);
+
+        switch(kind) {
+        case NEGATE_MUTATION:
+            return -weight;
+        case RESAMPLE_MUTATION:
+            return scaleMin + u * (scaleMax - scaleMin);
+        case SCALE_MUTATION:
+            return weight * (scaleMin + u * (scaleMax - scaleMin));
+        case GROW_MUTATION:
+            return weight * (1.0 + u);
+        default:
+            return weight * u;
+        }
+    }
+}
+
+size_t mutate_weights(WeightSet &weights,
+                      double probability,
+                      double scaleMin,
+                      double scaleMax,
+                      Random &rand)
+{
+    if (!(probability > 0)) return 0;
+
+    // With probability 1 every gap is 0.
+    double logComplement = probability < 1
+            ? std::log1p(-probability)
+            : -std::numeric_limits<double>::infinity();
+
+    size_t mutated = 0;
+    size_t next = next_gap(logComplement, rand);
+    for (unsigned int i = 0; i < weights.layerCount(); i++) {
+        unsigned int columns = weights.columns(i);
+        size_t weightCount = static_cast<size_t>(weights.rows(i)) * columns;
+        // Biases come after the weights of the block.
+        size_t blockSize = weightCount + weights.rows(i);
+        while (next < blockSize) {
+            // A shared group is copied only if one of its weights
+            // mutates.
+            double *weight;
+            if (next < weightCount) {
+                unsigned int row = static_cast<unsigned int>(next / columns);
+                weight = weights.mutableRow(i, row) + next % columns;
+            } else {
+                weight = weights.mutableBias(i) + (next - weightCount);
+            }
+            *weight = mutate_weight(*weight, scaleMin, scaleMax,
+                                    rand.random_bits());
+            ++mutated;
+            next += 1 + next_gap(logComplement, rand);
+        }
+        next -= blockSize;
+    }
+    return mutated;
+}
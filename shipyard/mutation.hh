@@ -0,0 +1,51 @@
+#ifndef MUTATION_HH
+#define MUTATION_HH
+
+#include "weightset.hh"
+
+/*!
+ * \file mutation.hh
+ * \brief Mutation of Neural Network weights.
+ *
+ * Instead of deciding separately for every weight whether it
+ * mutates, the distance to the next mutating weight is drawn from a
+ * geometric distribution. Only the mutating weights are visited,
+ * and each of them uses a single 64-bit draw for both the kind of
+ * mutation and its random factor. Groups of weights without mutating
+ * weights are left untouched, so they stay shared with any copies
+ * (see weightset.hh).
+ * \author terratenff
+ */
+
+/*!
+ * \enum mutation_kind
+ * \brief Enums that represent the ways in which a weight can mutate.
+ * \author terratenff
+ */
+enum mutation_kind {
+    NEGATE_MUTATION,    // w = -w
+    RESAMPLE_MUTATION,  // w = random [scale min, scale max)
+    SCALE_MUTATION,     // w *= random [scale min, scale max)
+    GROW_MUTATION,      // w *= random [1, 2)
+    SHRINK_MUTATION,    // w *= random [0, 1)
+    MUTATION_KIND_COUNT
+};
+
+/*!
+ * \fn mutate_weights
+ * \brief Mutates a random selection of weights. Biases mutate like
+ * any other weight. Padding is left untouched.
+ * \param weights Target weights.
+ * \param probability Probability of each weight to mutate, [0, 1].
+ * \param scaleMin Minimum mutation scale.
+ * \param scaleMax Maximum mutation scale.
+ * \param rand Random number generator.
+ * \return Number of mutated weights.
+ */
+size_t mutate_weights(WeightSet &weights,
+                      double probability,
+                      double scaleMin,
+                      double scaleMax,
+                      Random &rand);
+
+#endif // MUTATION_HH
@@ -0,0 +1,41 @@
+#include "networkpool.hh"
+
+NetworkPool::NetworkPool()
+{
+}
+
+NetworkPool::~NetworkPool()
+{
+    clear();
+}
+
+void NetworkPool::initialize(Settings *settings,
+                             Random &rand,
+                             unsigned int count)
+{
+    clear();
+    networks_.reserve(count);
+    for (unsigned int i = 0; i < count; i++) {
+        NeuralNetwork *nn = new NeuralNetwork(settings, rand);
+        nn->mutate();
+        networks_.push_back(nn);
+    }
+}
+
+void NetworkPool::clear()
+{
+    for (NeuralNetwork *nn : networks_) {
+        delete nn;
+    }
+    networks_.clear();
+}
+
+const std::vector<NeuralNetwork*> &NetworkPool::getNetworks() const
+{
+    return networks_;
+}
+
+unsigned int NetworkPool::size() const
+{
+    return static_cast<unsigned int>(networks_.size());
+}
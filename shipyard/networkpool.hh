@@ -0,0 +1,75 @@
+#ifndef NETWORKPOOL_HH
+#define NETWORKPOOL_HH
+
+#include "neuralnetwork.hh"
+#include <vector>
+
+/*!
+ * \class NetworkPool
+ * \brief Owns the Neural Networks of a simulation run.
+ *
+ * Networks are created once, when the run is initialized, and kept
+ * until the pool is cleared. Offspring of later generations are
+ * written into existing networks (see NeuralNetwork::copyFrom and
+ * NeuralNetwork::breedFrom), so memory use stays flat no matter how
+ * many generations are simulated.
+ *
+ * \author terratenff
+ */
+class NetworkPool
+{
+public:
+
+    /*!
+     * \brief Constructor for an empty pool.
+     */
+    NetworkPool();
+
+    /*!
+     * \brief Destructor. Deletes every network of the pool.
+     */
+    ~NetworkPool();
+
+    NetworkPool(const NetworkPool &) = delete;
+    NetworkPool &operator=(const NetworkPool &) = delete;
+
+    /*!
+     * \fn initialize
+     * \brief Replaces the contents of the pool with new, mutated
+     * Neural Networks.
+     * \param settings Settings for the networks.
+     * \param rand Random number generator.
+     * \param count Number of networks.
+     */
+    void initialize(Settings *settings, Random &rand, unsigned int count);
+
+    /*!
+     * \fn clear
+     * \brief Deletes every network of the pool.
+     */
+    void clear();
+
+    /*!
+     * \fn getNetworks
+     * \brief Getter for the networks of the pool, in order of
+     * creation.
+     * \return Networks owned by the pool.
+     */
+    const std::vector<NeuralNetwork*> &getNetworks() const;
+
+    /*!
+     * \fn size
+     * \brief Getter for the number of networks in the pool.
+     * \return Number of networks.
+     */
+    unsigned int size() const;
+private:
+
+    /*!
+     * \var networks_
+     * \brief Networks owned by the pool.
+     */
+    std::vector<NeuralNetwork*> networks_;
+};
+
+#endif // NETWORKPOOL_HH
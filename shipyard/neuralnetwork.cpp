@@ -1,10 +1,18 @@
 #include "neuralnetwork.hh"
+#include "layerkernel.hh"
+#include "crossover.hh"
+#include "mutation.hh"
+#include "encoding.hh"
+#include <algorithm>
+#include <cmath>
 
 NeuralNetwork::NeuralNetwork(Settings *settings, Random &rand):
     rand_(rand)
 {
     unsigned int hiddenLayers = settings->get_hidden_layer_count();
     unsigned int hiddenNeurons = settings->get_hidden_neuron_count();
+    const vector<unsigned int> &hiddenWidths =
+            settings->get_hidden_layer_widths();
     input_code_ = settings->get_input_type();
     output_code_ = settings->get_output_type();
     fitness_code_ = settings->get_fitness_type();
@@ -16,67 +24,30 @@ NeuralNetwork::NeuralNetwork(Settings *settings, Random &rand):
     mutation_probability_ = settings->get_mutation_probability();
     hidden_activation_ = settings->get_activation_function_hidden();
     output_activation_ = settings->get_activation_function_output();
-
-    switch(input_code_) {
-    case ANGULAR_DIFFERENCE:
-        layers_.push_back(1);
-        break;
-    case SPACE_TOTAL_DIFFERENCE:
-        layers_.push_back(1);
-        break;
-    case SPACE_AXIS_DIFFERENCE:
-        layers_.push_back(2);
-        break;
-    case WALL_DISTANCES:
-        layers_.push_back(4);
-        break;
-    case FOUR_WAY_SEARCH:
-        layers_.push_back(4);
-        break;
-    case FOUR_CORNER_SEARCH:
-        layers_.push_back(4);
-        break;
-    case NO_INPUT:
-        layers_.push_back(1);
-        break;
+    precision_ = settings->get_network_precision();
+    fast_math_ = settings->get_fast_math();
+    crossover_method_ = settings->get_crossover_method();
+    pruning_threshold_ = settings->get_pruning_threshold();
+    sparse_density_ = settings->get_sparse_density();
+    response_table_size_ = settings->get_response_table_size();
+    bias_ = static_cast<double>(settings->get_initial_bias()) / 1000;
+
+    layers_.push_back(Encoding::input_encoding(input_code_).arity);
+
+    if (hiddenWidths.empty()) {
+        for (unsigned int i = 0; i < hiddenLayers; i++) {
+            layers_.push_back(hiddenNeurons);
+        }
+    } else {
+        layers_.insert(layers_.end(), hiddenWidths.begin(), hiddenWidths.end());
     }
 
-    for (unsigned int i = 0; i < hiddenLayers; i++) {
-        layers_.push_back(hiddenNeurons);
-    }
-
-    switch(output_code_) {
-    case ANGULAR_VELOCITY:
-        layers_.push_back(1);
-        break;
-    case DIRECT_ANGLE:
-        layers_.push_back(1);
-        break;
-    case ANGLE_VELOCITY:
-        layers_.push_back(2);
-        break;
-    case ANGLE_ACCELERATION:
-        layers_.push_back(2);
-        break;
-    case AXIS_VELOCITY:
-        layers_.push_back(2);
-        break;
-    case AXIS_ACCELERATION:
-        layers_.push_back(2);
-        break;
-    case SMALL_HOPS:
-        layers_.push_back(2);
-        break;
-    case FIXED_MOVEMENT:
-        layers_.push_back(4);
-        break;
-    case NO_OUTPUT:
-        layers_.push_back(1);
-        break;
-    }
+    layers_.push_back(Encoding::output_encoding(output_code_).arity);
 
     initializeNeurons();
+    resolveActivations();
     initializeWeights();
+    updateInferenceWeights();
 
     fitness_ = 0;
 }
@@ -85,140 +56,256 @@ NeuralNetwork::NeuralNetwork(const NeuralNetwork &copy,
                              bool heavyMutation):
     rand_(copy.rand_)
 {
-    layers_ = copy.layers_;
-
-    input_code_ = copy.input_code_;
-    output_code_ = copy.output_code_;
-    fitness_code_ = copy.fitness_code_;
-
-    initial_weight_min_ = copy.initial_weight_min_;
-    initial_weight_max_ = copy.initial_weight_max_;
-    mutation_scale_min_ = copy.mutation_scale_min_;
-    mutation_scale_max_ = copy.mutation_scale_max_;
-    mutation_probability_ = copy.mutation_probability_;
-    hidden_activation_ = copy.hidden_activation_;
-    output_activation_ = copy.output_activation_;
-
-    initializeNeurons();
-    initializeWeights();
-    copyWeights(copy.weights_);
-
-    fitness_ = 0;
-
-    if (heavyMutation) mutate();
+    copyFrom(copy, heavyMutation);
 }
 
 NeuralNetwork::NeuralNetwork(const NeuralNetwork &nn1,
                              const NeuralNetwork &nn2):
     rand_(nn1.rand_)
 {
-    layers_ = nn1.layers_;
+    breedFrom(nn1, nn2);
+}
 
-    input_code_ = nn1.input_code_;
-    output_code_ = nn1.output_code_;
-    fitness_code_ = nn1.fitness_code_;
+NeuralNetwork::NeuralNetwork(const NeuralNetwork &nn1,
+                             const NeuralNetwork &nn2,
+                             const NeuralNetwork &nn3):
+    rand_(nn1.rand_)
+{
+    breedFrom(nn1, nn2, nn3);
+}
 
-    initial_weight_min_ = nn1.initial_weight_min_;
-    initial_weight_max_ = nn1.initial_weight_max_;
-    mutation_scale_min_ = nn1.mutation_scale_min_;
-    mutation_scale_max_ = nn1.mutation_scale_max_;
-    mutation_probability_ = nn1.mutation_probability_;
-    hidden_activation_ = nn1.hidden_activation_;
-    output_activation_ = nn1.output_activation_;
+void NeuralNetwork::copyFrom(const NeuralNetwork &copy, bool heavyMutation)
+{
+    copyFrom(copy, heavyMutation, rand_);
+}
 
-    initializeNeurons();
-    initializeWeights();
-    copyWeights(nn1.weights_, nn2.weights_);
+void NeuralNetwork::copyFrom(const NeuralNetwork &copy,
+                             bool heavyMutation,
+                             Random &rand)
+{
+    adoptParameters(copy);
+    copyWeights(copy.weights_);
+    updateInferenceWeights();
 
     fitness_ = 0;
+
+    if (heavyMutation) mutate(rand);
 }
 
-NeuralNetwork::NeuralNetwork(const NeuralNetwork &nn1,
-                             const NeuralNetwork &nn2,
-                             const NeuralNetwork &nn3):
-    rand_(nn1.rand_)
+void NeuralNetwork::breedFrom(const NeuralNetwork &nn1,
+                              const NeuralNetwork &nn2)
+{
+    breedFrom(nn1, nn2, rand_);
+}
+
+void NeuralNetwork::breedFrom(const NeuralNetwork &nn1,
+                              const NeuralNetwork &nn2,
+                              Random &rand)
 {
-    layers_ = nn1.layers_;
+    adoptParameters(nn1);
+    copyWeights(nn1.weights_, nn2.weights_, rand);
+    updateInferenceWeights();
 
-    input_code_ = nn1.input_code_;
-    output_code_ = nn1.output_code_;
-    fitness_code_ = nn1.fitness_code_;
+    fitness_ = 0;
+}
 
-    initial_weight_min_ = nn1.initial_weight_min_;
-    initial_weight_max_ = nn1.initial_weight_max_;
-    mutation_scale_min_ = nn1.mutation_scale_min_;
-    mutation_scale_max_ = nn1.mutation_scale_max_;
-    mutation_probability_ = nn1.mutation_probability_;
-    hidden_activation_ = nn1.hidden_activation_;
-    output_activation_ = nn1.output_activation_;
+void NeuralNetwork::breedFrom(const NeuralNetwork &nn1,
+                              const NeuralNetwork &nn2,
+                              const NeuralNetwork &nn3)
+{
+    breedFrom(nn1, nn2, nn3, rand_);
+}
 
-    initializeNeurons();
-    initializeWeights();
-    copyWeights(nn1.weights_, nn2.weights_, nn3.weights_);
+void NeuralNetwork::breedFrom(const NeuralNetwork &nn1,
+                              const NeuralNetwork &nn2,
+                              const NeuralNetwork &nn3,
+                              Random &rand)
+{
+    adoptParameters(nn1);
+    copyWeights(nn1.weights_, nn2.weights_, nn3.weights_, rand);
+    updateInferenceWeights();
 
     fitness_ = 0;
 }
 
 void NeuralNetwork::mutate()
 {
-    for (unsigned int i = 0; i < weights_.size(); i++) {
-        for (unsigned int j = 0; j < weights_[i].size(); j++) {
-            for (unsigned int k = 0; k < weights_[i][j].size(); k++) {
-                double weight = weights_[i][j][k];
-
-                int decisionMaker = rand_.random_int(0, 100);
-                if (decisionMaker < mutation_probability_) {
-                    switch(rand_.random_int(0,4)) {
-                    case 0:
-                        weight *= -1;
-                        break;
-                    case 1:
-                        weight = rand_.random_double(
-                                    mutation_scale_min_,
-                                    mutation_scale_max_);
-                        break;
-                    case 2:
-                        weight *= rand_.random_double(
-                                    mutation_scale_min_,
-                                    mutation_scale_max_);
-                        break;
-                    case 3:
-                        weight *= rand_.random_double(1.0, 2.0);
-                        break;
-                    default:
-                        weight *= rand_.random_double(0.0, 1.0);
-                        break;
-                    }
-                }
-                weights_[i][j][k] = weight;
+    mutate(rand_);
+}
+
+void NeuralNetwork::mutate(Random &rand)
+{
+    mutate_weights(weights_,
+                   mutation_probability_ / 100.0,
+                   mutation_scale_min_,
+                   mutation_scale_max_,
+                   rand);
+    updateInferenceWeights();
+}
+
+size_t NeuralNetwork::prune()
+{
+    if (!(pruning_threshold_ > 0)) return 0;
+    size_t pruned = prune_weights(weights_, pruning_threshold_);
+    if (pruned > 0) updateInferenceWeights();
+    return pruned;
+}
+
+double NeuralNetwork::compileResponseTable()
+{
+    table_ready_ = false;
+    if (layers_[0] != 1 || response_table_size_ < 2) return 0;
+
+    // The table only covers inputs between 0 and 1.
+    const InputEncoding &encoding = Encoding::input_encoding(input_code_);
+    if (encoding.minimum < 0 || encoding.maximum > 1) return 0;
+
+    unsigned int outputCount = getOutputCount();
+    response_table_.resize(response_table_size_, outputCount);
+    for (unsigned int s = 0; s < response_table_.size(); s++) {
+        double x = response_table_.position(s);
+        feedForward(&x, 1, response_table_.sample(s));
+    }
+
+    // Linear interpolation errs the most between the samples.
+    const unsigned int checks = 3;
+    table_check_.resize(2 * outputCount);
+    double *exact = table_check_.data();
+    double *approximate = exact + outputCount;
+    double maxError = 0;
+    for (unsigned int s = 0; s + 1 < response_table_.size(); s++) {
+        double left = response_table_.position(s);
+        double right = response_table_.position(s + 1);
+        for (unsigned int c = 1; c <= checks; c++) {
+            double x = left + (right - left) * c / (checks + 1);
+            feedForward(&x, 1, exact);
+            response_table_.lookup(x, approximate);
+            for (unsigned int i = 0; i < outputCount; i++) {
+                maxError = std::fmax(maxError,
+                                     std::fabs(exact[i] - approximate[i]));
             }
         }
     }
+    response_table_.setMaxError(maxError);
+    table_ready_ = true;
+    return maxError;
+}
+
+bool NeuralNetwork::hasResponseTable() const
+{
+    return table_ready_;
+}
+
+const ResponseTable &NeuralNetwork::getResponseTable() const
+{
+    return response_table_;
 }
 
 Row NeuralNetwork::feedForward(Row &inputs)
 {
-    for (unsigned int i = 0; i < inputs.size(); i++) {
-        neurons_[0][i] = inputs[i];
+    Row outputs(getOutputCount(), 0);
+    feedForward(inputs.data(),
+                static_cast<unsigned int>(inputs.size()),
+                outputs.data());
+    return outputs;
+}
+
+void NeuralNetwork::feedForward(const double *inputs,
+                                unsigned int count,
+                                double *outputs)
+{
+    if (count > layers_[0]) count = layers_[0];
+
+    if (table_ready_ && count == 1) {
+        response_table_.lookup(inputs[0], outputs);
+        return;
     }
 
-    for (unsigned int i = 1; i < layers_.size(); i++) {
-        bool outputLayer = i == layers_.size() - 1;
-        for (unsigned int j = 0; j < neurons_[i].size(); j++) {
-            double value = bias_;
-            for (unsigned int k = 0; k < neurons_[i - 1].size(); k++) {
-                value += weights_[i - 1][j][k] * neurons_[i - 1][k];
-            }
+    if (memoize_ && count == MEMOIZED_INPUTS) {
+        feedForwardMemoized(inputs, outputs);
+        return;
+    }
 
-            neurons_[i][j] = activation(value, outputLayer);
-        }
-        if ((outputLayer && output_activation_ == SOFTMAX)
-                || (!outputLayer && hidden_activation_ == SOFTMAX)) {
-            neurons_[i] = softmax(neurons_[i]);
-        }
+    switch(precision_) {
+    case SINGLE_PRECISION:
+        feedForwardFloat(inputs, count, outputs);
+        break;
+    case QUANTIZED_PRECISION:
+        feedForwardQuantized(inputs, count, outputs);
+        break;
+    default:
+        feedForwardDouble(inputs, count, outputs);
+        break;
     }
-    Row outputs = neurons_[neurons_.size() - 1];
-    return outputs;
+}
+
+unsigned int NeuralNetwork::getOutputCount() const
+{
+    return layers_[layers_.size() - 1];
+}
+vector<Matrix> NeuralNetwork::getWeights() const
+{
+    return weights_.toMatrices();
+}
+
+vector<Row> NeuralNetwork::getBiases() const
+{
+    return weights_.toBiases();
+}
+
+precision_type NeuralNetwork::getPrecision() const
+{
+    return precision_;
+}
+
+bool NeuralNetwork::getFastMath() const
+{
+    return fast_math_;
+}
+
+bool NeuralNetwork::isBinary() const
+{
+    return binary_;
+}
+
+const FloatWeightSet &NeuralNetwork::getFloatWeightSet() const
+{
+    return float_weights_;
+}
+
+const QuantizedWeightSet &NeuralNetwork::getQuantizedWeightSet() const
+{
+    return quantized_weights_;
+}
+
+const SparseWeightSet &NeuralNetwork::getSparseWeightSet() const
+{
+    return sparse_weights_;
+}
+
+const BinaryWeightSet &NeuralNetwork::getBinaryWeightSet() const
+{
+    return binary_weights_;
+}
+
+const WeightSet &NeuralNetwork::getWeightSet() const
+{
+    return weights_;
+}
+
+const vector<unsigned int> &NeuralNetwork::getLayers() const
+{
+    return layers_;
+}
+
+activation_type NeuralNetwork::getHiddenActivation() const
+{
+    return hidden_activation_;
+}
+
+activation_type NeuralNetwork::getOutputActivation() const
+{
+    return output_activation_;
 }
 
 input_type NeuralNetwork::getInputCode()
@@ -239,6 +326,13 @@ fitness_type NeuralNetwork::getFitnessCode()
 void NeuralNetwork::setBias(double var)
 {
     bias_ = var;
+    for (unsigned int i = 0; i < weights_.layerCount(); i++) {
+        double *bias = weights_.mutableBias(i);
+        for (unsigned int j = 0; j < weights_.rows(i); j++) {
+            bias[j] = var;
+        }
+    }
+    updateInferenceWeights();
 }
 
 double NeuralNetwork::getBias()
@@ -256,7 +350,7 @@ void NeuralNetwork::setFitness(double var)
     fitness_ = var;
 }
 
-double NeuralNetwork::getFitness()
+double NeuralNetwork::getFitness() const
 {
     return fitness_;
 }
@@ -268,6 +362,11 @@ void NeuralNetwork::resetNeurons()
             neurons_[i][j] = 0;
         }
     }
+    for (unsigned int i = 0; i < float_neurons_.size(); i++) {
+        for (unsigned int j = 0; j < float_neurons_[i].size(); j++) {
+            float_neurons_[i][j] = 0;
+        }
+    }
 }
 
 bool NeuralNetwork::compare(NeuralNetwork *nn1, NeuralNetwork *nn2)
@@ -277,116 +376,304 @@ bool NeuralNetwork::compare(NeuralNetwork *nn1, NeuralNetwork *nn2)
 
 void NeuralNetwork::initializeNeurons()
 {
+    // Layers that feed a weight block are padded with zeros up to its
+    // row stride. The padding weights are zero too, so the kernels
+    // can process whole strides without a scalar tail.
+    unsigned int last = static_cast<unsigned int>(layers_.size()) - 1;
     for (unsigned int i = 0; i < layers_.size(); i++) {
-        Row row;
-        for (unsigned int j = 0; j < layers_[i]; j++) {
-            row.push_back(0);
+        unsigned int width = i < last
+                ? WeightSet::padded(layers_[i]) : layers_[i];
+        neurons_.push_back(Row(width, 0));
+    }
+
+    unsigned int widest = 0;
+    for (unsigned int i = 0; i < layers_.size(); i++) {
+        if (layers_[i] > widest) widest = layers_[i];
+    }
+
+    if (precision_ != DOUBLE_PRECISION) {
+        for (unsigned int i = 0; i < layers_.size(); i++) {
+            unsigned int width = i < last
+                    ? FloatWeightSet::padded(layers_[i]) : layers_[i];
+            float_neurons_.push_back(vector<float>(width, 0));
+        }
+    } else {
+        binary_positive_.assign(binary_words(widest), 0);
+        binary_negative_.assign(binary_words(widest), 0);
+        if (layers_[0] == MEMOIZED_INPUTS) {
+            zero_outputs_.assign(layers_[layers_.size() - 1], 0);
         }
-        neurons_.push_back(row);
+    }
+
+    if (precision_ == QUANTIZED_PRECISION) {
+        quantized_inputs_.assign(Int8WeightSet::padded(widest), 0);
+        accumulators_.assign(widest, 0);
     }
 }
 
 void NeuralNetwork::initializeWeights()
 {
-    for (unsigned int i = 1; i < layers_.size(); i++) {
-        Matrix weightSet; // Weights between two layers.
-        unsigned int neuronCount = layers_[i - 1];
-        for (unsigned int j = 0; j < neurons_[i].size(); j++) {
-            Row neuronWeights;
-            for (unsigned int k = 0; k < neuronCount; k++) {
-                neuronWeights.push_back(rand_.random_double(
-                                            initial_weight_min_,
-                                            initial_weight_max_));
+    weights_ = WeightSet(layers_);
+    for (unsigned int i = 0; i < weights_.layerCount(); i++) {
+        unsigned int columns = weights_.columns(i);
+        for (unsigned int j = 0; j < weights_.rows(i); j++) {
+            double *row = weights_.mutableRow(i, j);
+            for (unsigned int k = 0; k < columns; k++) {
+                row[k] = rand_.random_double(initial_weight_min_,
+                                             initial_weight_max_);
             }
-            weightSet.push_back(neuronWeights);
         }
-        weights_.push_back(weightSet);
+        double *bias = weights_.mutableBias(i);
+        for (unsigned int j = 0; j < weights_.rows(i); j++) {
+            bias[j] = bias_;
+        }
     }
 }
 
-void NeuralNetwork::copyWeights(const vector<Matrix> &weights)
+void NeuralNetwork::copyWeights(const WeightSet &weights)
 {
-    for (unsigned int i = 0; i < weights_.size(); i++) {
-        for (unsigned int j = 0; j < weights_[i].size(); j++) {
-            for (unsigned int k = 0; k < weights_[i][j].size(); k++) {
-                weights_[i][j][k] = weights[i][j][k];
+    // Blocks are copied only once mutation writes into them.
+    weights_.share(weights);
+}
+
+void NeuralNetwork::copyWeights(const WeightSet &weights1,
+                                const WeightSet &weights2,
+                                Random &rand)
+{
+    crossover(crossover_method_, weights1, weights2, weights_, rand);
+}
+
+void NeuralNetwork::copyWeights(const WeightSet &weights1,
+                                const WeightSet &weights2,
+                                const WeightSet &weights3,
+                                Random &rand)
+{
+    crossover(crossover_method_, weights1, weights2, weights3,
+              weights_, rand);
+}
+
+void NeuralNetwork::adoptParameters(const NeuralNetwork &source)
+{
+    bool reshaped = neurons_.empty()
+            || layers_ != source.layers_
+            || precision_ != source.precision_;
+
+    layers_ = source.layers_;
+
+    input_code_ = source.input_code_;
+    output_code_ = source.output_code_;
+    fitness_code_ = source.fitness_code_;
+
+    initial_weight_min_ = source.initial_weight_min_;
+    initial_weight_max_ = source.initial_weight_max_;
+    mutation_scale_min_ = source.mutation_scale_min_;
+    mutation_scale_max_ = source.mutation_scale_max_;
+    mutation_probability_ = source.mutation_probability_;
+    hidden_activation_ = source.hidden_activation_;
+    output_activation_ = source.output_activation_;
+    precision_ = source.precision_;
+    fast_math_ = source.fast_math_;
+    crossover_method_ = source.crossover_method_;
+    pruning_threshold_ = source.pruning_threshold_;
+    sparse_density_ = source.sparse_density_;
+    response_table_size_ = source.response_table_size_;
+    bias_ = source.bias_;
+
+    // Buffers are only rebuilt when the structure changes, so that
+    // recycled networks reuse their memory.
+    if (reshaped) {
+        neurons_.clear();
+        float_neurons_.clear();
+        zero_outputs_.clear();
+        initializeNeurons();
+        weights_ = WeightSet(layers_);
+    } else {
+        resetNeurons();
+    }
+    resolveActivations();
+}
+
+void NeuralNetwork::resolveActivations()
+{
+    binary_ = precision_ == DOUBLE_PRECISION
+            && layers_.size() > 2
+            && is_binary_activation(hidden_activation_)
+            && is_binary_activation(output_activation_);
+
+    activations_.assign(layers_.size(),
+                        resolve_activation<double>(hidden_activation_,
+                                                   fast_math_));
+    float_activations_.assign(layers_.size(),
+                              resolve_activation<float>(hidden_activation_,
+                                                        fast_math_));
+    if (!activations_.empty()) {
+        activations_[activations_.size() - 1] =
+                resolve_activation<double>(output_activation_, fast_math_);
+        float_activations_[float_activations_.size() - 1] =
+                resolve_activation<float>(output_activation_, fast_math_);
+    }
+}
+
+void NeuralNetwork::updateInferenceWeights()
+{
+    if (precision_ == SINGLE_PRECISION) float_weights_.assign(weights_);
+    else if (precision_ == QUANTIZED_PRECISION) {
+        quantized_weights_.quantize(weights_);
+    } else {
+        sparse_weights_.compress(weights_, sparse_density_);
+        if (binary_) binary_weights_.binarize(weights_);
+    }
+
+    // Memoized results are only valid for the current weights.
+    memoize_ = precision_ == DOUBLE_PRECISION
+            && !zero_outputs_.empty()
+            && (input_code_ == FOUR_WAY_SEARCH
+                || input_code_ == FOUR_CORNER_SEARCH);
+    zero_ready_ = false;
+    table_ready_ = false;
+}
+
+void NeuralNetwork::feedForwardDouble(const double *inputs,
+                                      unsigned int count,
+                                      double *outputs)
+{
+    for (unsigned int i = 0; i < count; i++) {
+        neurons_[0][i] = inputs[i];
+    }
+
+    for (unsigned int i = 1; i < layers_.size(); i++) {
+        Row &current = neurons_[i];
+        if (binary_ && i > 1) {
+            // Inputs are hidden neurons, i.e. -1, 0 or 1.
+            pack_signs(neurons_[i - 1].data(),
+                       layers_[i - 1],
+                       binary_positive_.data(),
+                       binary_negative_.data());
+            binary_layer(binary_weights_.positive(i - 1),
+                         binary_weights_.negative(i - 1),
+                         binary_weights_.scales(i - 1),
+                         weights_.rows(i - 1),
+                         binary_weights_.words(i - 1),
+                         binary_positive_.data(),
+                         binary_negative_.data(),
+                         weights_.bias(i - 1),
+                         current.data());
+        } else if (sparse_weights_.isSparse(i - 1)) {
+            sparse_layer(sparse_weights_.values(i - 1),
+                         sparse_weights_.columnIndices(i - 1),
+                         sparse_weights_.rowStarts(i - 1),
+                         weights_.rows(i - 1),
+                         neurons_[i - 1].data(),
+                         weights_.bias(i - 1),
+                         current.data());
+        } else {
+            // One group of rows at a time, see weightset.hh.
+            unsigned int rows = weights_.rows(i - 1);
+            unsigned int step = weights_.groupRows(i - 1);
+            for (unsigned int j = 0; j < rows; j += step) {
+                dense_layer(weights_.row(i - 1, j),
+                            std::min(step, rows - j),
+                            weights_.stride(i - 1),
+                            weights_.stride(i - 1),
+                            neurons_[i - 1].data(),
+                            weights_.bias(i - 1) + j,
+                            current.data() + j);
             }
         }
+        activations_[i](current.data(), layers_[i], layers_[i]);
+    }
+
+    const Row &last = neurons_[neurons_.size() - 1];
+    for (unsigned int i = 0; i < last.size(); i++) {
+        outputs[i] = last[i];
     }
 }
 
-void NeuralNetwork::copyWeights(const vector<Matrix> &weights1,
-                                const vector<Matrix> &weights2)
-{
-    for (unsigned int i = 0; i < weights_.size(); i++) {
-        for (unsigned int j = 0; j < weights_[i].size(); j++) {
-            for (unsigned int k = 0; k < weights_[i][j].size(); k++) {
-                int decisionMaker = rand_.random_int(0, 2);
-                switch(decisionMaker) {
-                case 0:
-                    weights_[i][j][k] = weights1[i][j][k];
-                    break;
-                default:
-                    weights_[i][j][k] = weights2[i][j][k];
-                    break;
-                }
-            }
+void NeuralNetwork::feedForwardMemoized(const double *inputs,
+                                        double *outputs)
+{
+    for (unsigned int i = 0; i < MEMOIZED_INPUTS; i++) {
+        if (inputs[i] != 0) {
+            feedForwardDouble(inputs, MEMOIZED_INPUTS, outputs);
+            return;
         }
     }
+
+    if (!zero_ready_) {
+        feedForwardDouble(inputs, MEMOIZED_INPUTS, zero_outputs_.data());
+        zero_ready_ = true;
+    }
+    for (unsigned int i = 0; i < zero_outputs_.size(); i++) {
+        outputs[i] = zero_outputs_[i];
+    }
 }
 
-void NeuralNetwork::copyWeights(const vector<Matrix> &weights1,
-                                const vector<Matrix> &weights2,
-                                const vector<Matrix> &weights3)
-{
-    for (unsigned int i = 0; i < weights_.size(); i++) {
-        for (unsigned int j = 0; j < weights_[i].size(); j++) {
-            for (unsigned int k = 0; k < weights_[i][j].size(); k++) {
-                int decisionMaker = rand_.random_int(0, 3);
-                switch(decisionMaker) {
-                case 0:
-                    weights_[i][j][k] = weights1[i][j][k];
-                    break;
-                case 1:
-                    weights_[i][j][k] = weights2[i][j][k];
-                    break;
-                default:
-                    weights_[i][j][k] = weights3[i][j][k];
-                    break;
-                }
-            }
+void NeuralNetwork::feedForwardFloat(const double *inputs,
+                                     unsigned int count,
+                                     double *outputs)
+{
+    for (unsigned int i = 0; i < count; i++) {
+        float_neurons_[0][i] = static_cast<float>(inputs[i]);
+    }
+
+    for (unsigned int i = 1; i < layers_.size(); i++) {
+        vector<float> &current = float_neurons_[i];
+        unsigned int rows = float_weights_.rows(i - 1);
+        unsigned int step = float_weights_.groupRows(i - 1);
+        for (unsigned int j = 0; j < rows; j += step) {
+            dense_layer(float_weights_.row(i - 1, j),
+                        std::min(step, rows - j),
+                        float_weights_.stride(i - 1),
+                        float_weights_.stride(i - 1),
+                        float_neurons_[i - 1].data(),
+                        float_weights_.bias(i - 1) + j,
+                        current.data() + j);
         }
+        float_activations_[i](current.data(), layers_[i], layers_[i]);
+    }
+
+    const vector<float> &last = float_neurons_[float_neurons_.size() - 1];
+    for (unsigned int i = 0; i < last.size(); i++) {
+        outputs[i] = last[i];
     }
 }
 
-double NeuralNetwork::activation(double value, bool output)
+void NeuralNetwork::feedForwardQuantized(const double *inputs,
+                                         unsigned int count,
+                                         double *outputs)
 {
-    activation_type activation_function;
-    if (output) {
-        activation_function = output_activation_;
-    } else {
-        activation_function = hidden_activation_;
+    for (unsigned int i = 0; i < count; i++) {
+        float_neurons_[0][i] = static_cast<float>(inputs[i]);
+    }
+
+    const Int8WeightSet &weights = quantized_weights_.getWeights();
+    for (unsigned int i = 1; i < layers_.size(); i++) {
+        const vector<float> &previous = float_neurons_[i - 1];
+        vector<float> &current = float_neurons_[i];
+        float inputScale = quantize_values(previous.data(),
+                                           layers_[i - 1],
+                                           quantized_inputs_.data());
+        unsigned int rows = weights.rows(i - 1);
+        unsigned int step = weights.groupRows(i - 1);
+        for (unsigned int j = 0; j < rows; j += step) {
+            dense_layer_int8(weights.row(i - 1, j),
+                             std::min(step, rows - j),
+                             weights.stride(i - 1),
+                             weights.stride(i - 1),
+                             quantized_inputs_.data(),
+                             accumulators_.data() + j);
+        }
+
+        float scale = inputScale * quantized_weights_.getScale(i - 1);
+        const float *bias = quantized_weights_.getBiases(i - 1);
+        for (unsigned int j = 0; j < layers_[i]; j++) {
+            current[j] = accumulators_[j] * scale + bias[j];
+        }
+        float_activations_[i](current.data(), layers_[i], layers_[i]);
     }
 
-    switch(activation_function) {
-    case SIGMOID:
-        return sigmoid(value);
-    case HYPERBOLIC_TANGENT:
-        return hyperbolic_tangent(value);
-    case SIGN:
-        return sign(value);
-    case HEAVISIDE:
-        return heaviside(value);
-    case RELU:
-        return ReLU(value);
-    case RELU_LEAKY:
-        return ReLU_leaky(value);
-    case GAUSSIAN:
-        return gaussian(value);
-    case SOFTMAX:
-        return value; // computed somewhere else.
-    case NO_ACTIVATION:
-        return sigmoid(value);
+    const vector<float> &last = float_neurons_[float_neurons_.size() - 1];
+    for (unsigned int i = 0; i < last.size(); i++) {
+        outputs[i] = last[i];
     }
-    return sigmoid(value);
 }
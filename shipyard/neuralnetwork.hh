@@ -3,9 +3,24 @@
 
 #include "math.hh"
 #include "settings.hh"
+#include "weightset.hh"
+#include "quantization.hh"
+#include "sparse.hh"
+#include "binary.hh"
+#include "responsetable.hh"
+#include "activation.hh"
 
 using namespace std;
 
+/*!
+ * \var MEMOIZED_INPUTS
+ * \brief Number of inputs of the input types whose results are
+ * memoized, FOUR_WAY_SEARCH and FOUR_CORNER_SEARCH. Each of their
+ * inputs is either 0 or the distance to the target, and most of the
+ * time they are all 0.
+ */
+const unsigned int MEMOIZED_INPUTS = 4;
+
 /*!
  * \class NeuralNetwork
  * \brief Contains the implementation of a neural network.
@@ -60,13 +75,132 @@ public:
                   const NeuralNetwork &nn2,
                   const NeuralNetwork &nn3);
 
+    /*!
+     * \fn copyFrom
+     * \brief Turns this Neural Network into a copy of another one,
+     * reusing the memory of this network. Counterpart of the copy
+     * constructor.
+     * \param copy Neural Network to be copied.
+     * \param heavyMutation true, if mutation is to be applied
+     * to the copy.
+     */
+    void copyFrom(const NeuralNetwork &copy, bool heavyMutation = false);
+
+    /*!
+     * \fn copyFrom
+     * \brief Same as above, with random numbers from given generator
+     * instead of the network's own. Lets several threads breed
+     * networks at once.
+     * \param copy Neural Network to be copied.
+     * \param heavyMutation true, if mutation is to be applied
+     * to the copy.
+     * \param rand Random number generator.
+     */
+    void copyFrom(const NeuralNetwork &copy,
+                  bool heavyMutation,
+                  Random &rand);
+
+    /*!
+     * \fn breedFrom
+     * \brief Turns this Neural Network into a child of two others,
+     * reusing the memory of this network. Counterpart of the
+     * constructor for two parents.
+     * \param nn1 First parent.
+     * \param nn2 Second parent.
+     */
+    void breedFrom(const NeuralNetwork &nn1, const NeuralNetwork &nn2);
+
+    /*!
+     * \fn breedFrom
+     * \brief Same as above, with random numbers from given generator
+     * instead of the network's own.
+     * \param nn1 First parent.
+     * \param nn2 Second parent.
+     * \param rand Random number generator.
+     */
+    void breedFrom(const NeuralNetwork &nn1,
+                   const NeuralNetwork &nn2,
+                   Random &rand);
+
+    /*!
+     * \fn breedFrom
+     * \brief Turns this Neural Network into a child of three others,
+     * reusing the memory of this network. Counterpart of the
+     * constructor for three parents.
+     * \param nn1 First parent.
+     * \param nn2 Second parent.
+     * \param nn3 Third parent.
+     */
+    void breedFrom(const NeuralNetwork &nn1,
+                   const NeuralNetwork &nn2,
+                   const NeuralNetwork &nn3);
+
+    /*!
+     * \fn breedFrom
+     * \brief Same as above, with random numbers from given generator
+     * instead of the network's own.
+     * \param nn1 First parent.
+     * \param nn2 Second parent.
+     * \param nn3 Third parent.
+     * \param rand Random number generator.
+     */
+    void breedFrom(const NeuralNetwork &nn1,
+                   const NeuralNetwork &nn2,
+                   const NeuralNetwork &nn3,
+                   Random &rand);
+
     /*!
      * \fn mutate
      * \brief Mutates the Neural Network by modifying its
-     * weights.
+     * weights. Each weight mutates with the mutation probability
+     * (see mutation.hh).
      */
     void mutate();
 
+    /*!
+     * \fn mutate
+     * \brief Same as above, with random numbers from given generator
+     * instead of the network's own.
+     * \param rand Random number generator.
+     */
+    void mutate(Random &rand);
+
+    /*!
+     * \fn prune
+     * \brief Sets the weights whose magnitude is below the pruning
+     * threshold to zero (see sparse.hh). Meant to be called between
+     * generations. Does nothing if the threshold is 0.
+     * \return Number of pruned weights.
+     */
+    size_t prune();
+
+    /*!
+     * \fn compileResponseTable
+     * \brief Samples a network with a single input into a response
+     * table (see responsetable.hh), which feedForward then uses
+     * instead of the layers until the weights or the biases change.
+     * Meant to be called once per generation. Does nothing if the
+     * network has more than one input or the response table size is
+     * less than 2.
+     * \return Largest difference between the table and the network,
+     * measured between the samples. 0, if no table was compiled.
+     */
+    double compileResponseTable();
+
+    /*!
+     * \fn hasResponseTable
+     * \brief Checks whether feedForward uses the response table.
+     * \return true, if the table is up to date.
+     */
+    bool hasResponseTable() const;
+
+    /*!
+     * \fn getResponseTable
+     * \brief Getter for the response table.
+     * \return Response table, valid if hasResponseTable() is true.
+     */
+    const ResponseTable &getResponseTable() const;
+
     /*!
      * \fn feedForward
      * \brief Processes given inputs into outputs.
@@ -75,6 +209,129 @@ public:
      */
     Row feedForward(Row &inputs);
 
+    /*!
+     * \fn feedForward
+     * \brief Processes given inputs into caller-owned outputs. Works
+     * entirely within buffers allocated upon construction, so no
+     * memory is allocated.
+     * \param inputs Target inputs.
+     * \param count Number of inputs. Extra inputs are ignored.
+     * \param outputs Outputs, at least getOutputCount() of them.
+     */
+    void feedForward(const double *inputs,
+                     unsigned int count,
+                     double *outputs);
+
+    /*!
+     * \fn getOutputCount
+     * \brief Getter for the size of the output layer.
+     * \return Number of outputs.
+     */
+    unsigned int getOutputCount() const;
+
+    /*!
+     * \fn getWeights
+     * \brief Getter for the weights as nested matrices, one for
+     * each pair of consecutive layers. The matrices are copies:
+     * modifying them does not affect the Neural Network.
+     * \return Weights of the Neural Network.
+     */
+    vector<Matrix> getWeights() const;
+
+    /*!
+     * \fn getBiases
+     * \brief Getter for the biases of every layer but the input
+     * layer, one row per layer. The rows are copies: modifying them
+     * does not affect the Neural Network.
+     * \return Biases of the Neural Network.
+     */
+    vector<Row> getBiases() const;
+
+    /*!
+     * \fn getWeightSet
+     * \brief Getter for the contiguous weight storage.
+     * \return Weights of the Neural Network.
+     */
+    const WeightSet &getWeightSet() const;
+
+    /*!
+     * \fn getLayers
+     * \brief Getter for the structure of the Neural Network.
+     * \return Number of neurons on each layer.
+     */
+    const vector<unsigned int> &getLayers() const;
+
+    /*!
+     * \fn getHiddenActivation
+     * \brief Getter for the activation function of the hidden layers.
+     * \return Activation function type.
+     */
+    activation_type getHiddenActivation() const;
+
+    /*!
+     * \fn getOutputActivation
+     * \brief Getter for the activation function of the output layer.
+     * \return Activation function type.
+     */
+    activation_type getOutputActivation() const;
+
+    /*!
+     * \fn getPrecision
+     * \brief Getter for the precision used during inference.
+     * \return Precision type.
+     */
+    precision_type getPrecision() const;
+
+    /*!
+     * \fn getFastMath
+     * \brief Getter for the use of fast math.
+     * \return true, if activation functions use fast approximations.
+     */
+    bool getFastMath() const;
+
+    /*!
+     * \fn isBinary
+     * \brief Checks whether the hidden layers are processed with the
+     * bit-packed kernels of binary.hh. This is the case in double
+     * precision mode when both the hidden and the output activation
+     * function are SIGN or HEAVISIDE. Layers that receive hidden
+     * neurons as inputs then use binarized weights.
+     * \return true, if the binary kernels are in use.
+     */
+    bool isBinary() const;
+
+    /*!
+     * \fn getFloatWeightSet
+     * \brief Getter for the single precision copy of the weights.
+     * \return Weights used for inference in single precision mode.
+     * Empty in double precision mode.
+     */
+    const FloatWeightSet &getFloatWeightSet() const;
+
+    /*!
+     * \fn getQuantizedWeightSet
+     * \brief Getter for the 8-bit copy of the weights.
+     * \return Weights used for inference in quantized precision mode.
+     * Empty in other modes.
+     */
+    const QuantizedWeightSet &getQuantizedWeightSet() const;
+
+    /*!
+     * \fn getSparseWeightSet
+     * \brief Getter for the sparse copy of the weights.
+     * \return Weights used for inference of sparse layers in double
+     * precision mode. Not refreshed in other modes.
+     */
+    const SparseWeightSet &getSparseWeightSet() const;
+
+    /*!
+     * \fn getBinaryWeightSet
+     * \brief Getter for the binarized copy of the weights.
+     * \return Weights used by the binary kernels. Only refreshed
+     * when isBinary() is true.
+     */
+    const BinaryWeightSet &getBinaryWeightSet() const;
+
     /*!
      * \fn getInputCode
      * \brief Getter for the input code, i.e. what kind
@@ -101,7 +358,9 @@ public:
 
     /*!
      * \fn setBias
-     * \brief Setter for initial bias.
+     * \brief Setter for initial bias. Every neuron starts over with
+     * this bias, after which mutation and crossover evolve the
+     * biases like the weights.
      * \param var Target bias.
      */
     void setBias(double var);
@@ -132,7 +391,7 @@ public:
      * \brief Getter for fitness.
      * \return Current fitness value.
      */
-    double getFitness();
+    double getFitness() const;
 
     /*!
      * \fn resetNeurons
@@ -149,6 +408,7 @@ public:
      * \return true/false for which one has greater fitness value.
      */
     static bool compare(NeuralNetwork *nn1, NeuralNetwork *nn2);
+
 private:
 
     /*!
@@ -179,14 +439,153 @@ private:
     /*!
      * \var weights_
      * \brief Contains all of the weights between neurons of
-     * the Neural Network.
+     * the Neural Network, stored in one contiguous buffer.
      */
-    vector<Matrix> weights_;
+    WeightSet weights_;
+
+    /*!
+     * \var precision_
+     * \brief Precision used during inference. Mutation and breeding
+     * always use the double precision weights.
+     */
+    precision_type precision_;
+
+    /*!
+     * \var fast_math_
+     * \brief Whether activation functions use the fast approximations
+     * of fastmath.hh.
+     */
+    bool fast_math_;
+
+    /*!
+     * \var crossover_method_
+     * \brief Way of combining the weights of two or three parents.
+     */
+    crossover_type crossover_method_;
+
+    /*!
+     * \var pruning_threshold_
+     * \brief Magnitude below which weights are pruned.
+     */
+    double pruning_threshold_;
+
+    /*!
+     * \var sparse_density_
+     * \brief Density below which a layer is processed as sparse.
+     */
+    double sparse_density_;
+
+    /*!
+     * \var sparse_weights_
+     * \brief CSR copy of the sparse weight blocks, refreshed whenever
+     * the weights change. Used for inference in double precision mode.
+     */
+    SparseWeightSet sparse_weights_;
+
+    /*!
+     * \var binary_
+     * \brief Whether the hidden layers use the binary kernels.
+     */
+    bool binary_;
+
+    /*!
+     * \var binary_weights_
+     * \brief Binarized copy of the weights, refreshed whenever the
+     * weights change while binary_ is true.
+     */
+    BinaryWeightSet binary_weights_;
+
+    /*!
+     * \var response_table_size_
+     * \brief Number of samples in the response table.
+     */
+    unsigned int response_table_size_;
+
+    /*!
+     * \var response_table_
+     * \brief Piecewise-linear approximation of a single-input network.
+     */
+    ResponseTable response_table_;
+
+    /*!
+     * \var table_ready_
+     * \brief Whether response_table_ is up to date.
+     */
+    bool table_ready_;
+
+    /*!
+     * \var table_check_
+     * \brief Outputs of the network and the table while measuring
+     * the error of the table.
+     */
+    Row table_check_;
+
+    /*!
+     * \var memoize_
+     * \brief Whether feedForward goes through feedForwardMemoized.
+     */
+    bool memoize_;
+
+    /*!
+     * \var zero_outputs_
+     * \brief Outputs for inputs that are all zero.
+     */
+    Row zero_outputs_;
+
+    /*!
+     * \var zero_ready_
+     * \brief Whether zero_outputs_ is up to date.
+     */
+    bool zero_ready_;
+
+    /*!
+     * \var binary_positive_
+     * \brief Bit mask of the positive neurons of the previous layer.
+     */
+    vector<uint64_t> binary_positive_;
+
+    /*!
+     * \var binary_negative_
+     * \brief Bit mask of the negative neurons of the previous layer.
+     */
+    vector<uint64_t> binary_negative_;
+
+    /*!
+     * \var float_neurons_
+     * \brief Neurons of the Neural Network in single precision mode.
+     */
+    vector<vector<float> > float_neurons_;
+
+    /*!
+     * \var float_weights_
+     * \brief Single precision copy of the weights, refreshed whenever
+     * the weights change. Used for inference in single precision mode.
+     */
+    FloatWeightSet float_weights_;
+
+    /*!
+     * \var quantized_weights_
+     * \brief 8-bit copy of the weights, refreshed whenever the weights
+     * change. Used for inference in quantized precision mode.
+     */
+    QuantizedWeightSet quantized_weights_;
+
+    /*!
+     * \var quantized_inputs_
+     * \brief Quantized neurons of the layer that is being processed.
+     */
+    vector<int8_t> quantized_inputs_;
+
+    /*!
+     * \var accumulators_
+     * \brief Integer sums of the layer that is being processed.
+     */
+    vector<int32_t> accumulators_;
 
     /*!
      * \var bias_
-     * \brief Initial bias. This is added on top of other
-     * weighted values of neurons.
+     * \brief Initial bias. The bias of each neuron is stored with
+     * the weights (see weightset.hh) and starts from this value.
      */
     double bias_ = 0;
 
@@ -232,6 +631,20 @@ private:
      */
     activation_type output_activation_;
 
+    /*!
+     * \var activations_
+     * \brief Activation kernel of each layer, resolved from the
+     * activation function types when the network is built. The
+     * input layer has no activation, so its entry is unused.
+     */
+    vector<activation_function> activations_;
+
+    /*!
+     * \var float_activations_
+     * \brief Single precision counterparts of activations_.
+     */
+    vector<activation_function_float> float_activations_;
+
     /*!
      * \var mutation_probability_
      * \brief Mutation probability for each weight.
@@ -266,46 +679,108 @@ private:
 
     /*!
      * \fn copyWeights
-     * \brief Copies given weights into the Neural Network.
+     * \brief Copies given weights into the Neural Network. The
+     * groups of weights are shared until either network modifies them.
      * \param weights Weights that are to be copied.
      */
-    void copyWeights(const vector<Matrix> &weights);
+    void copyWeights(const WeightSet &weights);
 
     /*!
      * \fn copyWeights
      * \brief Copies given weights into the Neural Network.
-     * The weight sets are selected randomly for each
-     * individual weight.
+     * The weight sets are combined according to the
+     * crossover method (see crossover.hh).
      * \param weights1 Weight set 1.
      * \param weights2 Weight set 2.
+     * \param rand Random number generator.
      */
-    void copyWeights(const vector<Matrix> &weights1,
-                     const vector<Matrix> &weights2);
+    void copyWeights(const WeightSet &weights1,
+                     const WeightSet &weights2,
+                     Random &rand);
 
     /*!
      * \fn copyWeights
      * \brief Copies given weights into the Neural Network.
-     * The weight sets are selected randomly for each
-     * individual weight.
+     * The weight sets are combined according to the
+     * crossover method (see crossover.hh).
      * \param weights1 Weight set 1.
      * \param weights2 Weight set 2.
      * \param weights3 Weight set 3.
+     * \param rand Random number generator.
+     */
+    void copyWeights(const WeightSet &weights1,
+                     const WeightSet &weights2,
+                     const WeightSet &weights3,
+                     Random &rand);
+
+    /*!
+     * \fn adoptParameters
+     * \brief Takes over the structure and parameters of another
+     * Neural Network. Buffers are reallocated only if the structure
+     * differs from the current one.
+     * \param source Neural Network whose parameters are taken.
+     */
+    void adoptParameters(const NeuralNetwork &source);
+
+    /*!
+     * \fn resolveActivations
+     * \brief Selects the activation kernel of every layer.
+     */
+    void resolveActivations();
+
+    /*!
+     * \fn updateInferenceWeights
+     * \brief Refreshes the weights used for inference after the
+     * double precision weights have changed.
      */
-    void copyWeights(const vector<Matrix> &weights1,
-                     const vector<Matrix> &weights2,
-                     const vector<Matrix> &weights3);
+    void updateInferenceWeights();
 
     /*!
-     * \fn activation
-     * \brief Performs the activation function for the given
-     * value. Activation function is selected via specified
-     * activation function type.
-     * \param value Subject value.
-     * \param output Flag that determines whether the value
-     * is an output value.
-     * \return Activated value.
+     * \fn feedForwardMemoized
+     * \brief Version of feedForward for input types FOUR_WAY_SEARCH
+     * and FOUR_CORNER_SEARCH. Inputs that are all zero always give the
+     * same outputs, which are computed once and then looked up. Other
+     * inputs are processed in full. Results are forgotten whenever
+     * the weights or the bias change.
+     * \param inputs Target inputs, MEMOIZED_INPUTS of them.
+     * \param outputs Outputs.
+     */
+    void feedForwardMemoized(const double *inputs, double *outputs);
+
+    /*!
+     * \fn feedForwardDouble
+     * \brief Double precision version of feedForward.
+     * \param inputs Target inputs.
+     * \param count Number of inputs.
+     * \param outputs Outputs.
+     */
+    void feedForwardDouble(const double *inputs,
+                           unsigned int count,
+                           double *outputs);
+
+    /*!
+     * \fn feedForwardFloat
+     * \brief Single precision version of feedForward.
+     * \param inputs Target inputs.
+     * \param count Number of inputs.
+     * \param outputs Outputs.
+     */
+    void feedForwardFloat(const double *inputs,
+                          unsigned int count,
+                          double *outputs);
+
+    /*!
+     * \fn feedForwardQuantized
+     * \brief Quantized version of feedForward. Neurons of each layer
+     * are quantized with a scale of their own before they are
+     * multiplied with the 8-bit weights.
+     * \param inputs Target inputs.
+     * \param count Number of inputs.
+     * \param outputs Outputs.
      */
-    double activation(double value, bool output);
+    void feedForwardQuantized(const double *inputs,
+                              unsigned int count,
+                              double *outputs);
 };
 
 #endif // NEURALNETWORK_HH
@@ -0,0 +1,99 @@
+#include "quantization.hh"
+#include <cmath>
+
+namespace
+{
+    int8_t quantize_value(double value, double scale)
+    {
+        long q = std::lround(value / scale);
+        if (q > QUANTIZATION_LEVELS) q = QUANTIZATION_LEVELS;
+        if (q < -QUANTIZATION_LEVELS) q = -QUANTIZATION_LEVELS;
+        return static_cast<int8_t>(q);
+    }
+}
+
+float quantize_values(const float *values, unsigned int count, int8_t *output)
+{
+    float largest = 0;
+    for (unsigned int i = 0; i < count; i++) {
+        largest = std::fmax(largest, std::fabs(values[i]));
+    }
+
+    if (largest == 0) {
+        for (unsigned int i = 0; i < count; i++) output[i] = 0;
+        return 0;
+    }
+
+    float scale = largest / QUANTIZATION_LEVELS;
+    for (unsigned int i = 0; i < count; i++) {
+        output[i] = quantize_value(values[i], scale);
+    }
+    return scale;
+}
+
+QuantizedWeightSet::QuantizedWeightSet()
+{
+}
+
+void QuantizedWeightSet::quantize(const WeightSet &weights)
+{
+    if (!weights_.sameLayout(weights)) {
+        weights_ = Int8WeightSet(weights.rowCounts(), weights.columnCounts());
+    }
+    scales_.assign(weights.layerCount(), 0);
+    biases_.resize(weights.layerCount());
+
+    for (unsigned int i = 0; i < weights.layerCount(); i++) {
+        double largest = 0;
+        for (unsigned int j = 0; j < weights.rows(i); j++) {
+            const double *row = weights.row(i, j);
+            for (unsigned int k = 0; k < weights.columns(i); k++) {
+                largest = std::fmax(largest, std::fabs(row[k]));
+            }
+        }
+
+        float scale = static_cast<float>(largest / QUANTIZATION_LEVELS);
+        scales_[i] = scale;
+        for (unsigned int j = 0; j < weights.rows(i); j++) {
+            const double *source = weights.row(i, j);
+            int8_t *target = weights_.mutableRow(i, j);
+            for (unsigned int k = 0; k < weights.columns(i); k++) {
+                target[k] = scale == 0 ? 0 : quantize_value(source[k], scale);
+            }
+        }
+
+        const double *bias = weights.bias(i);
+        biases_[i].resize(weights.rows(i));
+        for (unsigned int j = 0; j < weights.rows(i); j++) {
+            biases_[i][j] = static_cast<float>(bias[j]);
+        }
+    }
+}
+
+const Int8WeightSet &QuantizedWeightSet::getWeights() const
+{
+    return weights_;
+}
+
+float QuantizedWeightSet::getScale(unsigned int layer) const
+{
+    return scales_[layer];
+}
+
+const float *QuantizedWeightSet::getBiases(unsigned int layer) const
+{
+    return biases_[layer].data();
+}
+
+vector<Matrix> QuantizedWeightSet::dequantize() const
+{
+    vector<Matrix> matrices = weights_.toMatrices();
+    for (unsigned int i = 0; i < matrices.size(); i++) {
+        for (unsigned int j = 0; j < matrices[i].size(); j++) {
+            for (unsigned int k = 0; k < matrices[i][j].size(); k++) {
+                matrices[i][j][k] *= scales_[i];
+            }
+        }
+    }
+    return matrices;
+}
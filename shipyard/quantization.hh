@@ -0,0 +1,106 @@
+#ifndef QUANTIZATION_HH
+#define QUANTIZATION_HH
+
+#include "weightset.hh"
+
+/*!
+ * \file quantization.hh
+ * \brief Symmetric 8-bit quantization of weights and neurons. A
+ * quantized value q stands for q * scale, where scale is chosen so
+ * that the largest magnitude maps to QUANTIZATION_LEVELS.
+ * \author terratenff
+ */
+
+/*!
+ * \var QUANTIZATION_LEVELS
+ * \brief Largest quantized magnitude. -128 is left unused so that
+ * the range is symmetric.
+ */
+const int QUANTIZATION_LEVELS = 127;
+
+/*!
+ * \fn quantize_values
+ * \brief Quantizes a row of values with a scale of its own.
+ * \param values Source values.
+ * \param count Number of values.
+ * \param output Quantized values, at least "count" of them.
+ * \return Scale of the quantized values. 0, if every value is 0.
+ */
+float quantize_values(const float *values, unsigned int count, int8_t *output);
+
+/*!
+ * \class QuantizedWeightSet
+ * \brief 8-bit copy of a weight set. Each weight block has a scale
+ * of its own. Biases are not quantized but kept in single
+ * precision, since they are added after the integer sums.
+ * \author terratenff
+ */
+class QuantizedWeightSet
+{
+public:
+
+    /*!
+     * \brief Constructor for an empty quantized weight set.
+     */
+    QuantizedWeightSet();
+
+    /*!
+     * \fn quantize
+     * \brief Replaces the contents with a quantized copy of the
+     * given weights.
+     * \param weights Source weights.
+     */
+    void quantize(const WeightSet &weights);
+
+    /*!
+     * \fn getWeights
+     * \brief Getter for the quantized weights.
+     * \return Quantized weights. Layout is the same as in the source
+     * weight set, except for strides.
+     */
+    const Int8WeightSet &getWeights() const;
+
+    /*!
+     * \fn getScale
+     * \brief Getter for the scale of a weight block.
+     * \param layer Target weight block.
+     * \return Scale of the weights of the block.
+     */
+    float getScale(unsigned int layer) const;
+
+    /*!
+     * \fn getBiases
+     * \brief Getter for the biases of a weight block.
+     * \param layer Target weight block.
+     * \return Bias of each row in single precision.
+     */
+    const float *getBiases(unsigned int layer) const;
+
+    /*!
+     * \fn dequantize
+     * \brief Converts the quantized weights back into matrices.
+     * \return Approximation of the source weights.
+     */
+    vector<Matrix> dequantize() const;
+private:
+
+    /*!
+     * \var weights_
+     * \brief Quantized weights.
+     */
+    Int8WeightSet weights_;
+
+    /*!
+     * \var scales_
+     * \brief Scale of each weight block.
+     */
+    vector<float> scales_;
+
+    /*!
+     * \var biases_
+     * \brief Biases of each weight block.
+     */
+    vector<vector<float> > biases_;
+};
+
+#endif // QUANTIZATION_HH
@@ -0,0 +1,60 @@
+#include "responsetable.hh"
+
+ResponseTable::ResponseTable():
+    size_(0),
+    outputs_(0),
+    max_error_(0)
+{
+}
+
+void ResponseTable::resize(unsigned int size, unsigned int outputs)
+{
+    if (size < 2) size = 2;
+    size_ = size;
+    outputs_ = outputs;
+    samples_.resize(static_cast<size_t>(size) * outputs);
+    max_error_ = 0;
+}
+
+double ResponseTable::position(unsigned int sample) const
+{
+    return static_cast<double>(sample) / (size_ - 1);
+}
+
+double *ResponseTable::sample(unsigned int sample)
+{
+    return samples_.data() + static_cast<size_t>(sample) * outputs_;
+}
+
+void ResponseTable::lookup(double x, double *outputs) const
+{
+    double scaled = x * (size_ - 1);
+    if (!(scaled > 0)) scaled = 0;
+    if (scaled > size_ - 1) scaled = size_ - 1;
+
+    unsigned int lower = static_cast<unsigned int>(scaled);
+    if (lower > size_ - 2) lower = size_ - 2;
+    double fraction = scaled - lower;
+
+    const double *left = samples_.data()
+            + static_cast<size_t>(lower) * outputs_;
+    const double *right = left + outputs_;
+    for (unsigned int i = 0; i < outputs_; i++) {
+        outputs[i] = left[i] + fraction * (right[i] - left[i]);
+    }
+}
+
+void ResponseTable::setMaxError(double var)
+{
+    max_error_ = var;
+}
+
+double ResponseTable::getMaxError() const
+{
+    return max_error_;
+}
+
+unsigned int ResponseTable::size() const
+{
+    return size_;
+}
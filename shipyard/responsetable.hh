@@ -0,0 +1,108 @@
+#ifndef RESPONSETABLE_HH
+#define RESPONSETABLE_HH
+
+#include <vector>
+
+using namespace std;
+
+/*!
+ * \class ResponseTable
+ * \brief Piecewise-linear approximation of a function that maps a
+ * single value between 0 and 1 to one or more outputs. The function
+ * is sampled at evenly spaced points, including both ends, and the
+ * outputs are interpolated linearly between the two nearest samples.
+ * Values outside [0, 1] are clamped.
+ * \author terratenff
+ */
+class ResponseTable
+{
+public:
+
+    /*!
+     * \brief Constructor for an empty response table.
+     */
+    ResponseTable();
+
+    /*!
+     * \fn resize
+     * \brief Prepares the table for new samples. Storage is reused, so
+     * memory is allocated only when the table grows.
+     * \param size Number of samples, at least 2.
+     * \param outputs Number of outputs per sample.
+     */
+    void resize(unsigned int size, unsigned int outputs);
+
+    /*!
+     * \fn position
+     * \brief Getter for the input value of a sample.
+     * \param sample Target sample.
+     * \return Input value between 0 and 1.
+     */
+    double position(unsigned int sample) const;
+
+    /*!
+     * \fn sample
+     * \brief Getter for the outputs of a sample, to be filled in.
+     * \param sample Target sample.
+     * \return Outputs of the sample.
+     */
+    double *sample(unsigned int sample);
+
+    /*!
+     * \fn lookup
+     * \brief Interpolates the outputs for an input value.
+     * \param x Input value.
+     * \param outputs Interpolated outputs.
+     */
+    void lookup(double x, double *outputs) const;
+
+    /*!
+     * \fn setMaxError
+     * \brief Setter for the largest difference between the table and
+     * the function it approximates.
+     * \param var Measured error.
+     */
+    void setMaxError(double var);
+
+    /*!
+     * \fn getMaxError
+     * \brief Getter for the largest difference between the table and
+     * the function it approximates.
+     * \return Measured error.
+     */
+    double getMaxError() const;
+
+    /*!
+     * \fn size
+     * \brief Getter for the number of samples.
+     * \return Number of samples.
+     */
+    unsigned int size() const;
+private:
+
+    /*!
+     * \var size_
+     * \brief Number of samples.
+     */
+    unsigned int size_;
+
+    /*!
+     * \var outputs_
+     * \brief Number of outputs per sample.
+     */
+    unsigned int outputs_;
+
+    /*!
+     * \var samples_
+     * \brief Outputs of every sample, sample by sample.
+     */
+    vector<double> samples_;
+
+    /*!
+     * \var max_error_
+     * \brief Largest difference to the approximated function.
+     */
+    double max_error_;
+};
+
+#endif // RESPONSETABLE_HH
@@ -1,7 +1,28 @@
 #include "scenario.hh"
 #include <fstream>
+#include <stdexcept>
 #include <string>
 
+namespace
+{
+    // Reads a comma-separated list of layer widths. Throws on
+    // anything that is not a positive integer.
+    std::vector<unsigned int> parse_widths(const std::string &text)
+    {
+        std::vector<unsigned int> widths;
+        size_t start = 0;
+        while (start < text.size()) {
+            size_t end = text.find(',', start);
+            if (end == std::string::npos) end = text.size();
+            int width = std::stoi(text.substr(start, end - start));
+            if (width <= 0) throw std::invalid_argument(text);
+            widths.push_back(static_cast<unsigned int>(width));
+            start = end + 1;
+        }
+        return widths;
+    }
+}
+
 Scenario::Scenario(const Settings *settings)
 {
     apply_settings(settings);
@@ -69,6 +90,21 @@ void Scenario::apply_settings(const Settings *settings)
             static_cast<int>(settings->get_mutation_scale_minimum() * FACTOR_);
     settings_data_[MUTATION_SCALE_MAXIMUM] =
             static_cast<int>(settings->get_mutation_scale_maximum() * FACTOR_);
+    settings_data_[NETWORK_PRECISION] =
+            static_cast<int>(settings->get_network_precision());
+    settings_data_[FAST_MATH] =
+            static_cast<int>(settings->get_fast_math());
+    settings_data_[CROSSOVER_METHOD] =
+            static_cast<int>(settings->get_crossover_method());
+    settings_data_[PRUNING_THRESHOLD] =
+            static_cast<int>(settings->get_pruning_threshold() * FACTOR_);
+    settings_data_[SPARSE_DENSITY] =
+            static_cast<int>(settings->get_sparse_density() * FACTOR_);
+    settings_data_[RESPONSE_TABLE_SIZE] =
+            static_cast<int>(settings->get_response_table_size());
+    hidden_layer_widths_ = settings->get_hidden_layer_widths();
+    settings_data_[HIDDEN_LAYER_WIDTHS] =
+            static_cast<int>(hidden_layer_widths_.size());
 }
 
 void Scenario::set_settings(Settings *settings)
@@ -138,6 +174,18 @@ void Scenario::set_settings(Settings *settings)
                 static_cast<double>(settings_data_[MUTATION_SCALE_MINIMUM] / FACTOR_));
     settings->set_mutation_scale_maximum(
                 static_cast<double>(settings_data_[MUTATION_SCALE_MAXIMUM] / FACTOR_));
+    settings->set_network_precision(
+                static_cast<precision_type>(settings_data_[NETWORK_PRECISION]));
+    settings->set_fast_math(settings_data_[FAST_MATH] != 0);
+    settings->set_crossover_method(
+                static_cast<crossover_type>(settings_data_[CROSSOVER_METHOD]));
+    settings->set_pruning_threshold(
+                static_cast<double>(settings_data_[PRUNING_THRESHOLD] / FACTOR_));
+    settings->set_sparse_density(
+                static_cast<double>(settings_data_[SPARSE_DENSITY] / FACTOR_));
+    settings->set_response_table_size(
+                static_cast<unsigned int>(settings_data_[RESPONSE_TABLE_SIZE]));
+    settings->set_hidden_layer_widths(hidden_layer_widths_);
 }
 
 void Scenario::save_scenario(const std::string path)
@@ -153,6 +201,13 @@ void Scenario::save_scenario(const std::string path)
         setting_type type = static_cast<setting_type>(setting);
         prefix = setting_enum_strings[setting];
         suffix = std::to_string(settings_data_[type]);
+        if (type == HIDDEN_LAYER_WIDTHS) {
+            suffix.clear();
+            for (unsigned int i = 0; i < hidden_layer_widths_.size(); i++) {
+                if (i > 0) suffix += ",";
+                suffix += std::to_string(hidden_layer_widths_[i]);
+            }
+        }
         line = prefix + middle + suffix;
         file << line << std::endl;
     }
@@ -169,6 +224,7 @@ int Scenario::load_scenario(const std::string path)
         std::string middle = ":";
         std::string suffix;
         std::unordered_map<setting_type, int> temp_settings;
+        std::vector<unsigned int> temp_widths;
 
         try {
             while (std::getline(file, line)) {
@@ -176,6 +232,11 @@ int Scenario::load_scenario(const std::string path)
                 prefix = line.substr(0, line.find(middle));
                 suffix = line.substr(line.find(middle) + 1, line.size());
                 setting_type type = get_setting_type(prefix);
+                if (type == HIDDEN_LAYER_WIDTHS) {
+                    temp_widths = parse_widths(suffix);
+                    temp_settings[type] = static_cast<int>(temp_widths.size());
+                    continue;
+                }
                 int value = std::stoi(suffix);
                 temp_settings[type] = value;
             }
@@ -189,6 +250,11 @@ int Scenario::load_scenario(const std::string path)
         for (it = temp_settings.begin(); it != temp_settings.end(); it++) {
             settings_data_[it->first] = it->second;
         }
+        // Files without widths, such as older ones, are shaped by the
+        // layer and neuron counts instead of any widths loaded before.
+        hidden_layer_widths_ = temp_widths;
+        settings_data_[HIDDEN_LAYER_WIDTHS] =
+                static_cast<int>(temp_widths.size());
 
     } else {
         return 1;
@@ -2,6 +2,7 @@
 #define SCENARIO_HH
 
 #include "settings.hh"
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -27,6 +28,13 @@ enum setting_type {
     ACTIVATION_FUNCTION_HIDDEN, ACTIVATION_FUNCTION_OUTPUT,
     BREEDING_METHOD, POPULATION_RETENTION_RATE,
     MUTATION_PROBABILITY, MUTATION_SCALE_MINIMUM, MUTATION_SCALE_MAXIMUM,
+    NETWORK_PRECISION,
+    FAST_MATH,
+    CROSSOVER_METHOD,
+    PRUNING_THRESHOLD,
+    SPARSE_DENSITY,
+    RESPONSE_TABLE_SIZE,
+    HIDDEN_LAYER_WIDTHS,
 
     SETTING_END
 };
@@ -51,6 +59,13 @@ static const char *setting_enum_strings[] = {
     "ACTIVATION_FUNCTION_HIDDEN", "ACTIVATION_FUNCTION_OUTPUT",
     "BREEDING_METHOD", "POPULATION_RETENTION_RATE",
     "MUTATION_PROBABILITY", "MUTATION_SCALE_MINIMUM", "MUTATION_SCALE_MAXIMUM",
+    "NETWORK_PRECISION",
+    "FAST_MATH",
+    "CROSSOVER_METHOD",
+    "PRUNING_THRESHOLD",
+    "SPARSE_DENSITY",
+    "RESPONSE_TABLE_SIZE",
+    "HIDDEN_LAYER_WIDTHS",
     "SETTING_END"
 };
 
@@ -85,6 +100,10 @@ inline setting_type get_setting_type(std::string str)
 /*!
  * \class Scenario
  * \brief Tracker of settings as suitable strings.
+ *
+ * Every setting is stored as an integer, except for the hidden layer
+ * widths, which are stored as a comma-separated list (e.g.
+ * "HIDDEN_LAYER_WIDTHS:32,16,8").
  * \author terratenff
  */
 class Scenario
@@ -137,6 +156,13 @@ private:
      */
     std::unordered_map<setting_type, int> settings_data_;
 
+    /*!
+     * \var hidden_layer_widths_
+     * \brief Width of each hidden layer. Kept apart from the other
+     * settings, since it is a list.
+     */
+    std::vector<unsigned int> hidden_layer_widths_;
+
     /*!
      * \var FACTOR_
      * \brief Some UI components support integers only, even though
@@ -0,0 +1,50 @@
+#include "sceneobserver.hh"
+#include "subject.hh"
+#include <QPen>
+
+SceneObserver::SceneObserver(QGraphicsScene *scene):
+    scene_(scene),
+    polygonBase_(Subject::defaultPolygon())
+{
+}
+
+SceneObserver::~SceneObserver()
+{
+    subjectsCleared();
+}
+
+void SceneObserver::subjectsCreated(const std::vector<SubjectCore*> &subjects)
+{
+    subjectsCleared();
+
+    QPen pen = QPen(Qt::black, 3);
+    for (unsigned int i = 0; i < subjects.size(); i++) {
+        QGraphicsPolygonItem *item = new QGraphicsPolygonItem();
+        item->setPolygon(polygonBase_);
+        item->setPen(pen);
+        scene_->addItem(item);
+        items_.push_back(item);
+    }
+    subjectsUpdated(subjects);
+}
+
+void SceneObserver::subjectsUpdated(const std::vector<SubjectCore*> &subjects)
+{
+    for (unsigned int i = 0; i < subjects.size() && i < items_.size(); i++) {
+        XY coordinates = subjects[i]->getCoordinates();
+
+        t_.reset();
+        t_.rotate(subjects[i]->getAngle());
+        items_[i]->setPolygon(t_.map(polygonBase_));
+        items_[i]->setPos(coordinates.x, coordinates.y);
+    }
+}
+
+void SceneObserver::subjectsCleared()
+{
+    for (QGraphicsPolygonItem *item : items_) {
+        scene_->removeItem(item);
+        delete item;
+    }
+    items_.clear();
+}
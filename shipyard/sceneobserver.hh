@@ -0,0 +1,79 @@
+#ifndef SCENEOBSERVER_HH
+#define SCENEOBSERVER_HH
+
+#include "simulationobserver.hh"
+#include <QGraphicsScene>
+#include <QGraphicsPolygonItem>
+#include <QPolygonF>
+#include <QTransform>
+#include <vector>
+
+/*!
+ * \class SceneObserver
+ * \brief Draws the subjects of a simulation onto a graphics scene.
+ * \author terratenff
+ */
+class SceneObserver: public SimulationObserver
+{
+public:
+
+    /*!
+     * \brief Constructor for an observer that draws onto a scene.
+     * \param scene Graphics scene (bound to the graphics view
+     * on the main window).
+     */
+    SceneObserver(QGraphicsScene *scene);
+
+    /*!
+     * \brief SceneObserver destructor. Removes the drawn subjects
+     * from the scene.
+     */
+    ~SceneObserver();
+
+    /*!
+     * \fn subjectsCreated
+     * \brief Places a polygon onto the scene for every subject.
+     * \param subjects Subjects of the simulation.
+     */
+    void subjectsCreated(const std::vector<SubjectCore*> &subjects);
+
+    /*!
+     * \fn subjectsUpdated
+     * \brief Moves the polygons to the subjects.
+     * \param subjects Subjects of the simulation.
+     */
+    void subjectsUpdated(const std::vector<SubjectCore*> &subjects);
+
+    /*!
+     * \fn subjectsCleared
+     * \brief Removes the polygons from the scene.
+     */
+    void subjectsCleared();
+private:
+
+    /*!
+     * \var scene_
+     * \brief Pointer to the scene present on the main window.
+     */
+    QGraphicsScene *scene_;
+
+    /*!
+     * \var polygonBase_
+     * \brief The model polygon of the subjects.
+     */
+    QPolygonF polygonBase_;
+
+    /*!
+     * \var t_
+     * \brief Transformation that rotates the polygons.
+     */
+    QTransform t_;
+
+    /*!
+     * \var items_
+     * \brief Polygon of each subject, in the order of the subjects.
+     */
+    std::vector<QGraphicsPolygonItem*> items_;
+};
+
+#endif // SCENEOBSERVER_HH
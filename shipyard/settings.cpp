@@ -33,10 +33,17 @@ Settings::Settings():
     activation_function_hidden_(SIGMOID),
     activation_function_output_(SIGMOID),
     breeding_method_(COPY),
+    crossover_method_(UNIFORM_CROSSOVER),
     population_retention_rate_(10),
     mutation_probability_(10),
     mutation_scale_minimum_(1.0),
-    mutation_scale_maximum_(2.0)
+    mutation_scale_maximum_(2.0),
+    network_precision_(DOUBLE_PRECISION),
+    fast_math_(false),
+    pruning_threshold_(0.0),
+    sparse_density_(0.0),
+    response_table_size_(0),
+    thread_count_(0)
 {
 }
 
@@ -55,6 +62,7 @@ void Settings::use_default_settings()
     fitness_type_ = CORRECT_ANGLE;
     hidden_layer_count_ = 2;
     hidden_neuron_count_ = 10;
+    hidden_layer_widths_.clear();
     initial_bias_ = 0;
 
     iteration_count_ = 1000;
@@ -82,10 +90,16 @@ void Settings::use_default_settings()
     activation_function_hidden_ = SIGMOID;
     activation_function_output_ = SIGMOID;
     breeding_method_ = COPY;
+    crossover_method_ = UNIFORM_CROSSOVER;
     population_retention_rate_ = 10;
     mutation_probability_ = 10;
     mutation_scale_minimum_ = 1.0;
     mutation_scale_maximum_ = 2.0;
+    network_precision_ = DOUBLE_PRECISION;
+    fast_math_ = false;
+    pruning_threshold_ = 0.0;
+    sparse_density_ = 0.0;
+    response_table_size_ = 0;
 }
 
 void Settings::set_input_type(input_type type)
@@ -113,6 +127,12 @@ void Settings::set_hidden_neuron_count(unsigned int count)
     hidden_neuron_count_ = count;
 }
 
+void Settings::set_hidden_layer_widths(
+        const std::vector<unsigned int> &widths)
+{
+    hidden_layer_widths_ = widths;
+}
+
 void Settings::set_initial_bias(int var)
 {
     initial_bias_ = var;
@@ -163,6 +183,11 @@ unsigned int Settings::get_hidden_neuron_count() const
     return hidden_neuron_count_;
 }
 
+const std::vector<unsigned int> &Settings::get_hidden_layer_widths() const
+{
+    return hidden_layer_widths_;
+}
+
 int Settings::get_initial_bias() const
 {
     return initial_bias_;
@@ -363,6 +388,11 @@ void Settings::set_breeding_method(breeding_type type)
     breeding_method_ = type;
 }
 
+void Settings::set_crossover_method(crossover_type type)
+{
+    crossover_method_ = type;
+}
+
 void Settings::set_population_retention_rate(int var)
 {
     population_retention_rate_ = var;
@@ -383,6 +413,36 @@ void Settings::set_mutation_scale_maximum(double var)
     mutation_scale_maximum_ = var;
 }
 
+void Settings::set_network_precision(precision_type type)
+{
+    network_precision_ = type;
+}
+
+void Settings::set_fast_math(bool var)
+{
+    fast_math_ = var;
+}
+
+void Settings::set_pruning_threshold(double var)
+{
+    pruning_threshold_ = var;
+}
+
+void Settings::set_sparse_density(double var)
+{
+    sparse_density_ = var;
+}
+
+void Settings::set_response_table_size(unsigned int size)
+{
+    response_table_size_ = size;
+}
+
+void Settings::set_thread_count(unsigned int count)
+{
+    thread_count_ = count;
+}
+
 double Settings::get_initial_weight_minimum() const
 {
     return initial_weight_minimum_;
@@ -408,6 +468,11 @@ breeding_type Settings::get_breeding_method() const
     return breeding_method_;
 }
 
+crossover_type Settings::get_crossover_method() const
+{
+    return crossover_method_;
+}
+
 int Settings::get_population_retention_rate() const
 {
     return population_retention_rate_;
@@ -427,3 +492,33 @@ double Settings::get_mutation_scale_maximum() const
 {
     return mutation_scale_maximum_;
 }
+
+precision_type Settings::get_network_precision() const
+{
+    return network_precision_;
+}
+
+bool Settings::get_fast_math() const
+{
+    return fast_math_;
+}
+
+double Settings::get_pruning_threshold() const
+{
+    return pruning_threshold_;
+}
+
+double Settings::get_sparse_density() const
+{
+    return sparse_density_;
+}
+
+unsigned int Settings::get_response_table_size() const
+{
+    return response_table_size_;
+}
+
+unsigned int Settings::get_thread_count() const
+{
+    return thread_count_;
+}
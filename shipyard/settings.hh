@@ -1,6 +1,8 @@
 #ifndef SETTINGS_HH
 #define SETTINGS_HH
 
+#include <vector>
+
 /*!
  * \enum input_type
  * \brief Enums that represent various input types.
@@ -93,6 +95,30 @@ enum breeding_type {
     NO_BREEDING
 };
 
+/*!
+ * \enum crossover_type
+ * \brief Enums that represent the ways in which the weights of
+ * two or three parents are combined into a child.
+ * \author terratenff
+ */
+enum crossover_type {
+    UNIFORM_CROSSOVER,
+    SINGLE_POINT_CROSSOVER,
+    LAYER_CROSSOVER
+};
+
+/*!
+ * \enum precision_type
+ * \brief Enums that represent the numeric precision used by the
+ * neural networks during inference.
+ * \author terratenff
+ */
+enum precision_type {
+    DOUBLE_PRECISION,
+    SINGLE_PRECISION,
+    QUANTIZED_PRECISION
+};
+
 /*!
  * \class Settings
  * \brief Application-wide settings.
@@ -171,6 +197,19 @@ public:
      */
     void set_hidden_neuron_count(unsigned int count);
 
+    /*!
+     * \fn set_hidden_layer_widths
+     * \brief Setter for the width of each hidden layer.
+     *
+     * If any widths are given, they replace the hidden layer count and
+     * the hidden neuron count, so that each hidden layer can have a
+     * width of its own (e.g. 32, 16, 8).
+     *
+     * \param widths Target number of neurons in each hidden layer.
+     * Empty to use the hidden layer count and hidden neuron count.
+     */
+    void set_hidden_layer_widths(const std::vector<unsigned int> &widths);
+
     /*!
      * \fn set_initial_bias
      * \brief Setter for the initial bias.
@@ -289,6 +328,18 @@ public:
      */
     unsigned int get_hidden_neuron_count() const;
 
+    /*!
+     * \fn get_hidden_layer_widths
+     * \brief Getter for the width of each hidden layer.
+     *
+     * If any widths are given, they replace the hidden layer count and
+     * the hidden neuron count.
+     *
+     * \return Current number of neurons in each hidden layer. Empty,
+     * if every hidden layer has the hidden neuron count.
+     */
+    const std::vector<unsigned int> &get_hidden_layer_widths() const;
+
     /*!
      * \fn get_initial_bias
      * \brief Getter for the initial bias.
@@ -809,6 +860,19 @@ public:
      */
     void set_breeding_method(breeding_type type);
 
+    /*!
+     * \fn set_crossover_method
+     * \brief Setter for the crossover method.
+     *
+     * Breeding methods with two or three parents combine the weights
+     * of the parents into a child. The crossover method determines
+     * whether the parent is picked for every weight separately, for
+     * consecutive runs of weights or for whole layers.
+     *
+     * \param type Target crossover method.
+     */
+    void set_crossover_method(crossover_type type);
+
     /*!
      * \fn set_population_retention_rate
      * \brief Setter for population retention rate.
@@ -862,6 +926,86 @@ public:
      */
     void set_mutation_scale_maximum(double var);
 
+    /*!
+     * \fn set_network_precision
+     * \brief Setter for neural network precision.
+     *
+     * Neural networks always mutate and breed in double precision.
+     * Precision determines the floating point type that the networks
+     * use for their weights and neurons while processing inputs into
+     * outputs. Single precision halves the memory used during
+     * processing at the cost of accuracy. Quantized precision stores
+     * the weights as 8-bit integers with a scale per layer, which
+     * cuts the memory to an eighth.
+     *
+     * \param type Target precision.
+     */
+    void set_network_precision(precision_type type);
+
+    /*!
+     * \fn set_fast_math
+     * \brief Setter for fast math.
+     *
+     * With fast math, activation functions sigmoid, hyperbolic
+     * tangent, gaussian and softmax use fast approximations of the
+     * exponential function that process whole layers at once.
+     *
+     * \param var true to use fast math.
+     */
+    void set_fast_math(bool var);
+
+    /*!
+     * \fn set_pruning_threshold
+     * \brief Setter for pruning threshold.
+     *
+     * Between generations, the weights of every neural network whose
+     * magnitude is below the pruning threshold are set to zero.
+     * Threshold 0 disables pruning.
+     *
+     * \param var Target pruning threshold.
+     */
+    void set_pruning_threshold(double var);
+
+    /*!
+     * \fn set_sparse_density
+     * \brief Setter for sparse density.
+     *
+     * In double precision, a layer whose share of nonzero weights is
+     * below the sparse density is processed with a sparse kernel that
+     * skips the zero weights. Density 0 disables sparse processing.
+     *
+     * \param var Target sparse density, between 0 and 1.
+     */
+    void set_sparse_density(double var);
+
+    /*!
+     * \fn set_response_table_size
+     * \brief Setter for response table size.
+     *
+     * Neural networks with a single input (angular difference, total
+     * space difference or no input) are functions of one value
+     * between 0 and 1. Once per generation, such networks can be
+     * sampled at evenly spaced points into a response table, which
+     * then replaces the network: outputs are interpolated linearly
+     * between the two nearest samples. Size 0 disables response tables.
+     *
+     * \param size Target number of samples, at least 2.
+     */
+    void set_response_table_size(unsigned int size);
+
+    /*!
+     * \fn set_thread_count
+     * \brief Setter for thread count.
+     *
+     * Subjects are updated in chunks of networks that fit into the
+     * cache, and chunks are spread over this many threads. Results do
+     * not depend on the number of threads, so it is not part of a
+     * scenario and default settings leave it as it is.
+     *
+     * \param count Target number of threads, 0 for one per core.
+     */
+    void set_thread_count(unsigned int count);
+
     /*!
      * \fn get_initial_weight_minimum
      * \brief Getter for minimum initial weight.
@@ -921,6 +1065,19 @@ public:
      */
     breeding_type get_breeding_method() const;
 
+    /*!
+     * \fn get_crossover_method
+     * \brief Getter for the crossover method.
+     *
+     * Breeding methods with two or three parents combine the weights
+     * of the parents into a child. The crossover method determines
+     * whether the parent is picked for every weight separately, for
+     * consecutive runs of weights or for whole layers.
+     *
+     * \return Current crossover method.
+     */
+    crossover_type get_crossover_method() const;
+
     /*!
      * \fn get_population_retention_rate
      * \brief Getter for population retention rate.
@@ -974,6 +1131,86 @@ public:
      */
     double get_mutation_scale_maximum() const;
 
+    /*!
+     * \fn get_network_precision
+     * \brief Getter for neural network precision.
+     *
+     * Neural networks always mutate and breed in double precision.
+     * Precision determines the floating point type that the networks
+     * use for their weights and neurons while processing inputs into
+     * outputs. Single precision halves the memory used during
+     * processing at the cost of accuracy. Quantized precision stores
+     * the weights as 8-bit integers with a scale per layer, which
+     * cuts the memory to an eighth.
+     *
+     * \return Current precision.
+     */
+    precision_type get_network_precision() const;
+
+    /*!
+     * \fn get_fast_math
+     * \brief Getter for fast math.
+     *
+     * With fast math, activation functions sigmoid, hyperbolic
+     * tangent, gaussian and softmax use fast approximations of the
+     * exponential function that process whole layers at once.
+     *
+     * \return true, if fast math is in use.
+     */
+    bool get_fast_math() const;
+
+    /*!
+     * \fn get_pruning_threshold
+     * \brief Getter for pruning threshold.
+     *
+     * Between generations, the weights of every neural network whose
+     * magnitude is below the pruning threshold are set to zero.
+     * Threshold 0 disables pruning.
+     *
+     * \return Current pruning threshold.
+     */
+    double get_pruning_threshold() const;
+
+    /*!
+     * \fn get_sparse_density
+     * \brief Getter for sparse density.
+     *
+     * In double precision, a layer whose share of nonzero weights is
+     * below the sparse density is processed with a sparse kernel that
+     * skips the zero weights. Density 0 disables sparse processing.
+     *
+     * \return Current sparse density.
+     */
+    double get_sparse_density() const;
+
+    /*!
+     * \fn get_response_table_size
+     * \brief Getter for response table size.
+     *
+     * Neural networks with a single input (angular difference, total
+     * space difference or no input) are functions of one value
+     * between 0 and 1. Once per generation, such networks can be
+     * sampled at evenly spaced points into a response table, which
+     * then replaces the network: outputs are interpolated linearly
+     * between the two nearest samples. Size 0 disables response tables.
+     *
+     * \return Current number of samples.
+     */
+    unsigned int get_response_table_size() const;
+
+    /*!
+     * \fn get_thread_count
+     * \brief Getter for thread count.
+     *
+     * Subjects are updated in chunks of networks that fit into the
+     * cache, and chunks are spread over this many threads. Results do
+     * not depend on the number of threads, so it is not part of a
+     * scenario and default settings leave it as it is.
+     *
+     * \return Current number of threads, 0 for one per core.
+     */
+    unsigned int get_thread_count() const;
+
 private:
 
     /*!
@@ -1024,6 +1261,13 @@ private:
      */
     unsigned int hidden_neuron_count_;
 
+    /*!
+     * \var hidden_layer_widths_
+     * \brief Number of neurons within each hidden layer. Empty, if
+     * every hidden layer has hidden_neuron_count_ neurons.
+     */
+    std::vector<unsigned int> hidden_layer_widths_;
+
     /*!
      * \var initial_bias_
      * \brief Bias for the neural networks.
@@ -1193,6 +1437,12 @@ private:
      */
     breeding_type breeding_method_;
 
+    /*!
+     * \var crossover_method_
+     * \brief Way of combining the weights of the parents.
+     */
+    crossover_type crossover_method_;
+
     /*!
      * \var population_retention_rate_
      * \brief The probability of a low-fitness subject being selected
@@ -1218,6 +1468,43 @@ private:
      * \brief The higher range value of a random mutation scale.
      */
     double mutation_scale_maximum_;
+
+    /*!
+     * \var network_precision_
+     * \brief Floating point precision of the neural networks
+     * during inference.
+     */
+    precision_type network_precision_;
+
+    /*!
+     * \var fast_math_
+     * \brief Whether activation functions use fast approximations.
+     */
+    bool fast_math_;
+
+    /*!
+     * \var pruning_threshold_
+     * \brief Magnitude below which weights are pruned.
+     */
+    double pruning_threshold_;
+
+    /*!
+     * \var sparse_density_
+     * \brief Density below which layers are processed as sparse.
+     */
+    double sparse_density_;
+
+    /*!
+     * \var response_table_size_
+     * \brief Number of samples in response tables.
+     */
+    unsigned int response_table_size_;
+
+    /*!
+     * \var thread_count_
+     * \brief Number of threads that update the subjects.
+     */
+    unsigned int thread_count_;
 };
 
 #endif // SETTINGS_HH
@@ -16,37 +16,23 @@ DEFINES += QT_DEPRECATED_WARNINGS
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
-    fitness.cpp \
     help/about.cpp \
     help/instructions.cpp \
-    inputoutput.cpp \
     main.cpp \
     mainwindow.cpp \
-    manager.cpp \
-    math.cpp \
     networkwindow.cpp \
-    neuralnetwork.cpp \
-    scenario.cpp \
-    settings.cpp \
+    sceneobserver.cpp \
     subject.cpp \
-    subjectcore.cpp \
     subjectwindow.cpp \
     target.cpp
 
 HEADERS += \
-    fitness.hh \
     help/about.hh \
     help/instructions.hh \
-    inputoutput.hh \
     mainwindow.hh \
-    manager.hh \
-    math.hh \
     networkwindow.hh \
-    neuralnetwork.hh \
-    scenario.hh \
-    settings.hh \
+    sceneobserver.hh \
     subject.hh \
-    subjectcore.hh \
     subjectwindow.hh \
     target.hh
 
@@ -57,6 +43,16 @@ FORMS += \
     networkwindow.ui \
     subjectwindow.ui
 
+win32:CONFIG(release, debug|release): LIBS += -L$$OUT_PWD/../core/release/ -lcore
+else:win32:CONFIG(debug, debug|release): LIBS += -L$$OUT_PWD/../core/debug/ -lcore
+else:unix: LIBS += -L$$OUT_PWD/../core/ -lcore
+
+win32-g++:CONFIG(release, debug|release): PRE_TARGETDEPS += $$OUT_PWD/../core/release/libcore.a
+else:win32-g++:CONFIG(debug, debug|release): PRE_TARGETDEPS += $$OUT_PWD/../core/debug/libcore.a
+else:win32:!win32-g++:CONFIG(release, debug|release): PRE_TARGETDEPS += $$OUT_PWD/../core/release/core.lib
+else:win32:!win32-g++:CONFIG(debug, debug|release): PRE_TARGETDEPS += $$OUT_PWD/../core/debug/core.lib
+else:unix: PRE_TARGETDEPS += $$OUT_PWD/../core/libcore.a
+
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
 else: unix:!android: target.path = /opt/$${TARGET}/bin
@@ -0,0 +1,112 @@
+#ifndef SIMULATIONOBSERVER_HH
+#define SIMULATIONOBSERVER_HH
+
+#include "subjectcore.hh"
+#include "neuralnetwork.hh"
+#include <vector>
+
+/*!
+ * \struct TransitionTiming
+ * \brief Time taken by the stages of a transition from a generation
+ * to the next, in seconds.
+ * \author terratenff
+ */
+struct TransitionTiming {
+
+    /*!
+     * \var generation
+     * \brief Number of the generation that ended.
+     */
+    unsigned int generation = 0;
+
+    /*!
+     * \var selection
+     * \brief Choosing the survivors and the parents of the children.
+     */
+    double selection = 0;
+
+    /*!
+     * \var breeding
+     * \brief Breeding and mutating the children.
+     */
+    double breeding = 0;
+
+    /*!
+     * \var restart
+     * \brief Placing the subjects and preparing the networks for the
+     * next generation.
+     */
+    double restart = 0;
+
+    /*!
+     * \var total
+     * \brief Whole transition.
+     */
+    double total = 0;
+};
+
+/*!
+ * \class SimulationObserver
+ * \brief Receives the subjects of a simulation as the manager creates,
+ * moves and deletes them. Simulations run without one just as well,
+ * e.g. when there is nothing to draw them on.
+ * \author terratenff
+ */
+class SimulationObserver
+{
+public:
+
+    /*!
+     * \brief ~SimulationObserver Destructor.
+     */
+    virtual ~SimulationObserver() {}
+
+    /*!
+     * \fn subjectsCreated
+     * \brief Called after the subjects of a simulation have been
+     * created and placed.
+     * \param subjects Subjects of the simulation.
+     */
+    virtual void subjectsCreated(const std::vector<SubjectCore*> &subjects) = 0;
+
+    /*!
+     * \fn subjectsUpdated
+     * \brief Called after every update of the simulation.
+     * \param subjects Subjects of the simulation.
+     */
+    virtual void subjectsUpdated(const std::vector<SubjectCore*> &subjects) = 0;
+
+    /*!
+     * \fn generationFinished
+     * \brief Called at the end of every generation, before the
+     * networks are bred into the next one. Does nothing by default.
+     * \param generation Number of the generation that ended.
+     * \param networks Networks of the generation, sorted from the
+     * fittest to the least fit.
+     */
+    virtual void generationFinished(unsigned int generation,
+                                    const std::vector<NeuralNetwork*> &networks)
+    {
+        (void) generation;
+        (void) networks;
+    }
+
+    /*!
+     * \fn transitionFinished
+     * \brief Called once the next generation is ready to start, with
+     * the time that getting it ready took. Does nothing by default.
+     * \param timing Time taken by each stage.
+     */
+    virtual void transitionFinished(const TransitionTiming &timing)
+    {
+        (void) timing;
+    }
+
+    /*!
+     * \fn subjectsCleared
+     * \brief Called before the subjects of a simulation are deleted.
+     */
+    virtual void subjectsCleared() = 0;
+};
+
+#endif // SIMULATIONOBSERVER_HH
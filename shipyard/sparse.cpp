@@ -0,0 +1,122 @@
+#include "sparse.hh"
+#include <cmath>
+
+size_t prune_weights(WeightSet &weights, double threshold)
+{
+    size_t pruned = 0;
+    for (unsigned int i = 0; i < weights.layerCount(); i++) {
+        for (unsigned int j = 0; j < weights.rows(i); j++) {
+            size_t candidates = 0;
+            const double *row = weights.row(i, j);
+            for (unsigned int k = 0; k < weights.columns(i); k++) {
+                if (row[k] != 0 && std::fabs(row[k]) < threshold) candidates++;
+            }
+            if (candidates == 0) continue;
+
+            double *target = weights.mutableRow(i, j);
+            for (unsigned int k = 0; k < weights.columns(i); k++) {
+                if (std::fabs(target[k]) < threshold) target[k] = 0;
+            }
+            pruned += candidates;
+        }
+    }
+    return pruned;
+}
+
+void sparse_layer(const double *values,
+                  const unsigned int *columnIndices,
+                  const unsigned int *rowStarts,
+                  unsigned int rows,
+                  const double *input,
+                  const double *bias,
+                  double *output)
+{
+    for (unsigned int j = 0; j < rows; j++) {
+        double sum = bias[j];
+        for (unsigned int n = rowStarts[j]; n < rowStarts[j + 1]; n++) {
+            sum += values[n] * input[columnIndices[n]];
+        }
+        output[j] = sum;
+    }
+}
+
+SparseWeightSet::SparseWeightSet()
+{
+}
+
+void SparseWeightSet::compress(const WeightSet &weights, double densityLimit)
+{
+    unsigned int layerCount = weights.layerCount();
+    densities_.assign(layerCount, 1);
+    sparse_.assign(layerCount, false);
+    values_.resize(layerCount);
+    column_indices_.resize(layerCount);
+    row_starts_.resize(layerCount);
+    if (!(densityLimit > 0)) return;
+
+    for (unsigned int i = 0; i < layerCount; i++) {
+        unsigned int rows = weights.rows(i);
+        unsigned int columns = weights.columns(i);
+        size_t total = static_cast<size_t>(rows) * columns;
+        if (total == 0) continue;
+
+        size_t nonzero = 0;
+        for (unsigned int j = 0; j < rows; j++) {
+            const double *row = weights.row(i, j);
+            for (unsigned int k = 0; k < columns; k++) {
+                if (row[k] != 0) nonzero++;
+            }
+        }
+        densities_[i] = static_cast<double>(nonzero) / total;
+        if (!(densities_[i] < densityLimit)) continue;
+        sparse_[i] = true;
+
+        // Reserving room for a full block means that the storage
+        // never has to grow again for this layout.
+        vector<double> &values = values_[i];
+        vector<unsigned int> &columnIndices = column_indices_[i];
+        vector<unsigned int> &rowStarts = row_starts_[i];
+        values.reserve(total);
+        columnIndices.reserve(total);
+        rowStarts.reserve(rows + 1);
+        values.clear();
+        columnIndices.clear();
+        rowStarts.clear();
+
+        for (unsigned int j = 0; j < rows; j++) {
+            rowStarts.push_back(static_cast<unsigned int>(values.size()));
+            const double *row = weights.row(i, j);
+            for (unsigned int k = 0; k < columns; k++) {
+                if (row[k] == 0) continue;
+                values.push_back(row[k]);
+                columnIndices.push_back(k);
+            }
+        }
+        rowStarts.push_back(static_cast<unsigned int>(values.size()));
+    }
+}
+
+bool SparseWeightSet::isSparse(unsigned int layer) const
+{
+    return layer < sparse_.size() && sparse_[layer];
+}
+
+double SparseWeightSet::getDensity(unsigned int layer) const
+{
+    return densities_[layer];
+}
+
+const double *SparseWeightSet::values(unsigned int layer) const
+{
+    return values_[layer].data();
+}
+
+const unsigned int *SparseWeightSet::columnIndices(unsigned int layer) const
+{
+    return column_indices_[layer].data();
+}
+
+const unsigned int *SparseWeightSet::rowStarts(unsigned int layer) const
+{
+    return row_starts_[layer].data();
+}
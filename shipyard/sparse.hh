@@ -0,0 +1,153 @@
+#ifndef SPARSE_HH
+#define SPARSE_HH
+
+#include "weightset.hh"
+
+/*!
+ * \file sparse.hh
+ * \brief Sparse representation of weights and magnitude pruning.
+ *
+ * Pruning sets the weights of small magnitude to zero. Weight blocks
+ * that end up mostly zero can then be stored in compressed sparse
+ * row (CSR) form, where every row keeps only its nonzero weights
+ * along with their column indices, and processed with a kernel that
+ * skips the zeros altogether.
+ * \author terratenff
+ */
+
+/*!
+ * \fn prune_weights
+ * \brief Sets every weight whose magnitude is below the threshold
+ * to zero. Groups of weights with nothing to prune are left
+ * untouched, so they stay shared with any copies (see weightset.hh).
+ * \param weights Target weights.
+ * \param threshold Magnitude below which weights are pruned.
+ * \return Number of nonzero weights that were pruned.
+ */
+size_t prune_weights(WeightSet &weights, double threshold);
+
+/*!
+ * \fn sparse_layer
+ * \brief Computes output[j] = bias[j] + sum(weights[j][k] * input[k])
+ * for every row j of a weight block in CSR form. Equivalent to
+ * dense_layer (see layerkernel.hh) for the same weights.
+ * \param values Nonzero weights, row by row.
+ * \param columnIndices Column of each nonzero weight.
+ * \param rowStarts Position of the first nonzero weight of each
+ * row, followed by the total number of nonzero weights.
+ * \param rows Number of rows (output neurons).
+ * \param input Input neurons.
+ * \param bias Bias of each output neuron, at least "rows" of them.
+ * \param output Output neurons, at least "rows" of them.
+ */
+void sparse_layer(const double *values,
+                  const unsigned int *columnIndices,
+                  const unsigned int *rowStarts,
+                  unsigned int rows,
+                  const double *input,
+                  const double *bias,
+                  double *output);
+
+/*!
+ * \class SparseWeightSet
+ * \brief CSR copy of the weight blocks of a weight set whose density
+ * (share of nonzero weights) is below a given limit. Denser blocks
+ * are not stored.
+ * \author terratenff
+ */
+class SparseWeightSet
+{
+public:
+
+    /*!
+     * \brief Constructor for an empty sparse weight set.
+     */
+    SparseWeightSet();
+
+    /*!
+     * \fn compress
+     * \brief Replaces the contents with CSR copies of the sparse
+     * blocks of the given weights. Storage is reused, so memory is
+     * allocated only when the layout changes.
+     * \param weights Source weights.
+     * \param densityLimit Density below which a block is sparse.
+     * With limit 0 no block is.
+     */
+    void compress(const WeightSet &weights, double densityLimit);
+
+    /*!
+     * \fn isSparse
+     * \brief Checks whether a weight block is stored in CSR form.
+     * \param layer Target weight block.
+     * \return true, if the block was below the density limit.
+     */
+    bool isSparse(unsigned int layer) const;
+
+    /*!
+     * \fn getDensity
+     * \brief Getter for the density of a weight block.
+     * \param layer Target weight block.
+     * \return Share of nonzero weights, or 1 if the density limit
+     * was 0 and the block was not examined.
+     */
+    double getDensity(unsigned int layer) const;
+
+    /*!
+     * \fn values
+     * \brief Getter for the nonzero weights of a sparse block.
+     * \param layer Target weight block.
+     * \return Nonzero weights, row by row.
+     */
+    const double *values(unsigned int layer) const;
+
+    /*!
+     * \fn columnIndices
+     * \brief Getter for the columns of the nonzero weights of a
+     * sparse block.
+     * \param layer Target weight block.
+     * \return Column of each nonzero weight.
+     */
+    const unsigned int *columnIndices(unsigned int layer) const;
+
+    /*!
+     * \fn rowStarts
+     * \brief Getter for the row boundaries of a sparse block.
+     * \param layer Target weight block.
+     * \return Position of the first nonzero weight of each row,
+     * followed by the number of nonzero weights.
+     */
+    const unsigned int *rowStarts(unsigned int layer) const;
+private:
+
+    /*!
+     * \var densities_
+     * \brief Density of each weight block.
+     */
+    vector<double> densities_;
+
+    /*!
+     * \var sparse_
+     * \brief Whether each weight block is stored in CSR form.
+     */
+    vector<bool> sparse_;
+
+    /*!
+     * \var values_
+     * \brief Nonzero weights of each sparse block.
+     */
+    vector<vector<double> > values_;
+
+    /*!
+     * \var column_indices_
+     * \brief Columns of the nonzero weights of each sparse block.
+     */
+    vector<vector<unsigned int> > column_indices_;
+
+    /*!
+     * \var row_starts_
+     * \brief Row boundaries of each sparse block.
+     */
+    vector<vector<unsigned int> > row_starts_;
+};
+
+#endif // SPARSE_HH
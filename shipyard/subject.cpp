@@ -30,16 +30,21 @@ void Subject::setPolygon(QPolygonF polygon)
 
 void Subject::setDefaultPolygon()
 {
-    polygonBase_.clear();
-
-    polygonBase_ << QPointF(20, 0)
-                 << QPointF(-20, 8)
-                 << QPointF(-8, 0)
-                 << QPointF(-20, -8)
-                 << QPointF(20, 0);
+    polygonBase_ = defaultPolygon();
     polygon_ = polygonBase_;
 }
 
+QPolygonF Subject::defaultPolygon()
+{
+    QPolygonF polygon;
+    polygon << QPointF(20, 0)
+            << QPointF(-20, 8)
+            << QPointF(-8, 0)
+            << QPointF(-20, -8)
+            << QPointF(20, 0);
+    return polygon;
+}
+
 void Subject::update()
 {
     SubjectCore::update();
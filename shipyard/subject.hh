@@ -45,6 +45,13 @@ public:
      */
     void setDefaultPolygon();
 
+    /*!
+     * \fn defaultPolygon
+     * \brief Getter for the default subject shape.
+     * \return Default subject shape, facing angle 0.
+     */
+    static QPolygonF defaultPolygon();
+
     /*!
      * \fn update
      * \brief Updates the state of the subject, both data-wise
@@ -1,4 +1,5 @@
 #include "subjectcore.hh"
+#include <algorithm>
 
 SubjectCore *SubjectCore::primaryTarget_ = nullptr;
 SubjectCore *SubjectCore::secondaryTarget_ = nullptr;
@@ -22,6 +23,8 @@ void SubjectCore::setPublicInstance(SubjectCore *core, int role)
 
 SubjectCore::SubjectCore():
     nn_(nullptr),
+    input_encoding_(nullptr),
+    output_encoding_(nullptr),
     inputs_(Row()),
     outputs_(Row()),
     coordinates_(XY(0,0)),
@@ -41,35 +44,70 @@ SubjectCore::SubjectCore():
 
 SubjectCore::~SubjectCore()
 {
-    if (nn_ != nullptr) delete nn_;
 }
 
 void SubjectCore::update()
+{
+    // Steps 1-3: Check for a neural network, update movement and
+    //            create inputs for the neural network.
+    if (!prepareUpdate()) return;
+
+    // Step 4: Obtain outputs from the neural network.
+    nn_->feedForward(inputs_.data(),
+                     static_cast<unsigned int>(inputs_.size()),
+                     outputs_.data());
+
+    // Step 5: Customize outputs for proper use.
+    applyOutputs();
+
+    // Step 6: Check the state of the subject for
+    //         the fitness value update.
+    updateFitness();
+}
+
+bool SubjectCore::prepareUpdate()
 {
     // Step 1: Check if a neural network exists
     //         (Exceptions do not have a neural network).
-    if (nn_ == nullptr) return;
+    if (nn_ == nullptr) return false;
 
     // Step 2: Update movement.
     updateMovement();
 
     // Step 3: Create inputs for the neural network.
     makeInputs();
+    return true;
+}
 
-    // Step 4: Obtain outputs from the neural network.
-    outputs_ = nn_->feedForward(inputs_);
-
-    // Step 5: Customize outputs for proper use.
-    applyOutputs();
+void SubjectCore::finishUpdate(const double *outputs, unsigned int count)
+{
+    // Step 5: Customize outputs for proper use. Outputs of the
+    //         wrong size are ignored.
+    if (count == outputs_.size()) {
+        std::copy(outputs, outputs + count, outputs_.begin());
+        applyOutputs();
+    }
 
     // Step 6: Check the state of the subject for
     //         the fitness value update.
     updateFitness();
 }
 
+const Row &SubjectCore::getInputs() const
+{
+    return inputs_;
+}
+
 void SubjectCore::setNeuralNetwork(NeuralNetwork *nn)
 {
     nn_ = nn;
+    if (nn_ == nullptr) return;
+    input_encoding_ = &Encoding::input_encoding(nn_->getInputCode());
+    output_encoding_ = &Encoding::output_encoding(nn_->getOutputCode());
+
+    // Encoders and decoders work in place, on rows of fixed size.
+    inputs_.assign(input_encoding_->arity, 0.0);
+    outputs_.assign(output_encoding_->arity, 0.0);
 }
 
 NeuralNetwork *SubjectCore::getNeuralNetwork()
@@ -230,136 +268,16 @@ void SubjectCore::updateMovement()
 
 void SubjectCore::makeInputs()
 {
-    inputs_.clear();
-    if (primaryTarget_ == nullptr) return;
-    switch(nn_->getInputCode()) {
-
-    case ANGULAR_DIFFERENCE:
-        inputs_ = Input::angular_difference(
-                    getAngle(),
-                    getCoordinates(),
-                    primaryTarget_->getCoordinates());
-        break;
-
-    case SPACE_TOTAL_DIFFERENCE:
-        inputs_ = Input::space_scalar_difference(
-                    getCoordinates(),
-                    primaryTarget_->getCoordinates());
-        break;
-
-    case SPACE_AXIS_DIFFERENCE:
-        inputs_ = Input::space_axis_difference(
-                    getCoordinates(),
-                    primaryTarget_->getCoordinates());
-        break;
-
-    case WALL_DISTANCES:
-        inputs_ = Input::wall_distances(getCoordinates());
-        break;
-
-    case FOUR_WAY_SEARCH:
-        inputs_ = Input::four_way_search(
-                    getCoordinates(),
-                    primaryTarget_->getCoordinates());
-        break;
-
-    case FOUR_CORNER_SEARCH:
-        inputs_ = Input::four_corner_search(
-                    getCoordinates(),
-                    primaryTarget_->getCoordinates());
-        break;
-
-    case NO_INPUT:
-        inputs_ = Input::angular_difference(
-                    getAngle(),
-                    getCoordinates(),
-                    primaryTarget_->getCoordinates());
-        break;
+    if (primaryTarget_ == nullptr) {
+        std::fill(inputs_.begin(), inputs_.end(), 0.0);
+        return;
     }
+    input_encoding_->encode(*this, *primaryTarget_, inputs_.data());
 }
 
 void SubjectCore::applyOutputs()
 {
-    Row outputValues;
-
-    switch(nn_->getOutputCode()) {
-
-    case ANGULAR_VELOCITY:
-        if (outputs_.size() != 1) return;
-        outputValues = Output::angular_velocity(outputs_,
-                                                angular_velocity_factor_);
-        setAngularVelocity(outputValues[0]);
-        break;
-
-    case DIRECT_ANGLE:
-        if (outputs_.size() != 1) return;
-        outputValues = Output::direct_angle(outputs_);
-        setAngle(outputValues[0]);
-        break;
-
-    case ANGLE_VELOCITY:
-        if (outputs_.size() != 2) return;
-        outputValues = Output::angle_velocity(
-                    outputs_,
-                    angular_velocity_factor_,
-                    velocity_factor_);
-        setAngularVelocity(outputValues[0]);
-        setVelocity(outputValues[1]);
-        break;
-
-    case ANGLE_ACCELERATION:
-        if (outputs_.size() != 2) return;
-        outputValues = Output::angle_acceleration(
-                    outputs_,
-                    angular_velocity_factor_,
-                    acceleration_factor_);
-        setAngularVelocity(outputValues[0]);
-        setAcceleration(outputValues[1]);
-        break;
-
-    case AXIS_VELOCITY:
-        if (outputs_.size() != 2) return;
-        outputValues = Output::axis_velocity(outputs_,
-                                             axis_velocity_factor_);
-        setAxisVelocity(XY(outputValues[0], outputValues[1]));
-        break;
-
-    case AXIS_ACCELERATION:
-        if (outputs_.size() != 2) return;
-        outputValues = Output::axis_acceleration(outputs_,
-                                                 axis_acceleration_factor_);
-        setAxisAcceleration(XY(outputValues[0], outputValues[1]));
-        break;
-
-    case SMALL_HOPS:
-    {
-        if (outputs_.size() != 2) return;
-        outputValues = Output::small_hops(outputs_);
-        XY xy = getCoordinates();
-        setCoordinates(XY(xy.x + outputValues[0], xy.y + outputValues[1]));
-        setAngle(calculate_angle(XY(outputValues[0], outputValues[1])));
-        break;
-    }
-
-    case FIXED_MOVEMENT:
-    {
-        if (outputs_.size() != 4) return;
-        outputValues = Output::fixed_movement(outputs_);
-        double targetAngle = 0;
-        for (double i : outputValues) {
-            if (!near_zero(i)) {
-                setAngle(targetAngle);
-                break;
-            } else {
-                targetAngle += 90;
-            }
-        }
-        break;
-    }
-
-    case NO_OUTPUT:
-        break;
-    }
+    output_encoding_->decode(*this, outputs_.data());
 }
 
 void SubjectCore::updateFitness()
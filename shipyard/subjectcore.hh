@@ -5,10 +5,12 @@
 #include "neuralnetwork.hh"
 #include "fitness.hh"
 #include "inputoutput.hh"
+#include "encoding.hh"
 
 /*!
  * \class SubjectCore
- * \brief Data implementation of the subjects.
+ * \brief Data implementation of the subjects. Has no graphics, so
+ * simulations can be run with it alone.
  * \author terratenff
  */
 class SubjectCore
@@ -33,7 +35,7 @@ public:
     /*!
      * \brief ~SubjectCore Destructor.
      */
-    virtual ~SubjectCore() = 0;
+    virtual ~SubjectCore();
 
     /*!
      * \fn update
@@ -42,10 +44,37 @@ public:
      */
     virtual void update();
 
+    /*!
+     * \fn prepareUpdate
+     * \brief First half of an update: moves the subject and creates
+     * the inputs for its neural network. Used when the networks of
+     * the whole population are evaluated together.
+     * \return true, if the subject has a neural network whose
+     * outputs should be given to finishUpdate. false otherwise.
+     */
+    bool prepareUpdate();
+
+    /*!
+     * \fn finishUpdate
+     * \brief Second half of an update: applies given outputs of
+     * the neural network and updates the fitness value.
+     * \param outputs Outputs of the neural network.
+     * \param count Number of outputs.
+     */
+    void finishUpdate(const double *outputs, unsigned int count);
+
+    /*!
+     * \fn getInputs
+     * \brief Getter for the inputs created during the latest update.
+     * \return Inputs for the neural network.
+     */
+    const Row &getInputs() const;
+
     /*!
      * \fn setNeuralNetwork
      * \brief Setter for the neural network that the subject
-     * is going to use.
+     * is going to use. The subject does not take ownership. The input
+     * and output types of the network are resolved here, once.
      * \param nn Target neural network.
      */
     void setNeuralNetwork(NeuralNetwork *nn);
@@ -314,21 +343,36 @@ private:
     /*!
      * \var nn_
      * \brief The neural network that the subject is going
-     * to use during the simulations.
+     * to use during the simulations. Not owned by the subject:
+     * networks belong to the network pool of the manager.
      */
     NeuralNetwork *nn_;
 
+    /*!
+     * \var input_encoding_
+     * \brief Input type of the neural network, resolved when the
+     * neural network is set.
+     */
+    const InputEncoding *input_encoding_;
+
+    /*!
+     * \var output_encoding_
+     * \brief Output type of the neural network, resolved when the
+     * neural network is set.
+     */
+    const OutputEncoding *output_encoding_;
+
     /*!
      * \var inputs_
      * \brief Row of inputs that the subject creates for its
-     * neural network to process.
+     * neural network to process. Sized when the network is set.
      */
     Row inputs_;
 
     /*!
      * \var outputs_
      * \brief Row of outputs that the subject's neural network creates
-     * for the subject to process.
+     * for the subject to process. Sized when the network is set.
      */
     Row outputs_;
 
@@ -432,7 +476,7 @@ private:
     /*!
      * \fn makeInputs
      * \brief Creates suitable inputs for the subject's neural network
-     * to process.
+     * to process. Without a primary target, the inputs are zeros.
      */
     void makeInputs();
 
@@ -0,0 +1,197 @@
+#include "threadpool.hh"
+
+namespace
+{
+    typedef std::chrono::steady_clock clock_type;
+
+    double seconds_since(clock_type::time_point start)
+    {
+        return std::chrono::duration<double>(clock_type::now() - start)
+                .count();
+    }
+}
+
+ThreadPool::ThreadPool(unsigned int threads):
+    function_(nullptr),
+    context_(nullptr),
+    queues_(new WorkerQueue[1]),
+    elapsed_(0),
+    round_(0),
+    busy_(0),
+    stopping_(false)
+{
+    setThreadCount(threads);
+}
+
+ThreadPool::~ThreadPool()
+{
+    stop();
+}
+
+void ThreadPool::setThreadCount(unsigned int threads)
+{
+    if (threads == 0) threads = hardware_threads();
+    if (threads == getThreadCount()) return;
+
+    stop();
+    stopping_ = false;
+    queues_.reset(new WorkerQueue[threads]);
+    elapsed_ = 0;
+    for (unsigned int worker = 1; worker < threads; worker++) {
+        threads_.emplace_back(&ThreadPool::loop, this, worker, round_);
+    }
+}
+
+unsigned int ThreadPool::getThreadCount() const
+{
+    return static_cast<unsigned int>(threads_.size()) + 1;
+}
+
+std::vector<WorkerStatistics> ThreadPool::getStatistics() const
+{
+    std::vector<WorkerStatistics> statistics;
+    for (unsigned int worker = 0; worker < getThreadCount(); worker++) {
+        WorkerStatistics counters = queues_[worker].statistics;
+        counters.utilization = elapsed_ > 0 ? counters.busy / elapsed_ : 0;
+        statistics.push_back(counters);
+    }
+    return statistics;
+}
+
+void ThreadPool::resetStatistics()
+{
+    for (unsigned int worker = 0; worker < getThreadCount(); worker++) {
+        queues_[worker].statistics = WorkerStatistics();
+    }
+    elapsed_ = 0;
+}
+
+unsigned int ThreadPool::hardware_threads()
+{
+    unsigned int threads = std::thread::hardware_concurrency();
+    return threads > 0 ? threads : 1;
+}
+
+void ThreadPool::runTasks(unsigned int count,
+                          task_function function,
+                          void *context)
+{
+    clock_type::time_point start = clock_type::now();
+
+    // A single task is not worth waking anyone up for.
+    if (threads_.empty() || count <= 1) {
+        WorkerStatistics &statistics = queues_[0].statistics;
+        for (unsigned int i = 0; i < count; i++) function(context, i, 0);
+        statistics.tasks += count;
+        statistics.busy += seconds_since(start);
+        elapsed_ += seconds_since(start);
+        return;
+    }
+
+    // Every worker starts with an equal share of the tasks.
+    unsigned int workers = getThreadCount();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (unsigned int worker = 0; worker < workers; worker++) {
+            queues_[worker].first = static_cast<unsigned int>(
+                        static_cast<unsigned long>(count) * worker / workers);
+            queues_[worker].last = static_cast<unsigned int>(
+                        static_cast<unsigned long>(count) * (worker + 1)
+                        / workers);
+        }
+        function_ = function;
+        context_ = context;
+        busy_ = static_cast<unsigned int>(threads_.size());
+        round_++;
+    }
+    wake_.notify_all();
+
+    work(0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return busy_ == 0; });
+    elapsed_ += seconds_since(start);
+}
+
+void ThreadPool::work(unsigned int worker)
+{
+    WorkerStatistics &statistics = queues_[worker].statistics;
+    unsigned int task;
+    for (;;) {
+        if (pop(worker, task)) {
+            clock_type::time_point start = clock_type::now();
+            function_(context_, task, worker);
+            statistics.busy += seconds_since(start);
+            statistics.tasks++;
+        } else if (steal(worker)) {
+            statistics.steals++;
+        } else {
+            return;
+        }
+    }
+}
+
+bool ThreadPool::pop(unsigned int worker, unsigned int &task)
+{
+    WorkerQueue &queue = queues_[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.first == queue.last) return false;
+    task = queue.first++;
+    return true;
+}
+
+bool ThreadPool::steal(unsigned int worker)
+{
+    // Tasks never create new tasks, so once every queue has been seen
+    // empty, there is nothing left to steal.
+    unsigned int workers = getThreadCount();
+    for (unsigned int i = 1; i < workers; i++) {
+        WorkerQueue &victim = queues_[(worker + i) % workers];
+        unsigned int first;
+        unsigned int last;
+        {
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.first == victim.last) continue;
+            last = victim.last;
+            first = victim.first + (victim.last - victim.first) / 2;
+            victim.last = first;
+        }
+
+        WorkerQueue &queue = queues_[worker];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.first = first;
+        queue.last = last;
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::loop(unsigned int worker, unsigned long seen)
+{
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this, seen] {
+                return stopping_ || round_ != seen;
+            });
+            if (stopping_) return;
+            seen = round_;
+        }
+
+        work(worker);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--busy_ == 0) done_.notify_one();
+    }
+}
+
+void ThreadPool::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread &thread : threads_) thread.join();
+    threads_.clear();
+}
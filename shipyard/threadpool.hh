@@ -0,0 +1,290 @@
+#ifndef THREADPOOL_HH
+#define THREADPOOL_HH
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/*!
+ * \struct WorkerStatistics
+ * \brief Counters of a single worker of a thread pool, for checking
+ * how evenly the work is spread.
+ * \author terratenff
+ */
+struct WorkerStatistics {
+
+    /*!
+     * \var tasks
+     * \brief Number of tasks run.
+     */
+    unsigned long tasks = 0;
+
+    /*!
+     * \var steals
+     * \brief Number of times that tasks were stolen from another
+     * worker.
+     */
+    unsigned long steals = 0;
+
+    /*!
+     * \var busy
+     * \brief Seconds spent running tasks.
+     */
+    double busy = 0;
+
+    /*!
+     * \var utilization
+     * \brief Share of the time spent in ThreadPool::run() that went
+     * into running tasks, between 0 and 1.
+     */
+    double utilization = 0;
+};
+
+/*!
+ * \class ThreadPool
+ * \brief Persistent worker threads that run numbered tasks in
+ * parallel, stealing work from each other.
+ *
+ * The threads are created once and sleep between calls to run(), so
+ * that a simulation can hand out work on every iteration without
+ * starting threads. The calling thread takes part in the work as
+ * worker 0.
+ *
+ * Each worker has a queue of its own, which starts out with an equal
+ * share of the tasks as a range of task numbers. A worker takes tasks
+ * from the front of its queue. Once its queue runs dry, it steals the
+ * back half of another worker's queue, so that workers that got cheap
+ * tasks help those that got expensive ones.
+ *
+ * Which worker runs which task varies from call to call: tasks must
+ * not depend on each other, and results that have to be reproducible
+ * must depend only on the task number.
+ *
+ * \author terratenff
+ */
+class ThreadPool
+{
+public:
+
+    /*!
+     * \brief Constructor for a thread pool.
+     * \param threads Number of threads, including the calling thread.
+     * 0 means one per processor core.
+     */
+    ThreadPool(unsigned int threads = 1);
+
+    /*!
+     * \brief ~ThreadPool Destructor. Stops and joins the threads.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /*!
+     * \fn setThreadCount
+     * \brief Setter for the number of threads. Threads are only
+     * restarted if the number changes.
+     * \param threads Number of threads, including the calling thread.
+     * 0 means one per processor core.
+     */
+    void setThreadCount(unsigned int threads);
+
+    /*!
+     * \fn getThreadCount
+     * \brief Getter for the number of threads.
+     * \return Number of threads, including the calling thread.
+     */
+    unsigned int getThreadCount() const;
+
+    /*!
+     * \fn run
+     * \brief Runs tasks 0, 1, ..., count - 1 and waits for all of
+     * them to finish. Does not allocate memory.
+     * \param count Number of tasks.
+     * \param task Callable as task(index, worker), where worker is
+     * the number of the thread running the task, below
+     * getThreadCount().
+     */
+    template <typename Task>
+    void run(unsigned int count, Task &&task)
+    {
+        typedef typename std::remove_reference<Task>::type Type;
+        void *context = const_cast<void*>(static_cast<const void*>(&task));
+        runTasks(count, &ThreadPool::invoke<Type>, context);
+    }
+
+    /*!
+     * \fn getStatistics
+     * \brief Getter for the counters of each worker since the pool was
+     * created or the counters were reset.
+     * \return Counters of workers 0, 1, ...
+     */
+    std::vector<WorkerStatistics> getStatistics() const;
+
+    /*!
+     * \fn resetStatistics
+     * \brief Sets the counters of every worker to zero.
+     */
+    void resetStatistics();
+
+    /*!
+     * \fn hardware_threads
+     * \brief Getter for the number of processor cores.
+     * \return Number of hardware threads, at least 1.
+     */
+    static unsigned int hardware_threads();
+private:
+
+    /*!
+     * \brief Type-erased task: context, task index, worker.
+     */
+    typedef void (*task_function)(void *, unsigned int, unsigned int);
+
+    /*!
+     * \fn invoke
+     * \brief Calls a task of given type through its type-erased form.
+     */
+    template <typename Task>
+    static void invoke(void *context, unsigned int index, unsigned int worker)
+    {
+        (*static_cast<Task*>(context))(index, worker);
+    }
+
+    /*!
+     * \fn runTasks
+     * \brief Hands the tasks to the threads and takes part as worker 0.
+     * \param count Number of tasks.
+     * \param function Type-erased task.
+     * \param context Task object.
+     */
+    void runTasks(unsigned int count, task_function function, void *context);
+
+    /*!
+     * \struct WorkerQueue
+     * \brief Tasks waiting for a worker, as a range of task numbers,
+     * and the counters of the worker. Aligned to a cache line of its
+     * own, so that the workers do not slow each other down.
+     */
+    struct alignas(64) WorkerQueue {
+        std::mutex mutex;
+        unsigned int first = 0;
+        unsigned int last = 0;
+        WorkerStatistics statistics;
+    };
+
+    /*!
+     * \fn work
+     * \brief Runs tasks until none are left in any queue.
+     * \param worker Number of the running thread.
+     */
+    void work(unsigned int worker);
+
+    /*!
+     * \fn pop
+     * \brief Takes the task at the front of a worker's own queue.
+     * \param worker Number of the worker.
+     * \param task Number of the task taken.
+     * \return true if there was a task.
+     */
+    bool pop(unsigned int worker, unsigned int &task);
+
+    /*!
+     * \fn steal
+     * \brief Moves the back half of another worker's queue into the
+     * queue of given worker.
+     * \param worker Number of the stealing worker.
+     * \return true if something was stolen, false if every queue is
+     * empty.
+     */
+    bool steal(unsigned int worker);
+
+    /*!
+     * \fn loop
+     * \brief Main loop of a worker thread: sleeps until there are
+     * tasks, runs them and reports back.
+     * \param worker Number of the thread.
+     * \param seen Last round that the thread is not part of.
+     */
+    void loop(unsigned int worker, unsigned long seen);
+
+    /*!
+     * \fn stop
+     * \brief Stops and joins the threads.
+     */
+    void stop();
+
+    /*!
+     * \var threads_
+     * \brief Worker threads 1, 2, ... (the caller is worker 0).
+     */
+    std::vector<std::thread> threads_;
+
+    /*!
+     * \var mutex_
+     * \brief Guards the state shared with the sleeping threads.
+     */
+    std::mutex mutex_;
+
+    /*!
+     * \var wake_
+     * \brief Wakes the threads up for a new round of tasks.
+     */
+    std::condition_variable wake_;
+
+    /*!
+     * \var done_
+     * \brief Wakes the caller up once every thread has finished.
+     */
+    std::condition_variable done_;
+
+    /*!
+     * \var function_
+     * \brief Type-erased task of the current round.
+     */
+    task_function function_;
+
+    /*!
+     * \var context_
+     * \brief Task object of the current round.
+     */
+    void *context_;
+
+    /*!
+     * \var queues_
+     * \brief Queue of each worker, the caller's included.
+     */
+    std::unique_ptr<WorkerQueue[]> queues_;
+
+    /*!
+     * \var elapsed_
+     * \brief Seconds spent in run() since the counters were reset.
+     */
+    double elapsed_;
+
+    /*!
+     * \var round_
+     * \brief Number of the current round, so that the threads can
+     * tell a new round from a spurious wake-up.
+     */
+    unsigned long round_;
+
+    /*!
+     * \var busy_
+     * \brief Number of threads still working on the current round.
+     * Queues only change hands once it is back to zero.
+     */
+    unsigned int busy_;
+
+    /*!
+     * \var stopping_
+     * \brief Whether the threads should exit.
+     */
+    bool stopping_;
+};
+
+#endif // THREADPOOL_HH
@@ -0,0 +1,294 @@
+#include "weightset.hh"
+#include <algorithm>
+#include <atomic>
+
+template <typename T>
+BasicWeightSet<T>::BasicWeightSet()
+{
+}
+
+template <typename T>
+BasicWeightSet<T>::BasicWeightSet(const vector<unsigned int> &layers)
+{
+    vector<unsigned int> rows;
+    vector<unsigned int> columns;
+    for (unsigned int i = 1; i < layers.size(); i++) {
+        rows.push_back(layers[i]);
+        columns.push_back(layers[i - 1]);
+    }
+    *this = BasicWeightSet<T>(rows, columns);
+}
+
+template <typename T>
+BasicWeightSet<T>::BasicWeightSet(const vector<unsigned int> &rows,
+                                  const vector<unsigned int> &columns):
+    rows_(rows),
+    columns_(columns)
+{
+    first_groups_.push_back(0);
+    for (unsigned int i = 0; i < rows_.size(); i++) {
+        unsigned int stride = padded(columns_[i]);
+        size_t rowBytes = stride * sizeof(T);
+        unsigned int groupRows = rowBytes < WEIGHT_GROUP_BYTES
+                ? static_cast<unsigned int>(WEIGHT_GROUP_BYTES / rowBytes)
+                : 1;
+        strides_.push_back(stride);
+        group_rows_.push_back(groupRows);
+
+        for (unsigned int j = 0; j < rows_[i]; j += groupRows) {
+            unsigned int count = std::min(groupRows, rows_[i] - j);
+            groups_.push_back(make_shared<AlignedVector<T> >(
+                                  static_cast<size_t>(count) * stride, 0));
+        }
+        groups_.push_back(make_shared<AlignedVector<T> >(padded(rows_[i]),
+                                                         0));
+        first_groups_.push_back(groups_.size());
+    }
+    spares_.resize(groups_.size());
+}
+
+template <typename T>
+BasicWeightSet<T>::BasicWeightSet(const BasicWeightSet &other):
+    rows_(other.rows_),
+    columns_(other.columns_),
+    strides_(other.strides_),
+    group_rows_(other.group_rows_),
+    first_groups_(other.first_groups_),
+    groups_(other.groups_),
+    spares_(other.groups_.size())
+{
+}
+
+template <typename T>
+BasicWeightSet<T> &BasicWeightSet<T>::operator=(const BasicWeightSet &other)
+{
+    if (this != &other) share(other);
+    return *this;
+}
+
+template <typename T>
+const vector<unsigned int> &BasicWeightSet<T>::rowCounts() const
+{
+    return rows_;
+}
+
+template <typename T>
+const vector<unsigned int> &BasicWeightSet<T>::columnCounts() const
+{
+    return columns_;
+}
+
+template <typename T>
+unsigned int BasicWeightSet<T>::layerCount() const
+{
+    return static_cast<unsigned int>(rows_.size());
+}
+
+template <typename T>
+unsigned int BasicWeightSet<T>::rows(unsigned int layer) const
+{
+    return rows_[layer];
+}
+
+template <typename T>
+unsigned int BasicWeightSet<T>::columns(unsigned int layer) const
+{
+    return columns_[layer];
+}
+
+template <typename T>
+unsigned int BasicWeightSet<T>::stride(unsigned int layer) const
+{
+    return strides_[layer];
+}
+
+template <typename T>
+size_t BasicWeightSet<T>::blockSize(unsigned int layer) const
+{
+    return static_cast<size_t>(rows_[layer]) * strides_[layer]
+            + padded(rows_[layer]);
+}
+
+template <typename T>
+size_t BasicWeightSet<T>::size() const
+{
+    size_t total = 0;
+    for (const shared_ptr<AlignedVector<T> > &group : groups_) {
+        total += group->size();
+    }
+    return total;
+}
+
+template <typename T>
+unsigned int BasicWeightSet<T>::groupRows(unsigned int layer) const
+{
+    return group_rows_[layer];
+}
+
+template <typename T>
+unsigned int BasicWeightSet<T>::groupCount(unsigned int layer) const
+{
+    return static_cast<unsigned int>(first_groups_[layer + 1]
+                                     - first_groups_[layer]);
+}
+
+template <typename T>
+size_t BasicWeightSet<T>::groupSize(unsigned int layer,
+                                    unsigned int group) const
+{
+    return groups_[groupIndex(layer, group)]->size();
+}
+
+template <typename T>
+const T *BasicWeightSet<T>::group(unsigned int layer,
+                                  unsigned int group) const
+{
+    return groups_[groupIndex(layer, group)]->data();
+}
+
+template <typename T>
+T *BasicWeightSet<T>::mutableGroup(unsigned int layer,
+                                   unsigned int group,
+                                   bool keepContents)
+{
+    size_t index = groupIndex(layer, group);
+    shared_ptr<AlignedVector<T> > &storage = groups_[index];
+    if (storage.use_count() > 1) {
+        shared_ptr<AlignedVector<T> > &spare = spares_[index];
+        if (!spare) {
+            spare = make_shared<AlignedVector<T> >(storage->size(), 0);
+        }
+        if (keepContents) {
+            std::copy(storage->begin(), storage->end(), spare->begin());
+        }
+        storage.swap(spare);
+        spare.reset();
+    }
+
+    // use_count() is a relaxed load. The fence orders the writes to
+    // a group we own alone after the last use of it by other threads.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return storage->data();
+}
+
+template <typename T>
+const T *BasicWeightSet<T>::row(unsigned int layer, unsigned int j) const
+{
+    unsigned int groupRows = group_rows_[layer];
+    return group(layer, j / groupRows)
+            + static_cast<size_t>(j % groupRows) * strides_[layer];
+}
+
+template <typename T>
+T *BasicWeightSet<T>::mutableRow(unsigned int layer, unsigned int j)
+{
+    unsigned int groupRows = group_rows_[layer];
+    return mutableGroup(layer, j / groupRows)
+            + static_cast<size_t>(j % groupRows) * strides_[layer];
+}
+
+template <typename T>
+const T *BasicWeightSet<T>::bias(unsigned int layer) const
+{
+    return group(layer, groupCount(layer) - 1);
+}
+
+template <typename T>
+T *BasicWeightSet<T>::mutableBias(unsigned int layer)
+{
+    return mutableGroup(layer, groupCount(layer) - 1);
+}
+
+template <typename T>
+void BasicWeightSet<T>::share(const BasicWeightSet &other)
+{
+    if (!sameLayout(other)) {
+        *this = BasicWeightSet<T>(other.rows_, other.columns_);
+    }
+    for (unsigned int i = 0; i < layerCount(); i++) {
+        shareBlock(i, other);
+    }
+}
+
+template <typename T>
+void BasicWeightSet<T>::shareBlock(unsigned int layer,
+                                   const BasicWeightSet &other)
+{
+    for (unsigned int g = 0; g < groupCount(layer); g++) {
+        shareGroup(layer, g, other);
+    }
+}
+
+template <typename T>
+void BasicWeightSet<T>::shareGroup(unsigned int layer,
+                                   unsigned int group,
+                                   const BasicWeightSet &other)
+{
+    size_t index = groupIndex(layer, group);
+    shared_ptr<AlignedVector<T> > &storage = groups_[index];
+    if (storage == other.groups_[index]) return;
+    if (storage.use_count() == 1 && !spares_[index]) {
+        // See mutableGroup(): the spare gets written over later.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        spares_[index] = std::move(storage);
+    }
+    storage = other.groups_[index];
+}
+
+template <typename T>
+bool BasicWeightSet<T>::sharesBlock(unsigned int layer,
+                                    const BasicWeightSet &other) const
+{
+    for (unsigned int g = 0; g < groupCount(layer); g++) {
+        if (!sharesGroup(layer, g, other)) return false;
+    }
+    return true;
+}
+
+template <typename T>
+bool BasicWeightSet<T>::sharesGroup(unsigned int layer,
+                                    unsigned int group,
+                                    const BasicWeightSet &other) const
+{
+    size_t index = groupIndex(layer, group);
+    return groups_[index] == other.groups_[index];
+}
+
+template <typename T>
+vector<Matrix> BasicWeightSet<T>::toMatrices() const
+{
+    vector<Matrix> matrices;
+    for (unsigned int i = 0; i < layerCount(); i++) {
+        Matrix block = matrix(rows_[i], columns_[i]);
+        for (unsigned int j = 0; j < rows_[i]; j++) {
+            const T *source = row(i, j);
+            for (unsigned int k = 0; k < columns_[i]; k++) {
+                block[j][k] = source[k];
+            }
+        }
+        matrices.push_back(block);
+    }
+    return matrices;
+}
+
+template <typename T>
+vector<Row> BasicWeightSet<T>::toBiases() const
+{
+    vector<Row> biases;
+    for (unsigned int i = 0; i < layerCount(); i++) {
+        const T *source = bias(i);
+        biases.push_back(Row(source, source + rows_[i]));
+    }
+    return biases;
+}
+
+template <typename T>
+size_t BasicWeightSet<T>::groupIndex(unsigned int layer,
+                                     unsigned int group) const
+{
+    return first_groups_[layer] + group;
+}
+
+template class BasicWeightSet<double>;
+template class BasicWeightSet<float>;
+template class BasicWeightSet<int8_t>;
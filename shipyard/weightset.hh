@@ -0,0 +1,523 @@
+#ifndef WEIGHTSET_HH
+#define WEIGHTSET_HH
+
+#include "math.hh"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+using namespace std;
+
+/*!
+ * \var WEIGHT_ALIGNMENT
+ * \brief Alignment (in bytes) of weight storage. Matches the width
+ * of a 256-bit vector register.
+ */
+const size_t WEIGHT_ALIGNMENT = 32;
+
+/*!
+ * \var WEIGHT_GROUP_BYTES
+ * \brief Size (in bytes) that rows of a weight block are grouped up
+ * to for copy on write. A row longer than this forms a group alone.
+ */
+const size_t WEIGHT_GROUP_BYTES = 128;
+
+/*!
+ * \struct AlignedAllocator
+ * \brief Minimal allocator that hands out memory aligned to
+ * the given boundary.
+ * \author terratenff
+ */
+template <typename T, size_t Alignment>
+struct AlignedAllocator {
+
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() noexcept {}
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment> &) noexcept {}
+
+    T *allocate(size_t n)
+    {
+        return static_cast<T*>(::operator new(n * sizeof(T),
+                                              std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T *p, size_t)
+    {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment> &) const
+    {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment> &) const
+    {
+        return false;
+    }
+};
+
+/*!
+ * \def AlignedVector
+ * \brief Vector whose storage is aligned to WEIGHT_ALIGNMENT.
+ */
+template <typename T>
+using AlignedVector = vector<T, AlignedAllocator<T, WEIGHT_ALIGNMENT> >;
+
+/*!
+ * \def AlignedRow
+ * \brief Row of doubles whose storage is aligned to WEIGHT_ALIGNMENT.
+ */
+using AlignedRow = AlignedVector<double>;
+
+/*!
+ * \class BasicWeightSet
+ * \brief Aligned storage for all the weights and biases of a
+ * Neural Network.
+ *
+ * Weights between layers i and i + 1 form a block of
+ * layers[i + 1] rows, each of which has layers[i] columns. Rows are
+ * padded with zeros up to a multiple of LANES, so that every row
+ * starts on an aligned address. The rows are followed by the biases
+ * of the receiving layer, one per row, padded the same way.
+ *
+ * Each block is stored as groups of consecutive rows, each group in
+ * an aligned buffer of its own, and the biases form the last group.
+ * Rows within a group are contiguous, so kernels run on one group at
+ * a time. Laid one after another, the groups give the positions of
+ * blockSize, on which crossover works.
+ *
+ * Groups are copied on write: copying a weight set only shares its
+ * groups, and a shared group is copied the first time it is
+ * modified through mutableGroup, mutableRow or mutableBias. Read
+ * access never copies anything. Small groups keep part of a mutated
+ * copy shared even when every block of it has a mutation. A group
+ * that stops being used is kept as a spare for the next copy of the
+ * same group, so a weight set that keeps being shared and modified
+ * does not allocate memory after the first time.
+ *
+ * \author terratenff
+ */
+template <typename T>
+class BasicWeightSet
+{
+public:
+
+    /*!
+     * \var LANES
+     * \brief Number of weights that fit into one aligned block. Row
+     * strides are always a multiple of this.
+     */
+    static const unsigned int LANES = WEIGHT_ALIGNMENT / sizeof(T);
+
+    /*!
+     * \fn padded
+     * \brief Rounds a number of values up to a multiple of LANES.
+     * \param count Number of values.
+     * \return Padded number of values.
+     */
+    static unsigned int padded(unsigned int count)
+    {
+        return (count + LANES - 1) / LANES * LANES;
+    }
+
+    /*!
+     * \brief Constructor for an empty weight set.
+     */
+    BasicWeightSet();
+
+    /*!
+     * \brief Constructor for a zero-filled weight set.
+     * \param layers Structure of the Neural Network as number of
+     * neurons on each layer.
+     */
+    BasicWeightSet(const vector<unsigned int> &layers);
+
+    /*!
+     * \brief Constructor for a zero-filled weight set of given shape.
+     * \param rows Number of rows of each weight block.
+     * \param columns Number of columns of each weight block.
+     */
+    BasicWeightSet(const vector<unsigned int> &rows,
+                   const vector<unsigned int> &columns);
+
+    /*!
+     * \brief Copy constructor. Groups are shared, not copied.
+     * \param other Copied weight set.
+     */
+    BasicWeightSet(const BasicWeightSet &other);
+
+    /*!
+     * \brief Move constructor.
+     * \param other Moved weight set.
+     */
+    BasicWeightSet(BasicWeightSet &&other) = default;
+
+    /*!
+     * \brief Copy assignment. Groups are shared, not copied.
+     * \param other Copied weight set.
+     * \return This weight set.
+     */
+    BasicWeightSet &operator=(const BasicWeightSet &other);
+
+    /*!
+     * \brief Move assignment.
+     * \param other Moved weight set.
+     * \return This weight set.
+     */
+    BasicWeightSet &operator=(BasicWeightSet &&other) = default;
+
+    /*!
+     * \fn assign
+     * \brief Copies the weights and biases of another weight set,
+     * converting
+     * them to this set's type. The layout is taken over as well.
+     * \param other Source weight set.
+     */
+    template <typename U>
+    void assign(const BasicWeightSet<U> &other)
+    {
+        if (!sameLayout(other)) {
+            *this = BasicWeightSet<T>(other.rowCounts(),
+                                      other.columnCounts());
+        }
+        for (unsigned int i = 0; i < layerCount(); i++) {
+            for (unsigned int g = 0; g < groupCount(i); g++) {
+                mutableGroup(i, g, false);
+            }
+            for (unsigned int j = 0; j < rows_[i]; j++) {
+                const U *source = other.row(i, j);
+                T *target = mutableRow(i, j);
+                for (unsigned int k = 0; k < columns_[i]; k++) {
+                    target[k] = static_cast<T>(source[k]);
+                }
+            }
+            const U *source = other.bias(i);
+            T *target = mutableBias(i);
+            for (unsigned int j = 0; j < rows_[i]; j++) {
+                target[j] = static_cast<T>(source[j]);
+            }
+        }
+    }
+
+    /*!
+     * \fn sameLayout
+     * \brief Checks whether another weight set has the same shape.
+     * \param other Compared weight set.
+     * \return true, if both sets have the same rows and columns.
+     */
+    template <typename U>
+    bool sameLayout(const BasicWeightSet<U> &other) const
+    {
+        return rows_ == other.rowCounts()
+                && columns_ == other.columnCounts();
+    }
+
+    /*!
+     * \fn rowCounts
+     * \brief Getter for the number of rows of every weight block.
+     * \return Row counts.
+     */
+    const vector<unsigned int> &rowCounts() const;
+
+    /*!
+     * \fn columnCounts
+     * \brief Getter for the number of columns of every weight block.
+     * \return Column counts.
+     */
+    const vector<unsigned int> &columnCounts() const;
+
+    /*!
+     * \fn layerCount
+     * \brief Getter for the number of weight blocks, i.e. one less
+     * than the number of neuron layers.
+     * \return Number of weight blocks.
+     */
+    unsigned int layerCount() const;
+
+    /*!
+     * \fn rows
+     * \brief Getter for the number of rows in a weight block.
+     * \param layer Target weight block.
+     * \return Number of neurons on the receiving layer.
+     */
+    unsigned int rows(unsigned int layer) const;
+
+    /*!
+     * \fn columns
+     * \brief Getter for the number of columns in a weight block.
+     * \param layer Target weight block.
+     * \return Number of neurons on the sending layer.
+     */
+    unsigned int columns(unsigned int layer) const;
+
+    /*!
+     * \fn stride
+     * \brief Getter for the distance between two consecutive rows
+     * of a weight block.
+     * \param layer Target weight block.
+     * \return Padded row length.
+     */
+    unsigned int stride(unsigned int layer) const;
+
+    /*!
+     * \fn blockSize
+     * \brief Getter for the size of a weight block, biases and padding
+     * included.
+     * \param layer Target weight block.
+     * \return Number of weights in the block.
+     */
+    size_t blockSize(unsigned int layer) const;
+
+    /*!
+     * \fn size
+     * \brief Getter for the size of all weight blocks combined,
+     * biases and padding included.
+     * \return Number of weights in the set.
+     */
+    size_t size() const;
+
+    /*!
+     * \fn groupRows
+     * \brief Getter for the number of rows in each group of a weight
+     * block. The last group of rows may have fewer.
+     * \param layer Target weight block.
+     * \return Rows per group.
+     */
+    unsigned int groupRows(unsigned int layer) const;
+
+    /*!
+     * \fn groupCount
+     * \brief Getter for the number of groups in a weight block, the
+     * group of biases included.
+     * \param layer Target weight block.
+     * \return Number of groups.
+     */
+    unsigned int groupCount(unsigned int layer) const;
+
+    /*!
+     * \fn groupSize
+     * \brief Getter for the size of a group, padding included.
+     * \param layer Target weight block.
+     * \param group Target group.
+     * \return Number of weights in the group.
+     */
+    size_t groupSize(unsigned int layer, unsigned int group) const;
+
+    /*!
+     * \fn group
+     * \brief Getter for a group of a weight block.
+     * \param layer Target weight block.
+     * \param group Target group.
+     * \return Pointer to the first weight of the group.
+     */
+    const T *group(unsigned int layer, unsigned int group) const;
+
+    /*!
+     * \fn mutableGroup
+     * \brief Getter for a group that is about to be modified. The
+     * group is copied first, if it is shared.
+     * \param layer Target weight block.
+     * \param group Target group.
+     * \param keepContents false, if the caller overwrites the whole
+     * group, in which case a shared group is not copied but replaced.
+     * The padding of a replaced group is still zero.
+     * \return Pointer to the first weight of the group.
+     */
+    T *mutableGroup(unsigned int layer,
+                    unsigned int group,
+                    bool keepContents = true);
+
+    /*!
+     * \fn row
+     * \brief Getter for a row of a weight block.
+     * \param layer Target weight block.
+     * \param j Target row.
+     * \return Pointer to the first weight of the row.
+     */
+    const T *row(unsigned int layer, unsigned int j) const;
+
+    /*!
+     * \fn mutableRow
+     * \brief Getter for a row that is about to be modified. The
+     * group of the row is copied first, if it is shared.
+     * \param layer Target weight block.
+     * \param j Target row.
+     * \return Pointer to the first weight of the row.
+     */
+    T *mutableRow(unsigned int layer, unsigned int j);
+
+    /*!
+     * \fn bias
+     * \brief Getter for the biases stored after the rows of a weight
+     * block.
+     * \param layer Target weight block.
+     * \return Pointer to the bias of the first row.
+     */
+    const T *bias(unsigned int layer) const;
+
+    /*!
+     * \fn mutableBias
+     * \brief Getter for biases that are about to be modified. The
+     * group of the biases is copied first, if it is shared.
+     * \param layer Target weight block.
+     * \return Pointer to the bias of the first row.
+     */
+    T *mutableBias(unsigned int layer);
+
+    /*!
+     * \fn share
+     * \brief Makes this weight set share all the groups of another.
+     * The layout is taken over as well.
+     * \param other Source weight set.
+     */
+    void share(const BasicWeightSet &other);
+
+    /*!
+     * \fn shareBlock
+     * \brief Makes every group of a weight block of this set share
+     * the same group of another set of the same layout.
+     * \param layer Target weight block.
+     * \param other Source weight set.
+     */
+    void shareBlock(unsigned int layer, const BasicWeightSet &other);
+
+    /*!
+     * \fn shareGroup
+     * \brief Makes a group of this set share the same group of
+     * another set of the same layout.
+     * \param layer Target weight block.
+     * \param group Target group.
+     * \param other Source weight set.
+     */
+    void shareGroup(unsigned int layer,
+                    unsigned int group,
+                    const BasicWeightSet &other);
+
+    /*!
+     * \fn sharesBlock
+     * \brief Checks whether every group of a weight block is shared
+     * with another weight set.
+     * \param layer Target weight block.
+     * \param other Compared weight set.
+     * \return true, if both sets use the same storage for the block.
+     */
+    bool sharesBlock(unsigned int layer, const BasicWeightSet &other) const;
+
+    /*!
+     * \fn sharesGroup
+     * \brief Checks whether a group is shared with another weight set.
+     * \param layer Target weight block.
+     * \param group Target group.
+     * \param other Compared weight set.
+     * \return true, if both sets use the same storage for the group.
+     */
+    bool sharesGroup(unsigned int layer,
+                     unsigned int group,
+                     const BasicWeightSet &other) const;
+
+    /*!
+     * \fn toMatrices
+     * \brief Creates a nested copy of the weights, one matrix per
+     * weight block.
+     * \return Weights as a list of matrices.
+     */
+    vector<Matrix> toMatrices() const;
+
+    /*!
+     * \fn toBiases
+     * \brief Creates a copy of the biases, one row per weight block.
+     * \return Biases of every receiving layer.
+     */
+    vector<Row> toBiases() const;
+private:
+
+    /*!
+     * \fn groupIndex
+     * \brief Getter for the position of a group in groups_.
+     * \param layer Target weight block.
+     * \param group Target group.
+     * \return Index of the group.
+     */
+    size_t groupIndex(unsigned int layer, unsigned int group) const;
+
+    /*!
+     * \var rows_
+     * \brief Number of rows of each weight block.
+     */
+    vector<unsigned int> rows_;
+
+    /*!
+     * \var columns_
+     * \brief Number of columns of each weight block.
+     */
+    vector<unsigned int> columns_;
+
+    /*!
+     * \var strides_
+     * \brief Padded row length of each weight block.
+     */
+    vector<unsigned int> strides_;
+
+    /*!
+     * \var group_rows_
+     * \brief Number of rows in each group of each weight block.
+     */
+    vector<unsigned int> group_rows_;
+
+    /*!
+     * \var first_groups_
+     * \brief Index of the first group of each weight block in
+     * groups_, followed by the total number of groups.
+     */
+    vector<size_t> first_groups_;
+
+    /*!
+     * \var groups_
+     * \brief Aligned storage for each group of every weight block in
+     * order, possibly shared with other weight sets.
+     */
+    vector<shared_ptr<AlignedVector<T> > > groups_;
+
+    /*!
+     * \var spares_
+     * \brief Storage released by each group, reused when the group is
+     * copied next time. Never shared.
+     */
+    vector<shared_ptr<AlignedVector<T> > > spares_;
+};
+
+/*!
+ * \def WeightSet
+ * \brief Weight set of doubles. Used for the genome of a network.
+ */
+using WeightSet = BasicWeightSet<double>;
+
+/*!
+ * \def FloatWeightSet
+ * \brief Weight set of floats. Used for single precision inference.
+ */
+using FloatWeightSet = BasicWeightSet<float>;
+
+/*!
+ * \def Int8WeightSet
+ * \brief Weight set of 8-bit integers. Used for quantized inference.
+ */
+using Int8WeightSet = BasicWeightSet<int8_t>;
+
+extern template class BasicWeightSet<double>;
+extern template class BasicWeightSet<float>;
+extern template class BasicWeightSet<int8_t>;
+
+#endif // WEIGHTSET_HH
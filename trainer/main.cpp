@@ -0,0 +1,16 @@
+#include "trainer.hh"
+#include <iostream>
+
+int main(int argc, char *argv[])
+{
+    TrainerOptions options;
+    int outcome = Trainer::parse_options(argc, argv, options);
+    if (outcome != 0) {
+        std::ostream &out = outcome == 1 ? std::cout : std::cerr;
+        out << Trainer::usage(argv[0]);
+        return outcome == 1 ? 0 : 2;
+    }
+
+    Trainer trainer(options);
+    return trainer.run();
+}
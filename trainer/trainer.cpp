@@ -0,0 +1,228 @@
+#include "trainer.hh"
+#include "../shipyard/exporter.hh"
+#include "../shipyard/manager.hh"
+#include "../shipyard/scenario.hh"
+#include <filesystem>
+#include <iostream>
+#include <random>
+
+namespace
+{
+    bool parse_count(const std::string &text, unsigned int &value)
+    {
+        try {
+            size_t end = 0;
+            unsigned long parsed = std::stoul(text, &end);
+            if (end != text.size() || text[0] == '-') return false;
+            if (parsed > 0xFFFFFFFFul) return false;
+            value = static_cast<unsigned int>(parsed);
+            return true;
+        } catch (const std::exception &) {
+            return false;
+        }
+    }
+}
+
+int Trainer::parse_options(int argc, char *argv[], TrainerOptions &options)
+{
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        if (argument == "-h" || argument == "--help") return 1;
+
+        bool takesValue = argument == "-g" || argument == "--generations"
+                || argument == "-s" || argument == "--seed"
+                || argument == "-t" || argument == "--threads"
+                || argument == "-o" || argument == "--output";
+        if (!takesValue) {
+            if (argument[0] == '-' || !options.scenario.empty()) {
+                std::cerr << "Unexpected argument: " << argument << std::endl;
+                return 2;
+            }
+            options.scenario = argument;
+            continue;
+        }
+
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << argument << std::endl;
+            return 2;
+        }
+        std::string value = argv[++i];
+        bool valid = true;
+        if (argument == "-g" || argument == "--generations") {
+            valid = parse_count(value, options.generations)
+                    && options.generations > 0;
+        } else if (argument == "-s" || argument == "--seed") {
+            valid = parse_count(value, options.seed);
+            options.seeded = true;
+        } else if (argument == "-t" || argument == "--threads") {
+            valid = parse_count(value, options.threads);
+        } else {
+            options.output = value;
+        }
+        if (!valid) {
+            std::cerr << "Invalid value for " << argument << ": "
+                      << value << std::endl;
+            return 2;
+        }
+    }
+
+    if (options.scenario.empty()) {
+        std::cerr << "No scenario file given." << std::endl;
+        return 2;
+    }
+    return 0;
+}
+
+std::string Trainer::usage(const std::string &program)
+{
+    return "Usage: " + program + " [options] <scenario>\n"
+           "\n"
+           "Runs a scenario file without graphics and writes the results\n"
+           "into the output directory: generations.csv, population.txt\n"
+           "and best.hh.\n"
+           "\n"
+           "Options:\n"
+           "  -g, --generations <n>  Number of generations (default 100).\n"
+           "  -s, --seed <n>         Seed of the random number generator.\n"
+           "                         Picked at random if not given.\n"
+           "  -t, --threads <n>      Number of threads. Does not change the\n"
+           "                         results. Default 0, one per core.\n"
+           "  -o, --output <dir>     Output directory (default current).\n"
+           "  -h, --help             Show this text.\n";
+}
+
+Trainer::Trainer(const TrainerOptions &options):
+    options_(options),
+    manager_(nullptr),
+    tables_(false),
+    failed_(false)
+{
+    if (!options_.seeded) {
+        std::random_device device;
+        options_.seed = device();
+        options_.seeded = true;
+    }
+}
+
+int Trainer::run()
+{
+    Settings *settings = Settings::get_settings();
+    Scenario scenario(settings);
+    int outcome = scenario.load_scenario(options_.scenario);
+    if (outcome == 1) {
+        std::cerr << "Could not open file: " << options_.scenario
+                  << std::endl;
+        return 1;
+    } else if (outcome > 1) {
+        std::cerr << "Error while reading file: " << options_.scenario
+                  << std::endl;
+        return 1;
+    }
+    scenario.set_settings(settings);
+    settings->set_thread_count(options_.threads);
+
+    std::error_code error;
+    std::filesystem::create_directories(options_.output, error);
+    std::filesystem::path output(options_.output);
+    statistics_.open(output / "generations.csv");
+    if (!statistics_.is_open()) {
+        std::cerr << "Could not write into: " << options_.output
+                  << std::endl;
+        return 3;
+    }
+    // Networks with a single input may run from response tables,
+    // whose largest error is then recorded as well.
+    tables_ = settings->get_response_table_size() > 0;
+    statistics_ << "generation,best,mean,worst,seconds";
+    if (tables_) statistics_ << ",table_error";
+    statistics_ << ",transition" << std::endl;
+    std::cout << "Seed " << options_.seed << std::endl;
+
+    // Same starting positions as in the application.
+    SubjectCore target;
+    SubjectCore mousePoint;
+    target.setCoordinates(XY(350, 350));
+    mousePoint.setCoordinates(XY(-100, -100));
+    SubjectCore::setPublicInstance(&target, 1);
+    SubjectCore::setPublicInstance(&mousePoint, 4);
+
+    Random rand(options_.seed);
+    {
+        Manager manager(settings, rand);
+        manager_ = &manager;
+        manager.set_observer(this);
+        manager.initialize(&target, nullptr, nullptr, &mousePoint, nullptr);
+        while (manager.get_generation_count() <= options_.generations) {
+            manager.update();
+        }
+
+        // Even utilization means the threads were kept busy alike.
+        std::vector<WorkerStatistics> workers =
+                manager.get_worker_statistics();
+        for (unsigned int i = 0; i < workers.size(); i++) {
+            std::cout << "Thread " << i << ": " << workers[i].tasks
+                      << " tasks, " << workers[i].steals << " steals, "
+                      << 100 * workers[i].utilization << " % busy"
+                      << std::endl;
+        }
+        manager_ = nullptr;
+    }
+
+    SubjectCore::setPublicInstance(nullptr, 1);
+    SubjectCore::setPublicInstance(nullptr, 4);
+    statistics_.close();
+    return failed_ ? 3 : 0;
+}
+
+void Trainer::subjectsCreated(const std::vector<SubjectCore*> &)
+{
+    start_ = std::chrono::steady_clock::now();
+}
+
+void Trainer::subjectsUpdated(const std::vector<SubjectCore*> &)
+{
+}
+
+void Trainer::generationFinished(unsigned int generation,
+                                 const std::vector<NeuralNetwork*> &networks)
+{
+    std::chrono::steady_clock::time_point end =
+            std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start_).count();
+
+    double best = networks.front()->getFitness();
+    double worst = networks.back()->getFitness();
+    double total = 0;
+    for (NeuralNetwork *nn : networks) total += nn->getFitness();
+    double mean = total / networks.size();
+
+    // The row is finished once the transition has been timed.
+    statistics_ << generation << "," << best << "," << mean << ","
+                << worst << "," << seconds;
+    if (tables_) statistics_ << "," << manager_->get_response_table_error();
+    std::cout << "Generation " << generation << ": best " << best
+              << ", mean " << mean << " (" << seconds << " s)" << std::endl;
+
+    if (generation == options_.generations) {
+        std::filesystem::path output(options_.output);
+        int populationOutcome = Exporter::save_population(
+                    networks, (output / "population.txt").string());
+        int headerOutcome = Exporter::save_inference_header(
+                    *networks.front(), (output / "best.hh").string(), "best");
+        if (populationOutcome != 0 || headerOutcome != 0) {
+            std::cerr << "Could not write the final population into: "
+                      << options_.output << std::endl;
+            failed_ = true;
+        }
+    }
+}
+
+void Trainer::transitionFinished(const TransitionTiming &timing)
+{
+    statistics_ << "," << timing.total << std::endl;
+    start_ = std::chrono::steady_clock::now();
+}
+
+void Trainer::subjectsCleared()
+{
+}
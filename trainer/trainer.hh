@@ -0,0 +1,186 @@
+#ifndef TRAINER_HH
+#define TRAINER_HH
+
+#include "../shipyard/simulationobserver.hh"
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class Manager;
+
+/*!
+ * \struct TrainerOptions
+ * \brief Options of a batch training run, as given on the command line.
+ * \author terratenff
+ */
+struct TrainerOptions {
+
+    /*!
+     * \var scenario
+     * \brief Path to the scenario file that holds the settings.
+     */
+    std::string scenario;
+
+    /*!
+     * \var generations
+     * \brief Number of generations to run.
+     */
+    unsigned int generations = 100;
+
+    /*!
+     * \var seed
+     * \brief Seed of the random number generator.
+     */
+    unsigned int seed = 0;
+
+    /*!
+     * \var seeded
+     * \brief Whether a seed was given. Otherwise one is picked and
+     * reported, so that the run can be repeated.
+     */
+    bool seeded = false;
+
+    /*!
+     * \var threads
+     * \brief Number of threads to run the simulation with, 0 for one
+     * per core.
+     */
+    unsigned int threads = 0;
+
+    /*!
+     * \var output
+     * \brief Directory that the results are written into.
+     */
+    std::string output = ".";
+};
+
+/*!
+ * \class Trainer
+ * \brief Runs a scenario for a number of generations without graphics,
+ * as fast as possible. Writes statistics of every generation into
+ * "generations.csv", along with the time taken by the transition to
+ * the next one, and the largest error of the response tables if they
+ * are in use. Writes the final population into "population.txt" and
+ * its best network into "best.hh" (see "exporter.hh"). Reports how
+ * busy each thread was at the end.
+ *
+ * There is no player to follow: the primary target stays where the
+ * application places it at start, and so does the mouse point.
+ * \author terratenff
+ */
+class Trainer: public SimulationObserver
+{
+public:
+
+    /*!
+     * \fn parse_options
+     * \brief Reads the options of a run from command line arguments.
+     * \param argc Number of arguments.
+     * \param argv Arguments, the first of which is the program name.
+     * \param options Options to fill in.
+     * \return Integer code for the outcome: 0 for options to run with,
+     * 1 for a request for help, 2 for invalid arguments.
+     */
+    static int parse_options(int argc, char *argv[], TrainerOptions &options);
+
+    /*!
+     * \fn usage
+     * \brief Getter for the description of the command line arguments.
+     * \param program Name of the program.
+     * \return Usage text.
+     */
+    static std::string usage(const std::string &program);
+
+    /*!
+     * \brief Constructor for a trainer.
+     * \param options Options of the run.
+     */
+    Trainer(const TrainerOptions &options);
+
+    /*!
+     * \fn run
+     * \brief Loads the scenario and runs it.
+     * \return Exit code of the program: 0 for success, 1 for a
+     * scenario that could not be loaded, and 3 for results that
+     * could not be written.
+     */
+    int run();
+
+    /*!
+     * \fn subjectsCreated
+     * \brief Starts timing the first generation.
+     * \param subjects Subjects of the simulation.
+     */
+    void subjectsCreated(const std::vector<SubjectCore*> &subjects);
+
+    /*!
+     * \fn subjectsUpdated
+     * \brief Does nothing: there is nothing to draw.
+     * \param subjects Subjects of the simulation.
+     */
+    void subjectsUpdated(const std::vector<SubjectCore*> &subjects);
+
+    /*!
+     * \fn generationFinished
+     * \brief Records the statistics of a generation, and writes the
+     * population out after the last generation.
+     * \param generation Number of the generation that ended.
+     * \param networks Networks of the generation, fittest first.
+     */
+    void generationFinished(unsigned int generation,
+                            const std::vector<NeuralNetwork*> &networks);
+
+    /*!
+     * \fn transitionFinished
+     * \brief Records the time taken by the transition to the next
+     * generation, and starts timing that generation.
+     * \param timing Time taken by each stage.
+     */
+    void transitionFinished(const TransitionTiming &timing);
+
+    /*!
+     * \fn subjectsCleared
+     * \brief Does nothing: there is nothing to draw.
+     */
+    void subjectsCleared();
+private:
+
+    /*!
+     * \var options_
+     * \brief Options of the run.
+     */
+    TrainerOptions options_;
+
+    /*!
+     * \var statistics_
+     * \brief File for the statistics of every generation.
+     */
+    std::ofstream statistics_;
+
+    /*!
+     * \var start_
+     * \brief Start time of the current generation.
+     */
+    std::chrono::steady_clock::time_point start_;
+
+    /*!
+     * \var manager_
+     * \brief Manager of the run, while it runs.
+     */
+    Manager *manager_;
+
+    /*!
+     * \var tables_
+     * \brief Whether the networks may run from response tables.
+     */
+    bool tables_;
+
+    /*!
+     * \var failed_
+     * \brief Whether writing the final population failed.
+     */
+    bool failed_;
+};
+
+#endif // TRAINER_HH
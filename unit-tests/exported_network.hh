@@ -0,0 +1,120 @@
+// Generated by Neural Networks Demonstrator.
+// Layers: 4 5 3 4
+
+#ifndef EXPORTED_NETWORK_HH
+#define EXPORTED_NETWORK_HH
+
+#include <cmath>
+
+namespace exported_network
+{
+    constexpr unsigned int INPUT_COUNT = 4;
+    constexpr unsigned int OUTPUT_COUNT = 4;
+
+    constexpr double WEIGHTS_0[5][4] = {
+        {-0.86924423730854494, -0.32699736186391126, 0.0, -0.92270566239232155},
+        {-0.80614208105316199, 0.0, -0.41859667667520423, -0.90599613345356644},
+        {0.0, 0.0, -0.76454575275041714, -0.89127010526275596},
+        {-0.96142444806150684, -0.42162075406124055, -0.47618811141345141, -0.44026369932689718},
+        {-0.55070972575450294, -0.93531547726550757, -0.37179028107356704, 0.0},
+    };
+
+    constexpr double BIASES_0[5] = {
+        0.0, 0.0, 0.0, 0.0, 0.0
+    };
+
+    constexpr double WEIGHTS_1[3][5] = {
+        {-0.84899427544195705, -0.43288330054495416, 0.0, 0.80585742833978524, -0.77177188689324283},
+        {-0.94536469996014327, 0.0, 0.0, -0.54687426861533939, 0.0},
+        {-0.4095421054987341, 0.0, 0.0, -0.68534210233380743, 0.0},
+    };
+
+    constexpr double BIASES_1[3] = {
+        0.0, -0.0, 0.0
+    };
+
+    constexpr double WEIGHTS_2[4][3] = {
+        {1.8427139625793754, 0.0, 0.0},
+        {-0.4983203258258484, 0.0, -0.99269248797979159},
+        {-0.73089397612234297, -0.90913164217645337, -0.99176003097511345},
+        {0.0, -0.37356337815673518, 0.0},
+    };
+
+    constexpr double BIASES_2[4] = {
+        0.0, 0.0, 0.0, 0.0
+    };
+
+    inline double hidden_activation(double x)
+    {
+        return (2 / (1 + std::exp(-2*x))) - 1;
+    }
+
+    inline void feed_forward(const double *inputs, double *outputs)
+    {
+        const double n0_0 = inputs[0];
+        const double n0_1 = inputs[1];
+        const double n0_2 = inputs[2];
+        const double n0_3 = inputs[3];
+        const double s1_0 = BIASES_0[0]
+                + WEIGHTS_0[0][0] * n0_0
+                + WEIGHTS_0[0][1] * n0_1
+                + WEIGHTS_0[0][3] * n0_3;
+        const double s1_1 = BIASES_0[1]
+                + WEIGHTS_0[1][0] * n0_0
+                + WEIGHTS_0[1][2] * n0_2
+                + WEIGHTS_0[1][3] * n0_3;
+        const double s1_3 = BIASES_0[3]
+                + WEIGHTS_0[3][0] * n0_0
+                + WEIGHTS_0[3][1] * n0_1
+                + WEIGHTS_0[3][2] * n0_2
+                + WEIGHTS_0[3][3] * n0_3;
+        const double s1_4 = BIASES_0[4]
+                + WEIGHTS_0[4][0] * n0_0
+                + WEIGHTS_0[4][1] * n0_1
+                + WEIGHTS_0[4][2] * n0_2;
+        const double n1_0 = hidden_activation(s1_0);
+        const double n1_1 = hidden_activation(s1_1);
+        const double n1_3 = hidden_activation(s1_3);
+        const double n1_4 = hidden_activation(s1_4);
+        const double s2_0 = BIASES_1[0]
+                + WEIGHTS_1[0][0] * n1_0
+                + WEIGHTS_1[0][1] * n1_1
+                + WEIGHTS_1[0][3] * n1_3
+                + WEIGHTS_1[0][4] * n1_4;
+        const double s2_1 = BIASES_1[1]
+                + WEIGHTS_1[1][0] * n1_0
+                + WEIGHTS_1[1][3] * n1_3;
+        const double s2_2 = BIASES_1[2]
+                + WEIGHTS_1[2][0] * n1_0
+                + WEIGHTS_1[2][3] * n1_3;
+        const double n2_0 = hidden_activation(s2_0);
+        const double n2_1 = hidden_activation(s2_1);
+        const double n2_2 = hidden_activation(s2_2);
+        const double s3_0 = BIASES_2[0]
+                + WEIGHTS_2[0][0] * n2_0;
+        const double s3_1 = BIASES_2[1]
+                + WEIGHTS_2[1][0] * n2_0
+                + WEIGHTS_2[1][2] * n2_2;
+        const double s3_2 = BIASES_2[2]
+                + WEIGHTS_2[2][0] * n2_0
+                + WEIGHTS_2[2][1] * n2_1
+                + WEIGHTS_2[2][2] * n2_2;
+        const double s3_3 = BIASES_2[3]
+                + WEIGHTS_2[3][1] * n2_1;
+        const double e3_0 = std::exp(s3_0);
+        const double e3_1 = std::exp(s3_1);
+        const double e3_2 = std::exp(s3_2);
+        const double e3_3 = std::exp(s3_3);
+        const double total3 = e3_0 + e3_1 + e3_2 + e3_3;
+        const double n3_0 = e3_0 / total3;
+        const double n3_1 = e3_1 / total3;
+        const double n3_2 = e3_2 / total3;
+        const double n3_3 = e3_3 / total3;
+        outputs[0] = n3_0;
+        outputs[1] = n3_1;
+        outputs[2] = n3_2;
+        outputs[3] = n3_3;
+    }
+}
+
+#endif // EXPORTED_NETWORK_HH
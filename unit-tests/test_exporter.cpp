@@ -0,0 +1,208 @@
+#include "test_exporter.hh"
+#include "exported_network.hh"
+#include <sstream>
+
+TestExporter::TestExporter()
+{
+
+}
+
+TestExporter::~TestExporter()
+{
+
+}
+
+namespace
+{
+    // Values of a constexpr array of the header, in order.
+    Row header_array(const std::string &header, const std::string &name)
+    {
+        Row values;
+        size_t start = header.find("constexpr double " + name + "[");
+        if (start == std::string::npos) return values;
+        start = header.find("= {", start) + 3;
+        size_t end = header.find("};", start);
+        std::string text = header.substr(start, end - start);
+        for (char &c : text) {
+            if (c == '{' || c == '}' || c == ',') c = ' ';
+        }
+        std::istringstream stream(text);
+        double value;
+        while (stream >> value) values.push_back(value);
+        return values;
+    }
+
+    // Feed forward with SIGN as every activation function.
+    Row header_feed_forward(const vector<Matrix> &weights,
+                            const vector<Row> &biases,
+                            const Row &inputs)
+    {
+        Row neurons = inputs;
+        for (unsigned int i = 0; i < weights.size(); i++) {
+            Row next;
+            for (unsigned int j = 0; j < weights[i].size(); j++) {
+                double value = biases[i][j];
+                for (unsigned int k = 0; k < weights[i][j].size(); k++) {
+                    value += weights[i][j][k] * neurons[k];
+                }
+                next.push_back(sign(value));
+            }
+            neurons = next;
+        }
+        return neurons;
+    }
+}
+
+void TestExporter::test_inference_header()
+{
+    Settings *settings = Settings::get_settings();
+    settings->use_default_settings();
+    settings->set_input_type(WALL_DISTANCES);
+    settings->set_output_type(FIXED_MOVEMENT);
+    settings->set_hidden_layer_widths({5, 3});
+    settings->set_pruning_threshold(0.3);
+    Random rand;
+
+    NeuralNetwork pruned(settings, rand);
+    pruned.mutate();
+    pruned.prune();
+    std::string header = Exporter::inference_header(pruned, "3 best-net");
+    QVERIFY(header.find("namespace _3_best_net\n") != std::string::npos);
+    QVERIFY(header.find("#ifndef _3_BEST_NET_HH") != std::string::npos);
+    QVERIFY(header.find("INPUT_COUNT = 4;") != std::string::npos);
+    QVERIFY(header.find("OUTPUT_COUNT = 4;") != std::string::npos);
+    QVERIFY(header.find("inline void feed_forward(const double *inputs, "
+                        "double *outputs)") != std::string::npos);
+
+    vector<Matrix> weights = pruned.getWeights();
+    vector<Row> biases = pruned.getBiases();
+    unsigned int zeros = 0;
+    for (unsigned int i = 0; i < weights.size(); i++) {
+        std::string index = std::to_string(i);
+        Row exported = header_array(header, "WEIGHTS_" + index);
+        Row expected;
+        for (unsigned int j = 0; j < weights[i].size(); j++) {
+            for (unsigned int k = 0; k < weights[i][j].size(); k++) {
+                expected.push_back(weights[i][j][k]);
+                std::string term = "WEIGHTS_" + index + "["
+                        + std::to_string(j) + "][" + std::to_string(k)
+                        + "]";
+                // Neurons that no weight of the next layer reads are
+                // left out along with their sums.
+                bool read = i + 1 == weights.size();
+                for (unsigned int n = 0; !read
+                     && n < weights[i + 1].size(); n++) {
+                    read = weights[i + 1][n][j] != 0;
+                }
+                bool used = header.find(term) != std::string::npos;
+                QCOMPARE(used, weights[i][j][k] != 0 && read);
+                if (weights[i][j][k] == 0) zeros++;
+            }
+        }
+        // Weights must survive the round trip through text exactly.
+        QVERIFY(exported == expected);
+        QVERIFY(header_array(header, "BIASES_" + index) == biases[i]);
+    }
+    QVERIFY2(zeros > 0, "Pruning left no weights to leave out.");
+
+    settings->set_pruning_threshold(0);
+    settings->set_activation_function_hidden(SIGN);
+    settings->set_activation_function_output(SIGN);
+    NeuralNetwork binary(settings, rand);
+    binary.mutate();
+    QVERIFY(binary.isBinary());
+    header = Exporter::inference_header(binary, "binary");
+    weights = binary.getWeights();
+    const BinaryWeightSet &binarized = binary.getBinaryWeightSet();
+    QVERIFY(header_array(header, "WEIGHTS_0").size()
+            == weights[0].size() * weights[0][0].size());
+    for (unsigned int i = 1; i < weights.size(); i++) {
+        Row exported = header_array(header, "WEIGHTS_" + std::to_string(i));
+        const double *scales = binarized.scales(i);
+        unsigned int e = 0;
+        for (unsigned int j = 0; j < weights[i].size(); j++) {
+            for (unsigned int k = 0; k < weights[i][j].size(); k++) {
+                double weight = weights[i][j][k];
+                double expected = weight > 0 ? scales[j]
+                                             : weight < 0 ? -scales[j] : 0;
+                QCOMPARE(exported[e++], expected);
+            }
+        }
+    }
+
+    // The exported weights reproduce what the simulation runs.
+    vector<Matrix> header_weights = weights;
+    for (unsigned int i = 0; i < weights.size(); i++) {
+        Row exported = header_array(header, "WEIGHTS_" + std::to_string(i));
+        unsigned int e = 0;
+        for (Row &row : header_weights[i]) {
+            for (double &weight : row) weight = exported[e++];
+        }
+    }
+    std::vector<NeuralNetwork*> networks = {&binary};
+    BatchEngine engine;
+    engine.pack(networks);
+    for (unsigned int trial = 0; trial < 10; trial++) {
+        Row in;
+        for (unsigned int i = 0; i < 4; i++) {
+            in.push_back(rand.random_double(0.0, 1.0));
+        }
+        engine.setInputs(0, in);
+        engine.run();
+        Row expected = header_feed_forward(header_weights,
+                                           binary.getBiases(), in);
+        const double *outputs = engine.getOutputs(0);
+        for (unsigned int i = 0; i < expected.size(); i++) {
+            QCOMPARE(outputs[i], expected[i]);
+        }
+    }
+
+    settings->use_default_settings();
+}
+
+void TestExporter::test_compiled_header()
+{
+    // Same network that exported_network.hh was generated from, with
+    // Exporter::inference_header(nn, "exported_network").
+    Settings *settings = Settings::get_settings();
+    settings->use_default_settings();
+    settings->set_input_type(WALL_DISTANCES);
+    settings->set_output_type(FIXED_MOVEMENT);
+    settings->set_hidden_layer_widths({5, 3});
+    settings->set_activation_function_hidden(HYPERBOLIC_TANGENT);
+    settings->set_activation_function_output(SOFTMAX);
+    settings->set_pruning_threshold(0.3);
+    Random seeded(20);
+    NeuralNetwork nn(settings, seeded);
+    nn.mutate();
+    nn.prune();
+
+    // The weights differ if the random numbers of this platform do.
+    vector<Matrix> weights = nn.getWeights();
+    for (unsigned int j = 0; j < weights[0].size(); j++) {
+        for (unsigned int k = 0; k < weights[0][j].size(); k++) {
+            QCOMPARE(weights[0][j][k], exported_network::WEIGHTS_0[j][k]);
+        }
+    }
+
+    QCOMPARE(nn.getLayers()[0], exported_network::INPUT_COUNT);
+    QCOMPARE(nn.getOutputCount(), exported_network::OUTPUT_COUNT);
+    Random rand;
+    for (unsigned int trial = 0; trial < 20; trial++) {
+        Row in;
+        for (unsigned int i = 0; i < exported_network::INPUT_COUNT; i++) {
+            in.push_back(rand.random_double(0.0, 1.0));
+        }
+        Row expected = nn.feedForward(in);
+        double outputs[exported_network::OUTPUT_COUNT];
+        exported_network::feed_forward(in.data(), outputs);
+        for (unsigned int i = 0; i < exported_network::OUTPUT_COUNT; i++) {
+            QVERIFY2(near_double(outputs[i], expected[i], 0.0000001),
+                     qPrintable(QString("Compiled header differs from "
+                                        "feedForward: %1 != %2")
+                                .arg(outputs[i]).arg(expected[i])));
+        }
+    }
+
+    settings->use_default_settings();
+}
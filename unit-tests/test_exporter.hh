@@ -0,0 +1,46 @@
+#ifndef TESTEXPORTER_HH
+#define TESTEXPORTER_HH
+
+#include <QtTest>
+#include "../shipyard/exporter.hh"
+#include "../shipyard/batchengine.hh"
+
+/*!
+ * \class TestExporter
+ * \brief Collection of test cases for exporting neural networks.
+ * \author terratenff
+ */
+class TestExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestExporter();
+    ~TestExporter();
+
+private slots:
+
+    /*!
+     * \brief Tests exporting a network as a C++ header.
+     *
+     * Testing consists of reading the weight and bias arrays back
+     * from the header of a pruned network and a binary network, and
+     * comparing them to the weights that the networks compute with.
+     * Pruned weights must be left out of the unrolled sums, and the
+     * weights of the binary network must give the outputs of the
+     * batch engine.
+     */
+    void test_inference_header();
+
+    /*!
+     * \brief Tests compiling an exported network.
+     *
+     * Testing consists of rebuilding the network that
+     * exported_network.hh was generated from, and comparing the
+     * outputs of its feedForward to those of the compiled
+     * feed_forward of the header.
+     */
+    void test_compiled_header();
+};
+
+#endif // TESTEXPORTER_HH
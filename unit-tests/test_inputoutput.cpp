@@ -59,9 +59,15 @@ void TestInputOutput::test_input_angular_difference()
     Row row2t = {0.0000};
     Row row3t = {0.5161};
 
-    Row row1r = Input::angular_difference(angle1, position1, target_position1);
-    Row row2r = Input::angular_difference(angle2, position2, target_position2);
-    Row row3r = Input::angular_difference(angle3, position3, target_position3);
+    Row row1r(1);
+    Input::angular_difference(angle1, position1, target_position1,
+                              row1r.data());
+    Row row2r(1);
+    Input::angular_difference(angle2, position2, target_position2,
+                              row2r.data());
+    Row row3r(1);
+    Input::angular_difference(angle3, position3, target_position3,
+                              row3r.data());
 
     bool pass1 = compare_rows(row1t, row1r);
     bool pass2 = compare_rows(row2t, row2r);
@@ -100,9 +106,12 @@ void TestInputOutput::test_input_space_scalar_difference()
     Row row2t = {0.1500};
     Row row3t = {0.4830};
 
-    Row row1r = Input::space_scalar_difference(position1, target_position1);
-    Row row2r = Input::space_scalar_difference(position2, target_position2);
-    Row row3r = Input::space_scalar_difference(position3, target_position3);
+    Row row1r(1);
+    Input::space_scalar_difference(position1, target_position1, row1r.data());
+    Row row2r(1);
+    Input::space_scalar_difference(position2, target_position2, row2r.data());
+    Row row3r(1);
+    Input::space_scalar_difference(position3, target_position3, row3r.data());
 
     bool pass1 = compare_rows(row1t, row1r);
     bool pass2 = compare_rows(row2t, row2r);
@@ -141,9 +150,12 @@ void TestInputOutput::test_input_axis_difference()
     Row row2t = {0.0000, 0.2778};
     Row row3t = {-0.4479, -0.4074};
 
-    Row row1r = Input::space_axis_difference(position1, target_position1);
-    Row row2r = Input::space_axis_difference(position2, target_position2);
-    Row row3r = Input::space_axis_difference(position3, target_position3);
+    Row row1r(2);
+    Input::space_axis_difference(position1, target_position1, row1r.data());
+    Row row2r(2);
+    Input::space_axis_difference(position2, target_position2, row2r.data());
+    Row row3r(2);
+    Input::space_axis_difference(position3, target_position3, row3r.data());
 
     bool pass1 = compare_rows(row1t, row1r);
     bool pass2 = compare_rows(row2t, row2r);
@@ -179,9 +191,12 @@ void TestInputOutput::test_input_wall_distances()
     Row row2t = {0.4792, 0.5208, 0.5370, 0.4630};
     Row row3t = {0.0000, 1.0000, 0.0000, 1.0000};
 
-    Row row1r = Input::wall_distances(position1);
-    Row row2r = Input::wall_distances(position2);
-    Row row3r = Input::wall_distances(position3);
+    Row row1r(4);
+    Input::wall_distances(position1, row1r.data());
+    Row row2r(4);
+    Input::wall_distances(position2, row2r.data());
+    Row row3r(4);
+    Input::wall_distances(position3, row3r.data());
 
     bool pass1 = compare_rows(row1t, row1r);
     bool pass2 = compare_rows(row2t, row2r);
@@ -232,13 +247,20 @@ void TestInputOutput::test_input_four_way_search()
     Row row6t = {0.0000, 0.0000, 0.0000, 0.0000};
     Row row7t = {0.0000, 0.0000, 0.0000, 0.0000};
 
-    Row row1r = Input::four_way_search(position1, target_position1);
-    Row row2r = Input::four_way_search(position2, target_position2);
-    Row row3r = Input::four_way_search(position3, target_position3);
-    Row row4r = Input::four_way_search(position4, target_position4);
-    Row row5r = Input::four_way_search(position5, target_position5);
-    Row row6r = Input::four_way_search(position6, target_position6);
-    Row row7r = Input::four_way_search(position7, target_position7);
+    Row row1r(4);
+    Input::four_way_search(position1, target_position1, row1r.data());
+    Row row2r(4);
+    Input::four_way_search(position2, target_position2, row2r.data());
+    Row row3r(4);
+    Input::four_way_search(position3, target_position3, row3r.data());
+    Row row4r(4);
+    Input::four_way_search(position4, target_position4, row4r.data());
+    Row row5r(4);
+    Input::four_way_search(position5, target_position5, row5r.data());
+    Row row6r(4);
+    Input::four_way_search(position6, target_position6, row6r.data());
+    Row row7r(4);
+    Input::four_way_search(position7, target_position7, row7r.data());
 
     bool pass1 = compare_rows(row1t, row1r);
     bool pass2 = compare_rows(row2t, row2r);
@@ -300,10 +322,14 @@ void TestInputOutput::test_input_four_corner_search()
     Row row3t = {0.0000, 0.5001, 0.0000, 0.0000};
     Row row4t = {0.0000, 0.0000, 0.0269, 0.0000};
 
-    Row row1r = Input::four_corner_search(position1, target_position1);
-    Row row2r = Input::four_corner_search(position2, target_position2);
-    Row row3r = Input::four_corner_search(position3, target_position3);
-    Row row4r = Input::four_corner_search(position4, target_position4);
+    Row row1r(4);
+    Input::four_corner_search(position1, target_position1, row1r.data());
+    Row row2r(4);
+    Input::four_corner_search(position2, target_position2, row2r.data());
+    Row row3r(4);
+    Input::four_corner_search(position3, target_position3, row3r.data());
+    Row row4r(4);
+    Input::four_corner_search(position4, target_position4, row4r.data());
 
     bool pass1 = compare_rows(row1t, row1r);
     bool pass2 = compare_rows(row2t, row2r);
@@ -338,61 +364,201 @@ void TestInputOutput::test_output_angular_velocity()
 {
     Row output = {0.5};
     double factor = 5000;
-    Row result = Output::angular_velocity(output, factor);
-    QVERIFY2(result.size() == 1, "Invalid output size.");
+    Row result(1);
+    Output::angular_velocity(output.data(), factor, result.data());
+    QVERIFY2(near_double(result[0], 2500, 0.0001), "Invalid output.");
 }
 
 void TestInputOutput::test_output_direct_angle()
 {
     Row output = {0.5};
-    Row result = Output::direct_angle(output);
-    QVERIFY2(result.size() == 1, "Invalid output size.");
+    Row result(1);
+    Output::direct_angle(output.data(), result.data());
+    QVERIFY2(near_double(result[0], 180, 0.0001), "Invalid output.");
 }
 
 void TestInputOutput::test_output_angle_velocity()
 {
     Row output = {0.5, 0.5};
     double factor = 5000;
-    Row result = Output::angle_velocity(output, factor, factor);
-    QVERIFY2(result.size() == 2, "Invalid output size.");
+    Row result(2);
+    Output::angle_velocity(output.data(), factor, factor, result.data());
+    QVERIFY2(near_double(result[0], 2500, 0.0001)
+             && near_double(result[1], 2500, 0.0001), "Invalid output.");
 }
 
 void TestInputOutput::test_output_angle_acceleration()
 {
     Row output = {0.5, 0.5};
     double factor = 5000;
-    Row result = Output::angle_acceleration(output, factor, factor);
-    QVERIFY2(result.size() == 2, "Invalid output size.");
+    Row result(2);
+    Output::angle_acceleration(output.data(), factor, factor, result.data());
+    QVERIFY2(near_double(result[0], 2500, 0.0001)
+             && near_double(result[1], 2500, 0.0001), "Invalid output.");
 }
 
 void TestInputOutput::test_output_axis_velocity()
 {
     Row output = {0.5, 0.5};
     XY factor(5000, 5000);
-    Row result = Output::axis_velocity(output, factor);
-    QVERIFY2(result.size() == 2, "Invalid output size.");
+    Row result(2);
+    Output::axis_velocity(output.data(), factor, result.data());
+    QVERIFY2(near_double(result[0], 2500, 0.0001)
+             && near_double(result[1], 2500, 0.0001), "Invalid output.");
 }
 
 void TestInputOutput::test_output_axis_acceleration()
 {
     Row output = {0.5, 0.5};
     XY factor(5000, 5000);
-    Row result = Output::axis_acceleration(output, factor);
-    QVERIFY2(result.size() == 2, "Invalid output size.");
+    Row result(2);
+    Output::axis_acceleration(output.data(), factor, result.data());
+    QVERIFY2(near_double(result[0], 2500, 0.0001)
+             && near_double(result[1], 2500, 0.0001), "Invalid output.");
 }
 
 void TestInputOutput::test_output_small_hops()
 {
-    Row output = {0.5, 0.5};
-    XY factor(5000, 5000);
-    Row result = Output::small_hops(output);
-    QVERIFY2(result.size() == 2, "Invalid output size.");
+    Row output = {0.5, -0.5};
+    Row result(2);
+    Output::small_hops(output.data(), result.data());
+    QVERIFY2(result[0] == 1.0 && result[1] == -1.0, "Invalid output.");
 }
 
 void TestInputOutput::test_output_fixed_movement()
 {
-    Row output = {0.5, 0.5, 0.5, 0.5};
-    XY factor(5000, 5000);
-    Row result = Output::fixed_movement(output);
-    QVERIFY2(result.size() == 4, "Invalid output size.");
+    Row output = {0.5, 0.5, 0.9, 0.5};
+    Row result(4);
+    Output::fixed_movement(output.data(), result.data());
+    Row expected = {0.0, 0.0, 1.0, 0.0};
+    QVERIFY2(result == expected, "Invalid output.");
+}
+
+namespace
+{
+    /*!
+     * \class TestSubject
+     * \brief Subject without any graphics, for the encoding tests.
+     */
+    class TestSubject : public SubjectCore
+    {
+    };
+}
+
+void TestInputOutput::test_input_encodings()
+{
+    Settings *settings = Settings::get_settings();
+    settings->use_default_settings();
+    Random rand;
+
+    TestSubject subject;
+    TestSubject target;
+    subject.setCoordinates(XY(200, 100));
+    subject.setAngle(30);
+    target.setCoordinates(XY(1000, 500));
+    SubjectCore::setPublicInstance(&target, 1);
+
+    std::vector<input_type> types = {NO_INPUT,
+                                     ANGULAR_DIFFERENCE,
+                                     SPACE_TOTAL_DIFFERENCE,
+                                     SPACE_AXIS_DIFFERENCE,
+                                     WALL_DISTANCES,
+                                     FOUR_WAY_SEARCH,
+                                     FOUR_CORNER_SEARCH};
+    std::vector<Row> expected = {Row(1), Row(1), Row(1), Row(2),
+                                 Row(4), Row(4), Row(4)};
+    XY position(200, 100);
+    XY target_position(1000, 500);
+    Input::angular_difference(30, position, target_position,
+                              expected[0].data());
+    Input::angular_difference(30, position, target_position,
+                              expected[1].data());
+    Input::space_scalar_difference(position, target_position,
+                                   expected[2].data());
+    Input::space_axis_difference(position, target_position,
+                                 expected[3].data());
+    Input::wall_distances(position, expected[4].data());
+    Input::four_way_search(position, target_position, expected[5].data());
+    Input::four_corner_search(position, target_position,
+                              expected[6].data());
+
+    for (unsigned int t = 0; t < types.size(); t++) {
+        settings->set_input_type(types[t]);
+        NeuralNetwork nn(settings, rand);
+        subject.setNeuralNetwork(&nn);
+        QVERIFY(subject.prepareUpdate());
+
+        const InputEncoding &encoding = Encoding::input_encoding(types[t]);
+        Row inputs = subject.getInputs();
+        QCOMPARE(encoding.type, types[t]);
+        QCOMPARE(encoding.arity, nn.getLayers()[0]);
+        QCOMPARE(static_cast<unsigned int>(inputs.size()), encoding.arity);
+        for (double input : inputs) {
+            QVERIFY2(input >= encoding.minimum && input <= encoding.maximum,
+                     qPrintable(QString("Input %1 is out of range.")
+                                .arg(input)));
+        }
+        if (!compare_rows(expected[t], inputs)) {
+            print_row_report("-- test_input_encodings --",
+                             expected[t], inputs);
+            QFAIL(qPrintable(QString("Input type %1 made wrong inputs.")
+                             .arg(types[t])));
+        }
+    }
+
+    SubjectCore::setPublicInstance(nullptr, 1);
+    settings->use_default_settings();
+}
+
+void TestInputOutput::test_output_encodings()
+{
+    Settings *settings = Settings::get_settings();
+    settings->use_default_settings();
+    Random rand;
+
+    std::vector<output_type> types = {NO_OUTPUT,
+                                      ANGULAR_VELOCITY,
+                                      DIRECT_ANGLE,
+                                      ANGLE_VELOCITY,
+                                      ANGLE_ACCELERATION,
+                                      AXIS_VELOCITY,
+                                      AXIS_ACCELERATION,
+                                      SMALL_HOPS,
+                                      FIXED_MOVEMENT};
+    for (output_type type : types) {
+        settings->set_output_type(type);
+        NeuralNetwork nn(settings, rand);
+        const OutputEncoding &encoding = Encoding::output_encoding(type);
+        QCOMPARE(encoding.type, type);
+        QCOMPARE(encoding.arity, nn.getOutputCount());
+    }
+
+    TestSubject subject;
+    TestSubject target;
+    SubjectCore::setPublicInstance(&target, 1);
+    subject.setAngularVelocityFactor(10);
+    subject.setVelocityFactor(20);
+
+    settings->set_output_type(ANGLE_VELOCITY);
+    NeuralNetwork velocity(settings, rand);
+    subject.setNeuralNetwork(&velocity);
+    Row outputs = {0.5, -0.25};
+    subject.finishUpdate(outputs.data(), 2);
+    QVERIFY(near_double(subject.getAngularVelocity(), 5, 0.0001));
+    QVERIFY(near_double(subject.getVelocity(), -5, 0.0001));
+
+    // Outputs of the wrong size are ignored.
+    outputs = {1.0};
+    subject.finishUpdate(outputs.data(), 1);
+    QVERIFY(near_double(subject.getAngularVelocity(), 5, 0.0001));
+
+    settings->set_output_type(FIXED_MOVEMENT);
+    NeuralNetwork movement(settings, rand);
+    subject.setNeuralNetwork(&movement);
+    outputs = {0.1, 0.2, 0.9, 0.3};
+    subject.finishUpdate(outputs.data(), 4);
+    QVERIFY(near_double(subject.getAngle(), 180, 0.0001));
+
+    SubjectCore::setPublicInstance(nullptr, 1);
+    settings->use_default_settings();
 }
@@ -3,6 +3,8 @@
 
 #include <QtTest>
 #include "../shipyard/inputoutput.hh"
+#include "../shipyard/encoding.hh"
+#include "../shipyard/subjectcore.hh"
 
 /*!
  * \class TestInputOutput
@@ -155,6 +157,26 @@ private slots:
      * Testing consists of a single output size verification.
      */
     void test_output_fixed_movement();
+
+    /*!
+     * \brief Tests the registry of input types.
+     *
+     * Testing consists of making inputs for a subject through the
+     * registry for every input type, and checking that the inputs
+     * match the size of the input layer and the range of the type,
+     * and that they equal the results of the input functions.
+     */
+    void test_input_encodings();
+
+    /*!
+     * \brief Tests the registry of output types.
+     *
+     * Testing consists of applying outputs to a subject through the
+     * registry for every output type, and checking that the outputs
+     * match the size of the output layer and change the subject as
+     * the output functions would.
+     */
+    void test_output_encodings();
 };
 
 #endif // TESTINPUTOUTPUT_HH
@@ -1,6 +1,11 @@
 #include "test_math.hh"
 #include "test_inputoutput.hh"
 #include "test_fitness.hh"
+#include "test_neuralnetwork.hh"
+#include "test_exporter.hh"
+#include "test_threadpool.hh"
+#include "test_simulation.hh"
+#include "test_trainer.hh"
 
 int main(int argc, char** argv)
 {
@@ -17,5 +22,25 @@ int main(int argc, char** argv)
         TestFitness testCase;
         status |= QTest::qExec(&testCase, argc, argv);
     }
+    {
+        TestNeuralNetwork testCase;
+        status |= QTest::qExec(&testCase, argc, argv);
+    }
+    {
+        TestExporter testCase;
+        status |= QTest::qExec(&testCase, argc, argv);
+    }
+    {
+        TestThreadPool testCase;
+        status |= QTest::qExec(&testCase, argc, argv);
+    }
+    {
+        TestSimulation testCase;
+        status |= QTest::qExec(&testCase, argc, argv);
+    }
+    {
+        TestTrainer testCase;
+        status |= QTest::qExec(&testCase, argc, argv);
+    }
     return status;
 }
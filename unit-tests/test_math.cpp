@@ -1356,3 +1356,95 @@ void TestMath::test_softmax()
                                  "failed. See below for the comparisons.")));
     }
 }
+
+void TestMath::test_fast_exp()
+{
+    std::vector<kernel_type> kernels = {KERNEL_SCALAR, KERNEL_SSE2,
+                                        KERNEL_AVX2};
+    kernel_type original = get_kernel();
+
+    for (kernel_type kernel : kernels) {
+        set_kernel(kernel);
+        if (get_kernel() != kernel) continue; // Not supported.
+
+        // An odd number of values leaves a tail for the scalar loop.
+        Row values;
+        for (double x = -708.0; x <= 709.0; x += 0.713) values.push_back(x);
+        Row result = values;
+        fast_exp_row(result.data(), static_cast<unsigned int>(result.size()));
+        for (unsigned int i = 0; i < values.size(); i++) {
+            double expected = std::exp(values[i]);
+            double error = std::abs(result[i] - expected) / expected;
+            QVERIFY2(error <= FAST_EXP_TOLERANCE,
+                     qPrintable(QString("exp(%1): relative error %2")
+                                .arg(values[i]).arg(error)));
+        }
+
+        std::vector<float> floatValues;
+        for (float x = -87.0f; x <= 88.0f; x += 0.173f) {
+            floatValues.push_back(x);
+        }
+        std::vector<float> floatResult = floatValues;
+        fast_exp_row(floatResult.data(),
+                     static_cast<unsigned int>(floatResult.size()));
+        for (unsigned int i = 0; i < floatValues.size(); i++) {
+            double expected = std::exp(static_cast<double>(floatValues[i]));
+            double error = std::abs(floatResult[i] - expected) / expected;
+            QVERIFY2(error <= FAST_EXP_TOLERANCE_FLOAT,
+                     qPrintable(QString("exp(%1f): relative error %2")
+                                .arg(floatValues[i]).arg(error)));
+        }
+    }
+    set_kernel(original);
+}
+
+void TestMath::test_fast_activations()
+{
+    std::vector<kernel_type> kernels = {KERNEL_SCALAR, KERNEL_SSE2,
+                                        KERNEL_AVX2};
+    kernel_type original = get_kernel();
+    double tolerance = 4 * FAST_EXP_TOLERANCE;
+
+    Row values;
+    for (double x = -30.0; x <= 30.0; x += 0.37) values.push_back(x);
+    unsigned int count = static_cast<unsigned int>(values.size());
+
+    for (kernel_type kernel : kernels) {
+        set_kernel(kernel);
+        if (get_kernel() != kernel) continue; // Not supported.
+
+        Row sigmoidRow = values;
+        Row tangentRow = values;
+        Row gaussianRow = values;
+        fast_sigmoid_row(sigmoidRow.data(), count);
+        fast_hyperbolic_tangent_row(tangentRow.data(), count);
+        fast_gaussian_row(gaussianRow.data(), count);
+
+        for (unsigned int i = 0; i < count; i++) {
+            double x = values[i];
+            QVERIFY2(std::abs(sigmoidRow[i] - sigmoid(x)) <= tolerance,
+                     qPrintable(QString("sigmoid(%1): expected %2, got %3")
+                                .arg(x).arg(sigmoid(x)).arg(sigmoidRow[i])));
+            QVERIFY2(std::abs(tangentRow[i] - hyperbolic_tangent(x))
+                     <= tolerance,
+                     qPrintable(QString("tanh(%1): expected %2, got %3")
+                                .arg(x).arg(hyperbolic_tangent(x))
+                                .arg(tangentRow[i])));
+            QVERIFY2(std::abs(gaussianRow[i] - gaussian(x)) <= tolerance,
+                     qPrintable(QString("gaussian(%1): expected %2, got %3")
+                                .arg(x).arg(gaussian(x)).arg(gaussianRow[i])));
+        }
+
+        Row softmaxInput(values.begin(), values.begin() + 40);
+        Row expected = softmax(softmaxInput);
+        Row softmaxRow = softmaxInput;
+        fast_softmax_row(softmaxRow.data(),
+                         static_cast<unsigned int>(softmaxRow.size()));
+        for (unsigned int i = 0; i < expected.size(); i++) {
+            QVERIFY2(std::abs(softmaxRow[i] - expected[i]) <= tolerance,
+                     qPrintable(QString("softmax: expected %1, got %2")
+                                .arg(expected[i]).arg(softmaxRow[i])));
+        }
+    }
+    set_kernel(original);
+}
@@ -3,6 +3,8 @@
 
 #include <QtTest>
 #include "../shipyard/math.hh"
+#include "../shipyard/fastmath.hh"
+#include "../shipyard/layerkernel.hh"
 
 /*!
  * \class TestMath
@@ -344,6 +346,28 @@ private slots:
      * the expected results.
      */
     void test_softmax();
+
+    /*!
+     * \brief Tests the function "fast_exp_row".
+     *
+     * Testing consists of rows of values spread over the whole
+     * clamped range, in both double and single precision. Rows are
+     * processed with every kernel the CPU supports, and the results
+     * are compared with std::exp using FAST_EXP_TOLERANCE and
+     * FAST_EXP_TOLERANCE_FLOAT as relative error bounds.
+     */
+    void test_fast_exp();
+
+    /*!
+     * \brief Tests the fast activation functions.
+     *
+     * Testing consists of a row of values, both positive and negative,
+     * that is activated by the fast versions of sigmoid, hyperbolic
+     * tangent, gaussian and softmax. The results are compared with
+     * the scalar activation functions, which they may not differ
+     * from by more than a few times FAST_EXP_TOLERANCE.
+     */
+    void test_fast_activations();
 private:
 
     /*!
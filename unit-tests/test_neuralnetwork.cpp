@@ -0,0 +1,1502 @@
+#include "test_neuralnetwork.hh"
+#include <iostream>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+
+namespace
+{
+    // Replacements of the global allocation functions count every
+    // allocation made while counting is enabled.
+    bool counting_allocations = false;
+    unsigned int allocation_count = 0;
+
+    void *counted_allocation(std::size_t size, std::size_t alignment)
+    {
+        if (counting_allocations) ++allocation_count;
+        if (size == 0) size = 1;
+        void *pointer = nullptr;
+        if (alignment <= alignof(std::max_align_t)) {
+            pointer = std::malloc(size);
+        } else {
+            size = (size + alignment - 1) / alignment * alignment;
+            pointer = std::aligned_alloc(alignment, size);
+        }
+        if (pointer == nullptr) throw std::bad_alloc();
+        return pointer;
+    }
+}
+
+void *operator new(std::size_t size)
+{
+    return counted_allocation(size, 0);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    return counted_allocation(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+TestNeuralNetwork::TestNeuralNetwork()
+{
+
+}
+
+TestNeuralNetwork::~TestNeuralNetwork()
+{
+
+}
+
+Row TestNeuralNetwork::reference_feed_forward(const vector<Matrix> &weights,
+                                              const Row &inputs,
+                                              const vector<Row> &biases,
+                                              double (*activation)(double &))
+{
+    Row neurons = inputs;
+    for (unsigned int i = 0; i < weights.size(); i++) {
+        Row next;
+        for (unsigned int j = 0; j < weights[i].size(); j++) {
+            double value = biases[i][j];
+            for (unsigned int k = 0; k < weights[i][j].size(); k++) {
+                value += weights[i][j][k] * neurons[k];
+            }
+            next.push_back(activation(value));
+        }
+        neurons = next;
+    }
+    return neurons;
+}
+
+void TestNeuralNetwork::test_activation_kernels()
+{
+    Row values = {-10.0, -1.5, -0.5, 0.0, 0.25, 1.0, 3.0, 12.0};
+    unsigned int count = static_cast<unsigned int>(values.size());
+
+    std::vector<activation_type> types = {SIGMOID, HYPERBOLIC_TANGENT,
+                                          SIGN, HEAVISIDE, RELU,
+                                          RELU_LEAKY, GAUSSIAN,
+                                          NO_ACTIVATION};
+    std::vector<double (*)(double &)> functions = {sigmoid,
+                                                   hyperbolic_tangent,
+                                                   sign, heaviside, ReLU,
+                                                   ReLU_leaky, gaussian,
+                                                   sigmoid};
+
+    for (unsigned int t = 0; t < types.size(); t++) {
+        Row result = values;
+        resolve_activation(types[t])(result.data(), count, count);
+        for (unsigned int i = 0; i < count; i++) {
+            double expected = functions[t](values[i]);
+            QVERIFY2(near_double(result[i], expected, 0.0000001),
+                     qPrintable(QString("Activation kernel %1 differs "
+                                        "from math.hh: %2 != %3")
+                                .arg(static_cast<int>(types[t]))
+                                .arg(result[i]).arg(expected)));
+        }
+    }
+
+    // Softmax normalizes each group of given width separately.
+    Row result = values;
+    resolve_activation(SOFTMAX)(result.data(), count, count / 2);
+    Row first(values.begin(), values.begin() + count / 2);
+    Row second(values.begin() + count / 2, values.end());
+    Row expected = softmax(first);
+    Row expectedSecond = softmax(second);
+    expected.insert(expected.end(), expectedSecond.begin(),
+                    expectedSecond.end());
+    for (unsigned int i = 0; i < count; i++) {
+        QVERIFY2(near_double(result[i], expected[i], 0.0000001),
+                 qPrintable(QString("Softmax kernel differs from "
+                                    "math.hh: %1 != %2")
+                            .arg(result[i]).arg(expected[i])));
+    }
+}
+
+void TestNeuralNetwork::test_dense_layer_kernels()
+{
+    Random rand;
+    std::vector<unsigned int> shapes = {1, 2, 3, 4, 5, 7, 8, 13, 30, 64};
+    std::vector<kernel_type> kernels = {KERNEL_SSE2, KERNEL_AVX2};
+    kernel_type original = get_kernel();
+
+    for (unsigned int columns : shapes) {
+        // Rows padded like those of a weight set, without the groups.
+        unsigned int rows = columns + 1;
+        unsigned int stride = WeightSet::padded(columns);
+        AlignedRow weights(static_cast<size_t>(rows) * stride, 0);
+        Row bias;
+        for (unsigned int j = 0; j < rows; j++) {
+            double *row = weights.data() + j * stride;
+            for (unsigned int k = 0; k < columns; k++) {
+                row[k] = rand.random_double(-2.0, 2.0);
+            }
+            bias.push_back(rand.random_double(-1.0, 1.0));
+        }
+        Row input;
+        for (unsigned int k = 0; k < columns; k++) {
+            input.push_back(rand.random_double(-1.0, 1.0));
+        }
+
+        Row expected(rows, 0);
+        set_kernel(KERNEL_SCALAR);
+        dense_layer(weights.data(), rows, columns, stride,
+                    input.data(), bias.data(), expected.data());
+
+        for (kernel_type kernel : kernels) {
+            set_kernel(kernel);
+            if (get_kernel() != kernel) continue; // Not supported.
+
+            Row result(rows, 0);
+            dense_layer(weights.data(), rows, columns, stride,
+                        input.data(), bias.data(), result.data());
+
+            for (unsigned int j = 0; j < rows; j++) {
+                const double *row = weights.data() + j * stride;
+                double magnitude = abs(bias[j]);
+                for (unsigned int k = 0; k < columns; k++) {
+                    magnitude += abs(row[k] * input[k]);
+                }
+                QVERIFY2(abs(result[j] - expected[j])
+                         <= KERNEL_TOLERANCE * magnitude,
+                         qPrintable(QString("Kernel %1 differs from the "
+                                            "scalar kernel: %2 != %3 "
+                                            "(%4 columns)")
+                                    .arg(static_cast<int>(kernel)).arg(result[j])
+                                    .arg(expected[j]).arg(columns)));
+            }
+        }
+    }
+    set_kernel(original);
+}
+
+void TestNeuralNetwork::test_feed_forward()
+{
+    Settings *settings = Settings::get_settings();
+    settings->use_default_settings();
+    Random rand;
+
+    std::vector<input_type> inputs = {ANGULAR_DIFFERENCE,
+                                      SPACE_AXIS_DIFFERENCE,
+                                      WALL_DISTANCES};
+    std::vector<unsigned int> widths = {1, 5, 30};
+
+    for (input_type input : inputs) {
+        for (unsigned int width : widths) {
+            settings->set_input_type(input);
+            settings->set_hidden_neuron_count(width);
+            NeuralNetwork nn(settings, rand);
+            nn.mutate();
+            nn.setBias(0.1);
+
+            Row in;
+            for (unsigned int i = 0; i < nn.getWeights()[0][0].size(); i++) {
+                in.push_back(rand.random_double(0.0, 1.0));
+            }
+            Row expected = reference_feed_forward(nn.getWeights(), in,
+                                                  nn.getBiases(), sigmoid);
+            Row result = nn.feedForward(in);
+
+            QCOMPARE(result.size(), expected.size());
+            for (unsigned int i = 0; i < result.size(); i++) {
+                QVERIFY2(near_double(result[i], expected[i], 0.0000001),
+                         qPrintable(QString("feedForward differs from the "
+                                            "reference: %1 != %2")
+                                    .arg(result[i]).arg(expected[i])));
+            }
+        }
+    }
+    settings->use_default_settings();
+}
+
+void TestNeuralNetwork::test_batch_engine()
+{
+    Settings *settings = Settings::get_settings();
+    settings->use_default_settings();
+    settings->set_input_type(WALL_DISTANCES);
+    settings->set_output_type(FIXED_MOVEMENT);
+    settings->set_hidden_neuron_count(7);
+    Random rand;
+
+    std::vector<activation_type> outputActivations = {SIGMOID, SOFTMAX};
+    for (activation_type outputActivation : outputActivations) {
+        settings->set_activation_function_output(outputActivation);
+
+        std::vector<NeuralNetwork*> networks;
+        for (unsigned int n = 0; n < 5; n++) {
+            NeuralNetwork *nn = new NeuralNetwork(settings, rand);
+            nn->mutate();
+            nn->setBias(0.1 * n);
+            networks.push_back(nn);
+        }
+
+        BatchEngine engine;
+        engine.pack(networks);
+        QCOMPARE(engine.getPopulation(), 5u);
+        QCOMPARE(engine.getOutputCount(), 4u);
+
+        std::vector<Row> inputs;
+        for (unsigned int n = 0; n < networks.size(); n++) {
+            Row in;
+            for (unsigned int i = 0; i < 4; i++) {
+                in.push_back(rand.random_double(0.0, 1.0));
+            }
+            engine.setInputs(n, in);
+            inputs.push_back(in);
+        }
+        engine.run();
+
+        for (unsigned int n = 0; n < networks.size(); n++) {
+            Row expected = networks[n]->feedForward(inputs[n]);
+            const double *result = engine.getOutputs(n);
+            for (unsigned int i = 0; i < expected.size(); i++) {
+                QVERIFY2(near_double(result[i], expected[i], 0.0000001),
+                         qPrintable(QString("Batch engine differs from "
+                                            "feedForward: %1 != %2")
+                                    .arg(result[i]).arg(expected[i])));
+            }
+        }
+
+        for (NeuralNetwork *nn : networks) delete nn;
+    }
+    settings->use_default_settings();
+}
+
+void TestNeuralNetwork::test_single_precision()
+{
+    Settings *settings = Settings::get_settings();
+    settings->use_default_settings();
+    settings->set_input_type(WALL_DISTANCES);
+    settings->set_output_type(FIXED_MOVEMENT);
+    settings->set_hidden_neuron_count(9);
+    settings->set_network_precision(SINGLE_PRECISION);
+    Random rand;
+
+    std::vector<NeuralNetwork*> networks;
+    for (unsigned int n = 0; n < 4; n++) {
+        NeuralNetwork *nn = new NeuralNetwork(settings, rand);
+        nn->mutate();
+        nn->setBias(0.1 * n);
+        networks.push_back(nn);
+    }
+    QCOMPARE(networks[0]->getPrecision(), SINGLE_PRECISION);
+
+    // The float copy has to follow the double precision weights.
+    const WeightSet &weights = networks[0]->getWeightSet();
+    const FloatWeightSet &floatWeights = networks[0]->getFloatWeightSet();
+    QVERIFY(floatWeights.sameLayout(weights));
+    for (unsigned int i = 0; i < weights.layerCount(); i++) {
+        for (unsigned int j = 0; j < weights.rows(i); j++) {
+            for (unsigned int k = 0; k < weights.columns(i); k++) {
+                QCOMPARE(floatWeights.row(i, j)[k],
+                         static_cast<float>(weights.row(i, j)[k]));
+            }
+        }
+    }
+
+    BatchEngine engine;
+    engine.pack(networks);
+    QCOMPARE(engine.getPrecision(), SINGLE_PRECISION);
+
+    std::vector<Row> inputs;
+    for (unsigned int n = 0; n < networks.size(); n++) {
+        Row in;
+        for (unsigned int i = 0; i < 4; i++) {
+            in.push_back(rand.random_double(0.0, 1.0));
+        }
+        engine.setInputs(n, in);
+        inputs.push_back(in);
+    }
+    engine.run();
+
+    for (unsigned int n = 0; n < networks.size(); n++) {
+        Row expected = reference_feed_forward(networks[n]->getWeights(),
+                                              inputs[n],
+                                              networks[n]->getBiases(),
+                                              sigmoid);
+        Row result = networks[n]->feedForward(inputs[n]);
+        const double *batched = engine.getOutputs(n);
+        QCOMPARE(result.size(), expected.size());
+        for (unsigned int i = 0; i < expected.size(); i++) {
+            QVERIFY2(near_double(result[i], expected[i], 0.0001),
+                     qPrintable(QString("Single precision differs from "
+                                        "double precision: %1 != %2")
+                                .arg(result[i]).arg(expected[i])));
+            QVERIFY2(near_double(batched[i], result[i], 0.0001),
+                     qPrintable(QString("Batch engine differs from "
+                                        "feedForward: %1 != %2")
+                                .arg(batched[i]).arg(result[i])));
+        }
+    }
+
+    for (NeuralNetwork *nn : networks) delete nn;
+    settings->use_default_settings();
+}
+
+void TestNeuralNetwork::test_int8_dense_layer_kernels()
+{
+    Random rand;
+    std::vector<unsigned int> shapes = {1, 2, 15, 16, 17, 31, 32, 33, 100};
+    std::vector<kernel_type> kernels = {KERNEL_SSE2, KERNEL_AVX2};
+    kernel_type original = get_kernel();
+
+    for (unsigned int columns : shapes) {
+        unsigned int rows = columns % 7 + 1;
+        unsigned int stride = Int8WeightSet::padded(columns);
+        AlignedVector<int8_t> weights(static_cast<size_t>(rows) * stride, 0);
+        for (unsigned int j = 0; j < rows; j++) {
+            int8_t *row = weights.data() + j * stride;
+            for (unsigned int k = 0; k < columns; k++) {
+                row[k] = static_cast<int8_t>(rand.random_int(-127, 127));
+            }
+        }
+        std::vector<int8_t> input;
+        for (unsigned int k = 0; k < columns; k++) {
+            input.push_back(static_cast<int8_t>(rand.random_int(-127, 127)));
+        }
+
+        std::vector<int32_t> expected(rows, 0);
+        set_kernel(KERNEL_SCALAR);
+        dense_layer_int8(weights.data(), rows, columns, stride,
+                         input.data(), expected.data());
+
+        for (kernel_type kernel : kernels) {
+            set_kernel(kernel);
+            if (get_kernel() != kernel) continue; // Not supported.
+
+            std::vector<int32_t> result(rows, 0);
+            dense_layer_int8(weights.data(), rows, columns, stride,
+                             input.data(), result.data());
+            for (unsigned int j = 0; j < rows; j++) {
+                QCOMPARE(result[j], expected[j]);
+            }
+        }
+    }
+    set_kernel(original);
+}
+
+void TestNeuralNetwork::test_quantized_precision()
+{
+    Settings *settings = Settings::get_settings();
+    settings->use_default_settings();
+    settings->set_input_type(WALL_DISTANCES);
+    settings->set_output_type(FIXED_MOVEMENT);
+    settings->set_hidden_neuron_count(9);
+    settings->set_network_precision(QUANTIZED_PRECISION);
+    Random rand;
+
+    std::vector<NeuralNetwork*> networks;
+    for (unsigned int n = 0; n < 4; n++) {
+        NeuralNetwork *nn = new NeuralNetwork(settings, rand);
+        nn->mutate();
+        nn->setBias(0.1 * n);
+        networks.push_back(nn);
+    }
+    QCOMPARE(networks[0]->getPrecision(), QUANTIZED_PRECISION);
+
+    // The quantized copy has to follow the double precision weights.
+    const QuantizedWeightSet &quantized =
+            networks[0]->getQuantizedWeightSet();
+    vector<Matrix> original = networks[0]->getWeights();
+    vector<Matrix> restored = quantized.dequantize();
+    QCOMPARE(restored.size(), original.size());
+    for (unsigned int i = 0; i < original.size(); i++) {
+        double step = quantized.getScale(i);
+        for (unsigned int j = 0; j < original[i].size(); j++) {
+            for (unsigned int k = 0; k < original[i][j].size(); k++) {
+                QVERIFY(abs(restored[i][j][k] - original[i][j][k])
+                        <= 0.5 * step + 0.000001);
+            }
+        }
+    }
+
+    BatchEngine engine;
+    engine.pack(networks);
+    QCOMPARE(engine.getPrecision(), QUANTIZED_PRECISION);
+
+    std::vector<Row> inputs;
+    for (unsigned int n = 0; n < networks.size(); n++) {
+        Row in;
+        for (unsigned int i = 0; i < 4; i++) {
+            in.push_back(rand.random_double(0.0, 1.0));
+        }
+        engine.setInputs(n, in);
+        inputs.push_back(in);
+    }
+    engine.run();
+
+    for (unsigned int n = 0; n < networks.size(); n++) {
+        Row expected = reference_feed_forward(networks[n]->getWeights(),
+                                              inputs[n],
+                                              networks[n]->getBiases(),
+                                              sigmoid);
+        Row result = networks[n]->feedForward(inputs[n]);
+        const double *batched = engine.getOutputs(n);
+        QCOMPARE(result.size(), expected.size());
+        for (unsigned int i = 0; i < expected.size(); i++) {
+            QVERIFY2(near_double(result[i], expected[i], 0.05),
+                     qPrintable(QString("Quantized precision differs from "
+                                        "double precision: %1 != %2")
+                                .arg(result[i]).arg(expected[i])));
+            QVERIFY2(near_double(batched[i], result[i], 0.00001),
+                     qPrintable(QString("Batch engine differs from "
+                                        "feedForward: %1 != %2")
+                                .arg(batched[i]).arg(result[i])));
+        }
+    }
+
+    for (NeuralNetwork *nn : networks) delete nn;
+    settings->use_default_settings();
+}
+
+void TestNeuralNetwork::test_zero_allocation_inference()
+{
+    Settings *settings = Settings::get_settings();
+    settings->use_default_settings();
+    settings->set_input_type(WALL_DISTANCES);
+    settings->set_output_type(FIXED_MOVEMENT);
+    settings->set_hidden_neuron_count(6);
+    Random rand;
+
+    std::vector<precision_type> precisions = {
+        DOUBLE_PRECISION, SINGLE_PRECISION, QUANTIZED_PRECISION
+    };
+    std::vector<activation_type> outputActivations = {SIGMOID, SOFTMAX};
+    for (precision_type precision : precisions) {
+        for (activation_type outputActivation : outputActivations) {
+            settings->set_network_precision(precision);
+            settings->set_activation_function_output(outputActivation);
+
+            std::vector<NeuralNetwork*> networks;
+            for (unsigned int n = 0; n < 3; n++) {
+                networks.push_back(new NeuralNetwork(settings, rand));
+            }
+            BatchEngine engine;
+            engine.pack(networks);
+
+            Row inputs = {0.1, 0.2, 0.3, 0.4};
+            unsigned int inputCount = static_cast<unsigned int>(inputs.size());
+            Row outputs(networks[0]->getOutputCount(), 0);
+            double total = 0;
+
+            // Simulate a few ticks.
+            allocation_count = 0;
+            counting_allocations = true;
+            for (unsigned int tick = 0; tick < 10; tick++) {
+                for (unsigned int n = 0; n < networks.size(); n++) {
+                    engine.setInputs(n, inputs);
+                }
+                engine.run();
+                for (unsigned int n = 0; n < networks.size(); n++) {
+                    networks[n]->feedForward(inputs.data(), inputCount,
+                                             outputs.data());
+                    total += outputs[0] + engine.getOutputs(n)[0];
+                }
+            }
+            counting_allocations = false;
+
+            QVERIFY2(allocation_count == 0,
+                     qPrintable(QString("%1 allocations during inference "
+                                        "(precision %2, output activation %3)")
+                                .arg(allocation_count)
+                                .arg(static_cast<int>(precision))
+                                .arg(static_cast<int>(outputActivation))));
+            QVERIFY(total > 0);
+
+            for (NeuralNetwork *nn : networks) delete nn;
+        }
+    }
+
+    // Whole ticks of the simulation, through every input and output
+    // type, once the first tick has set up the buffers.
+    settings->use_default_settings();
+    settings->set_thread_count(1);
+    SubjectCore target;
+    SubjectCore mousePoint;
+    target.setCoordinates(XY(350, 350));
+    SubjectCore::setPublicInstance(&target, 1);
+    SubjectCore::setPublicInstance(&mousePoint, 4);
+    std::vector<std::pair<input_type, output_type>> types;
+    for (int i = NO_INPUT; i <= FOUR_CORNER_SEARCH; i++) {
+        types.push_back({static_cast<input_type>(i), ANGULAR_VELOCITY});
+    }
+    for (int o = NO_OUTPUT; o <= FIXED_MOVEMENT; o++) {
+        types.push_back({WALL_DISTANCES, static_cast<output_type>(o)});
+    }
+    for (const std::pair<input_type, output_type> &type : types) {
+        settings->set_input_type(type.first);
+        settings->set_output_type(type.second);
+        Manager manager(settings, rand);
+        manager.initialize(&target, nullptr, nullptr, &mousePoint, nullptr);
+        manager.update();
+
+        allocation_count = 0;
+        counting_allocations = true;
+        for (unsigned int tick = 0; tick < 10; tick++) manager.update();
+        counting_allocations = false;
+
+        QCOMPARE(manager.get_generation_count(), 1u);
+        QVERIFY2(allocation_count == 0,
+                 qPrintable(QString("%1 allocations during 10 ticks "
+                                    "(input %2, output %3)")
+                            .arg(allocation_count)
+                            .arg(static_cast<int>(type.first))
+                            .arg(static_cast<int>(type.second))));
+    }
+    SubjectCore::setPublicInstance(nullptr, 1);
+    SubjectCore::setPublicInstance(nullptr, 4);
+    settings->use_default_settings();
+}
+
+void TestNeuralNetwork::test_network_recycling()
+{
+    Settings *settings = Settings::get_settings();
+    settings->use_default_settings();
+    settings->set_input_type(WALL_DISTANCES);
+    settings->set_output_type(FIXED_MOVEMENT);
+    settings->set_hidden_neuron_count(5);
+    settings->set_network_precision(SINGLE_PRECISION);
+    Random rand;
+
+    NetworkPool pool;
+    pool.initialize(settings, rand, 4);
+    QCOMPARE(pool.size(), 4u);
+    const std::vector<NeuralNetwork*> &networks = pool.getNetworks();
+    NeuralNetwork &parent1 = *networks[0];
+    NeuralNetwork &parent2 = *networks[1];
+    NeuralNetwork &copy = *networks[2];
+    NeuralNetwork &child = *networks[3];
+
+    allocation_count = 0;
+    counting_allocations = true;
+    for (unsigned int generation = 0; generation < 20; generation++) {
+        parent2.mutate();
+        copy.copyFrom(parent1);
+        child.breedFrom(parent1, parent2);
+    }
+    counting_allocations = false;
+    QCOMPARE(allocation_count, 0u);
+
+    const WeightSet &source1 = parent1.getWeightSet();
+    const WeightSet &source2 = parent2.getWeightSet();
+    const WeightSet &copied = copy.getWeightSet();
+    for (unsigned int i = 0; i < source1.layerCount(); i++) {
+        for (unsigned int g = 0; g < source1.groupCount(i); g++) {
+            for (size_t n = 0; n < source1.groupSize(i, g); n++) {
+                QCOMPARE(copied.group(i, g)[n], source1.group(i, g)[n]);
+            }
+        }
+    }
+
+    const WeightSet &bred = child.getWeightSet();
+    QVERIFY(bred.sameLayout(source1));
+    for (unsigned int i = 0; i < source1.layerCount(); i++) {
+        for (unsigned int j = 0; j < source1.rows(i); j++) {
+            for (unsigned int k = 0; k < source1.columns(i); k++) {
+                double weight = bred.row(i, j)[k];
+                QVERIFY(weight == source1.row(i, j)[k]
+                        || weight == source2.row(i, j)[k]);
+            }
+        }
+    }
+
+    Row inputs = {0.5, 0.25, 0.75, 1.0};
+    Row fromCopy = copy.feedForward(inputs);
+    Row fromSource = parent1.feedForward(inputs);
+    for (unsigned int i = 0; i < fromCopy.size(); i++) {
+        QCOMPARE(fromCopy[i], fromSource[i]);
+    }
+
+    pool.clear();
+    QCOMPARE(pool.size(), 0u);
+    settings->use_default_settings();
+}
+
+void TestNeuralNetwork::test_crossover()
+{
+    Random rand;
+    std::vector<unsigned int> layers = {20, 30, 10};
+    std::vector<WeightSet> parents(3, WeightSet(layers));
+    for (unsigned int p = 0; p < parents.size(); p++) {
+        double value = 1;
+        for (unsigned int i = 0; i < parents[p].layerCount(); i++) {
+            for (unsigned int j = 0; j < parents[p].rows(i); j++) {
+                double *row = parents[p].mutableRow(i, j);
+                for (unsigned int k = 0; k < parents[p].columns(i); k++) {
+                    row[k] = (p + 1) * 1000 + value;
+                    value += 1;
+                }
+            }
+            double *bias = parents[p].mutableBias(i);
+            for (unsigned int j = 0; j < parents[p].rows(i); j++) {
+                bias[j] = (p + 1) * 1000 + value;
+                value += 1;
+            }
+        }
+    }
+
+    std::vector<kernel_type> kernels = {KERNEL_SCALAR, KERNEL_AVX2};
+    std::vector<crossover_type> types = {
+        UNIFORM_CROSSOVER, SINGLE_POINT_CROSSOVER, LAYER_CROSSOVER
+    };
+    kernel_type original = get_kernel();
+
+    for (kernel_type kernel : kernels) {
+        set_kernel(kernel);
+        if (get_kernel() != kernel) continue; // Not supported.
+
+        for (crossover_type type : types) {
+            for (unsigned int parentCount = 2; parentCount <= 3; parentCount++) {
+                std::vector<unsigned int> picks(parentCount, 0);
+                for (unsigned int trial = 0; trial < 20; trial++) {
+                    WeightSet child(layers);
+                    if (parentCount == 2) {
+                        crossover(type, parents[0], parents[1], child, rand);
+                    } else {
+                        crossover(type, parents[0], parents[1], parents[2],
+                                  child, rand);
+                    }
+
+                    unsigned int previous = 0;
+                    for (unsigned int i = 0; i < child.layerCount(); i++) {
+                        // Weights and biases of the layer in storage
+                        // order, for the child and each parent.
+                        std::vector<Row> genes(parentCount + 1);
+                        std::vector<const WeightSet*> sets;
+                        for (unsigned int p = 0; p < parentCount; p++) {
+                            sets.push_back(&parents[p]);
+                        }
+                        sets.push_back(&child);
+                        for (unsigned int p = 0; p <= parentCount; p++) {
+                            const WeightSet &set = *sets[p];
+                            for (unsigned int j = 0; j < set.rows(i); j++) {
+                                const double *row = set.row(i, j);
+                                genes[p].insert(genes[p].end(), row,
+                                                row + set.columns(i));
+                            }
+                            genes[p].insert(genes[p].end(), set.bias(i),
+                                            set.bias(i) + set.rows(i));
+                        }
+                        for (unsigned int j = 0; j < child.rows(i); j++) {
+                            const double *row = child.row(i, j);
+                            for (unsigned int k = child.columns(i);
+                                 k < child.stride(i); k++) {
+                                QCOMPARE(row[k], 0.0);
+                            }
+                        }
+
+                        unsigned int layerParent = parentCount;
+                        const Row &childGenes = genes[parentCount];
+                        for (size_t n = 0; n < childGenes.size(); n++) {
+                            unsigned int parent = parentCount;
+                            for (unsigned int p = 0; p < parentCount; p++) {
+                                if (childGenes[n] == genes[p][n]) parent = p;
+                            }
+                            QVERIFY2(parent < parentCount,
+                                     "Weight does not come from a parent");
+                            picks[parent]++;
+
+                            if (type == SINGLE_POINT_CROSSOVER) {
+                                QVERIFY(parent >= previous);
+                                previous = parent;
+                            } else if (type == LAYER_CROSSOVER) {
+                                if (layerParent == parentCount) {
+                                    layerParent = parent;
+                                }
+                                QCOMPARE(parent, layerParent);
+                            }
+                        }
+                    }
+                }
+
+                if (type == UNIFORM_CROSSOVER) {
+                    unsigned int total = 0;
+                    for (unsigned int count : picks) total += count;
+                    for (unsigned int count : picks) {
+                        double share = static_cast<double>(count) / total;
+                        QVERIFY2(abs(share - 1.0 / parentCount) < 0.05,
+                                 qPrintable(QString("Uneven uniform "
+                                                    "crossover: %1")
+                                            .arg(share)));
+                    }
+                }
+            }
+        }
+    }
+    set_kernel(original);
+}
+
+void TestNeuralNetwork::test_mutation()
+{
+    Random rand;
+    std::vector<unsigned int> layers = {40, 30, 10};
+    const double scaleMin = 10;
+    const double scaleMax = 20;
+    std::vector<double> probabilities = {0.0, 0.02, 0.1, 0.5, 1.0};
+
+    for (double probability : probabilities) {
+        // Negate, scale, grow, and shrink or resample.
+        std::vector<unsigned int> kinds(4, 0);
+        size_t total = 0;
+        size_t mutated = 0;
+        for (unsigned int trial = 0; trial < 40; trial++) {
+            WeightSet original(layers);
+            double value = 100;
+            for (unsigned int i = 0; i < original.layerCount(); i++) {
+                for (unsigned int j = 0; j < original.rows(i); j++) {
+                    double *row = original.mutableRow(i, j);
+                    for (unsigned int k = 0; k < original.columns(i); k++) {
+                        row[k] = value;
+                        value += 0.0001;
+                    }
+                }
+                double *bias = original.mutableBias(i);
+                for (unsigned int j = 0; j < original.rows(i); j++) {
+                    bias[j] = value;
+                    value += 0.0001;
+                }
+            }
+
+            WeightSet weights = original;
+            size_t reported = mutate_weights(weights, probability,
+                                             scaleMin, scaleMax, rand);
+
+            // Weights and biases before and after mutation.
+            Row before;
+            Row after;
+            for (unsigned int i = 0; i < weights.layerCount(); i++) {
+                for (unsigned int j = 0; j < weights.rows(i); j++) {
+                    const double *row = weights.row(i, j);
+                    for (unsigned int k = weights.columns(i);
+                         k < weights.stride(i); k++) {
+                        QCOMPARE(row[k], 0.0);
+                    }
+                    for (unsigned int k = 0; k < weights.columns(i); k++) {
+                        before.push_back(original.row(i, j)[k]);
+                        after.push_back(row[k]);
+                    }
+                }
+                const double *bias = weights.bias(i);
+                size_t biasEnd = WeightSet::padded(weights.rows(i));
+                for (size_t j = weights.rows(i); j < biasEnd; j++) {
+                    QCOMPARE(bias[j], 0.0);
+                }
+                for (unsigned int j = 0; j < weights.rows(i); j++) {
+                    before.push_back(original.bias(i)[j]);
+                    after.push_back(bias[j]);
+                }
+            }
+
+            size_t changed = 0;
+            for (size_t n = 0; n < before.size(); n++) {
+                total++;
+                if (after[n] == before[n]) continue;
+                changed++;
+                if (after[n] == -before[n]) {
+                    kinds[0]++;
+                } else if (after[n] >= before[n] * scaleMin
+                           && after[n] < before[n] * scaleMax) {
+                    kinds[1]++;
+                } else if (after[n] > before[n] && after[n] < before[n] * 2) {
+                    kinds[2]++;
+                } else {
+                    QVERIFY2(after[n] >= 0 && after[n] < before[n],
+                             "Weight mutated in an unknown way");
+                    kinds[3]++;
+                }
+            }
+            QCOMPARE(changed, reported);
+            mutated += reported;
+        }
+
+        double rate = static_cast<double>(mutated) / total;
+        QVERIFY2(abs(rate - probability) < 0.01,
+                 qPrintable(QString("Mutation rate %1, expected %2")
+                            .arg(rate).arg(probability)));
+        if (mutated < 10000) continue; // Too few for a tight check.
+
+        double changedTotal = 0;
+        for (unsigned int count : kinds) changedTotal += count;
+        for (unsigned int kind = 0; kind < kinds.size(); kind++) {
+            double share = kinds[kind] / changedTotal;
+            double expected = kind == 3 ? 0.4 : 0.2;
+            QVERIFY2(abs(share - expected) < 0.03,
+                     qPrintable(QString("Uneven mutation kinds: %1")
+                                .arg(share)));
+        }
+    }
+}
+
+void TestNeuralNetwork::test_copy_on_write()
+{
+    // Default shape and mutation probability.
+    Settings *settings = Settings::get_settings();
+    settings->use_default_settings();
+    settings->set_input_type(WALL_DISTANCES);
+    settings->set_output_type(FIXED_MOVEMENT);
+    // Biases of 0 could mutate without changing.
+    settings->set_initial_bias(100);
+    Random rand;
+
+    NeuralNetwork parent(settings, rand);
+    NeuralNetwork copy(settings, rand);
+    const WeightSet &original = parent.getWeightSet();
+    std::vector<Matrix> before = parent.getWeights();
+
+    unsigned int sharedGroups = 0;
+    unsigned int copiedGroups = 0;
+    allocation_count = 0;
+    for (unsigned int generation = 0; generation < 50; generation++) {
+        // The first rounds may allocate the spare groups.
+        counting_allocations = generation >= 5;
+        copy.copyFrom(parent);
+        for (unsigned int i = 0; i < original.layerCount(); i++) {
+            QVERIFY(copy.getWeightSet().sharesBlock(i, original));
+        }
+        copy.mutate();
+        counting_allocations = false;
+
+        const WeightSet &mutated = copy.getWeightSet();
+        for (unsigned int i = 0; i < original.layerCount(); i++) {
+            for (unsigned int g = 0; g < original.groupCount(i); g++) {
+                bool equal = true;
+                for (size_t n = 0; n < original.groupSize(i, g); n++) {
+                    if (mutated.group(i, g)[n] != original.group(i, g)[n]) {
+                        equal = false;
+                    }
+                }
+                if (mutated.sharesGroup(i, g, original)) {
+                    sharedGroups++;
+                } else {
+                    QVERIFY2(!equal, "Group was copied without mutations");
+                    copiedGroups++;
+                }
+            }
+        }
+    }
+    QCOMPARE(allocation_count, 0u);
+    // At 10 % per weight, a row of ten weights has no mutations about
+    // a third of the time.
+    QVERIFY2(sharedGroups > (sharedGroups + copiedGroups) / 5,
+             qPrintable(QString("%1 groups shared, %2 copied")
+                        .arg(sharedGroups).arg(copiedGroups)));
+    QVERIFY(copiedGroups > 0);
+    QVERIFY(parent.getWeights() == before);
+
+    settings->use_default_settings();
+}
+
+void TestNeuralNetwork::test_sparse_network()
+{
+    Random rand;
+
+    // Pruning.
+    WeightSet weights({3, 2});
+    double values[2][3] = {{0.1, -0.6, 0.0}, {-0.2, 0.5, 2.0}};
+    for (unsigned int j = 0; j < 2; j++) {
+        for (unsigned int k = 0; k < 3; k++) {
+            weights.mutableRow(0, j)[k] = values[j][k];
+        }
+    }
+    WeightSet unpruned = weights;
+    QCOMPARE(prune_weights(weights, 0.01), size_t(0));
+    QVERIFY(weights.sharesBlock(0, unpruned));
+    QCOMPARE(prune_weights(weights, 0.55), size_t(3));
+    QVERIFY(!weights.sharesBlock(0, unpruned));
+    double pruned[2][3] = {{0.0, -0.6, 0.0}, {0.0, 0.0, 2.0}};
+    for (unsigned int j = 0; j < 2; j++) {
+        for (unsigned int k = 0; k < 3; k++) {
+            QCOMPARE(weights.row(0, j)[k], pruned[j][k]);
+            QCOMPARE(unpruned.row(0, j)[k], values[j][k]);
+        }
+    }
+
+    // Sparse kernel against the dense kernel.
+    unsigned int rows = 9;
+    unsigned int columns = 13;
+    WeightSet block({columns, rows});
+    for (unsigned int j = 0; j < rows; j++) {
+        double *row = block.mutableRow(0, j);
+        for (unsigned int k = 0; k < columns; k++) {
+            if (rand.random_int(0, 3) == 0) row[k] = rand.random_double(-2.0, 2.0);
+        }
+        block.mutableBias(0)[j] = rand.random_double(-1.0, 1.0);
+    }
+    Row input;
+    for (unsigned int k = 0; k < columns; k++) {
+        input.push_back(rand.random_double(-1.0, 1.0));
+    }
+    SparseWeightSet sparse;
+    sparse.compress(block, 1.0);
+    QVERIFY(sparse.isSparse(0));
+    QVERIFY(sparse.getDensity(0) < 0.5);
+    Row expected(rows, 0);
+    Row result(rows, 0);
+    for (unsigned int j = 0; j < rows; j++) {
+        dense_layer(block.row(0, j), 1, columns, block.stride(0),
+                    input.data(), block.bias(0) + j, expected.data() + j);
+    }
+    sparse_layer(sparse.values(0), sparse.columnIndices(0),
+                 sparse.rowStarts(0), rows, input.data(), block.bias(0),
+                 result.data());
+    for (unsigned int j = 0; j < rows; j++) {
+        QVERIFY(near_double(result[j], expected[j], 0.0000001));
+    }
+    sparse.compress(block, 0.0);
+    QVERIFY(!sparse.isSparse(0));
+
+    // Pruned network.
+    Settings *settings = Settings::get_settings();
+    settings->use_default_settings();
+    settings->set_input_type(WALL_DISTANCES);
+    settings->set_hidden_neuron_count(30);
+    settings->set_initial_weight_minimum(-1.0);
+    settings->set_initial_weight_maximum(1.0);
+    settings->set_pruning_threshold(0.5);
+    settings->set_sparse_density(0.9);
+
+    NeuralNetwork nn(settings, rand);
+    nn.setBias(0.1);
+    QVERIFY(nn.prune() > 0);
+    QCOMPARE(nn.prune(), size_t(0));
+    const WeightSet &prunedWeights = nn.getWeightSet();
+    bool anySparse = false;
+    for (unsigned int i = 0; i < prunedWeights.layerCount(); i++) {
+        for (unsigned int j = 0; j < prunedWeights.rows(i); j++) {
+            for (unsigned int k = 0; k < prunedWeights.columns(i); k++) {
+                double weight = prunedWeights.row(i, j)[k];
+                QVERIFY(weight == 0 || abs(weight) >= 0.5);
+            }
+        }
+        if (nn.getSparseWeightSet().isSparse(i)) anySparse = true;
+    }
+    QVERIFY(anySparse);
+
+    Row in = {0.5, 0.25, 0.75, 1.0};
+    Row reference = reference_feed_forward(nn.getWeights(), in,
+                                           nn.getBiases(), sigmoid);
+    Row out = nn.feedForward(in);
+    QCOMPARE(out.size(), reference.size());
+    for (unsigned int i = 0; i < out.size(); i++) {
+        QVERIFY2(near_double(out[i], reference[i], 0.0000001),
+                 qPrintable(QString("Sparse feedForward differs from the "
+                                    "reference: %1 != %2")
+                            .arg(out[i]).arg(reference[i])));
+    }
+
+    // The batch engine runs the same kernels as feedForward.
+    std::vector<NeuralNetwork*> networks;
+    for (unsigned int n = 0; n < 5; n++) {
+        networks.push_back(new NeuralNetwork(settings, rand));
+        networks[n]->setBias(0.1 * n);
+        networks[n]->prune();
+    }
+    BatchEngine engine;
+    engine.pack(networks);
+    for (unsigned int n = 0; n < networks.size(); n++) {
+        engine.setInputs(n, in);
+    }
+    engine.run();
+    for (unsigned int n = 0; n < networks.size(); n++) {
+        Row expected = networks[n]->feedForward(in);
+        const double *outputs = engine.getOutputs(n);
+        for (unsigned int i = 0; i < expected.size(); i++) {
+            QVERIFY(outputs[i] == expected[i]);
+        }
+        delete networks[n];
+    }
+    settings->use_default_settings();
+}
+
+void TestNeuralNetwork::test_binary_network()
+{
+    Random rand;
+
+    // Rows whose nonzero weights share a magnitude binarize exactly.
+    unsigned int rows = 5;
+    unsigned int columns = 70;
+    WeightSet weights({columns, rows});
+    for (unsigned int j = 0; j < rows; j++) {
+        double magnitude = rand.random_double(0.0, 1.0) + 0.1;
+        double *row = weights.mutableRow(0, j);
+        for (unsigned int k = 0; k < columns; k++) {
+            row[k] = magnitude * (rand.random_int(0, 3) - 1);
+        }
+        weights.mutableBias(0)[j] = rand.random_double(-1.0, 1.0);
+    }
+    Row input;
+    for (unsigned int k = 0; k < columns; k++) {
+        input.push_back(rand.random_int(0, 3) - 1.0);
+    }
+    BinaryWeightSet binary;
+    binary.binarize(weights);
+    QCOMPARE(binary.words(0), 2u);
+    std::vector<uint64_t> positive(2);
+    std::vector<uint64_t> negative(2);
+    pack_signs(input.data(), columns, positive.data(), negative.data());
+
+    Row expected(rows, 0);
+    for (unsigned int j = 0; j < rows; j++) {
+        dense_layer(weights.row(0, j), 1, columns, weights.stride(0),
+                    input.data(), weights.bias(0) + j, expected.data() + j);
+    }
+    std::vector<kernel_type> kernels = {KERNEL_SCALAR, KERNEL_AVX2};
+    kernel_type original = get_kernel();
+    for (kernel_type kernel : kernels) {
+        set_kernel(kernel);
+        if (get_kernel() != kernel) continue; // Not supported.
+        Row result(rows, 0);
+        binary_layer(binary.positive(0), binary.negative(0),
+                     binary.scales(0), rows, binary.words(0),
+                     positive.data(), negative.data(), weights.bias(0),
+                     result.data());
+        for (unsigned int j = 0; j < rows; j++) {
+            QVERIFY(near_double(result[j], expected[j], 0.0000001));
+        }
+    }
+    set_kernel(original);
+
+    // Networks.
+    Settings *settings = Settings::get_settings();
+    settings->use_default_settings();
+    settings->set_input_type(WALL_DISTANCES);
+    settings->set_hidden_layer_count(3);
+    settings->set_hidden_neuron_count(20);
+
+    std::vector<activation_type> types = {SIGN, HEAVISIDE};
+    std::vector<double (*)(double &)> functions = {sign, heaviside};
+    for (unsigned int t = 0; t < types.size(); t++) {
+        settings->set_activation_function_hidden(types[t]);
+        settings->set_activation_function_output(types[t]);
+        NeuralNetwork nn(settings, rand);
+        nn.mutate();
+        nn.setBias(0.1);
+        QVERIFY(nn.isBinary());
+
+        // Every block but the first one receives hidden neurons.
+        vector<Matrix> binarized = nn.getWeights();
+        for (unsigned int i = 1; i < binarized.size(); i++) {
+            for (Row &row : binarized[i]) {
+                double magnitude = 0;
+                unsigned int nonzero = 0;
+                for (double weight : row) {
+                    if (weight == 0) continue;
+                    magnitude += abs(weight);
+                    nonzero++;
+                }
+                if (nonzero > 0) magnitude /= nonzero;
+                for (double &weight : row) {
+                    weight = weight > 0 ? magnitude
+                                        : (weight < 0 ? -magnitude : 0);
+                }
+            }
+        }
+
+        for (unsigned int trial = 0; trial < 10; trial++) {
+            Row in;
+            for (unsigned int i = 0; i < 4; i++) {
+                in.push_back(rand.random_double(0.0, 1.0));
+            }
+            Row reference = reference_feed_forward(binarized, in,
+                                                   nn.getBiases(),
+                                                   functions[t]);
+            Row result = nn.feedForward(in);
+            QCOMPARE(result.size(), reference.size());
+            for (unsigned int i = 0; i < result.size(); i++) {
+                QCOMPARE(result[i], reference[i]);
+            }
+        }
+
+        // The batch engine runs the same kernels as feedForward.
+        std::vector<NeuralNetwork*> networks;
+        for (unsigned int n = 0; n < 20; n++) {
+            networks.push_back(new NeuralNetwork(settings, rand));
+            networks[n]->mutate();
+        }
+        BatchEngine engine;
+        engine.pack(networks);
+        for (unsigned int trial = 0; trial < 20; trial++) {
+            std::vector<Row> inputs;
+            for (unsigned int n = 0; n < networks.size(); n++) {
+                Row in;
+                for (unsigned int i = 0; i < 4; i++) {
+                    in.push_back(rand.random_double(0.0, 1.0));
+                }
+                engine.setInputs(n, in);
+                inputs.push_back(in);
+            }
+            engine.run();
+            for (unsigned int n = 0; n < networks.size(); n++) {
+                Row expected = networks[n]->feedForward(inputs[n]);
+                const double *outputs = engine.getOutputs(n);
+                for (unsigned int i = 0; i < expected.size(); i++) {
+                    QVERIFY(outputs[i] == expected[i]);
+                }
+            }
+        }
+        for (NeuralNetwork *network : networks) delete network;
+    }
+
+    settings->set_activation_function_output(SIGMOID);
+    NeuralNetwork mixed(settings, rand);
+    QVERIFY(!mixed.isBinary());
+    settings->use_default_settings();
+}
+
+void TestNeuralNetwork::test_memoized_inputs()
+{
+    Settings *settings = Settings::get_settings();
+    settings->use_default_settings();
+    settings->set_hidden_layer_count(2);
+    settings->set_hidden_neuron_count(9);
+    Random rand;
+
+    std::vector<input_type> inputs = {FOUR_WAY_SEARCH, FOUR_CORNER_SEARCH};
+    for (input_type input : inputs) {
+        settings->set_input_type(input);
+        NeuralNetwork nn(settings, rand);
+        nn.setBias(0.1);
+
+        for (unsigned int round = 0; round < 3; round++) {
+            if (round == 1) nn.mutate();
+            if (round == 2) nn.setBias(-0.3);
+            vector<Matrix> weights = nn.getWeights();
+
+            for (unsigned int pattern = 0; pattern <= 16; pattern++) {
+                Row in;
+                for (unsigned int i = 0; i < 4; i++) {
+                    in.push_back(pattern & (1u << i) ? 123.5 : 0.0);
+                }
+                // Not a pattern: falls back to the full computation.
+                if (pattern == 16) in = {0.25, 0.5, 0.0, 0.75};
+
+                Row expected = reference_feed_forward(weights, in,
+                                                      nn.getBiases(), sigmoid);
+                Row first = nn.feedForward(in);
+                Row second = nn.feedForward(in);
+                QCOMPARE(first.size(), expected.size());
+                for (unsigned int i = 0; i < first.size(); i++) {
+                    QVERIFY2(near_double(first[i], expected[i], 0.0000001),
+                             qPrintable(QString("Memoized result differs "
+                                                "from the reference: "
+                                                "%1 != %2")
+                                        .arg(first[i]).arg(expected[i])));
+                    QCOMPARE(second[i], first[i]);
+                }
+            }
+        }
+    }
+
+    // The batch engine remembers the outputs of each network for
+    // inputs that are all zero, in every precision.
+    std::vector<precision_type> precisions = {
+        DOUBLE_PRECISION, SINGLE_PRECISION, QUANTIZED_PRECISION
+    };
+    settings->set_input_type(FOUR_WAY_SEARCH);
+    for (precision_type precision : precisions) {
+        settings->set_network_precision(precision);
+        std::vector<NeuralNetwork*> networks;
+        for (unsigned int n = 0; n < 6; n++) {
+            networks.push_back(new NeuralNetwork(settings, rand));
+            networks[n]->mutate();
+        }
+        BatchEngine engine;
+        for (unsigned int round = 0; round < 2; round++) {
+            if (round == 1) {
+                for (NeuralNetwork *network : networks) network->mutate();
+            }
+            engine.pack(networks);
+            for (unsigned int tick = 0; tick < 6; tick++) {
+                std::vector<Row> inputs;
+                for (unsigned int n = 0; n < networks.size(); n++) {
+                    Row in(4, 0.0);
+                    if ((tick + n) % 3 == 0) in[n % 4] = 0.25 * tick;
+                    engine.setInputs(n, in);
+                    inputs.push_back(in);
+                }
+                engine.run();
+                for (unsigned int n = 0; n < networks.size(); n++) {
+                    Row expected = networks[n]->feedForward(inputs[n]);
+                    const double *outputs = engine.getOutputs(n);
+                    for (unsigned int i = 0; i < expected.size(); i++) {
+                        QVERIFY(outputs[i] == expected[i]);
+                    }
+                }
+            }
+        }
+        for (NeuralNetwork *network : networks) delete network;
+    }
+    settings->use_default_settings();
+}
+
+void TestNeuralNetwork::test_response_table()
+{
+    Settings *settings = Settings::get_settings();
+    settings->use_default_settings();
+    settings->set_hidden_neuron_count(7);
+    settings->set_response_table_size(65);
+    Random rand;
+
+    std::vector<NeuralNetwork*> networks;
+    for (unsigned int n = 0; n < 4; n++) {
+        NeuralNetwork *nn = new NeuralNetwork(settings, rand);
+        nn->mutate();
+        nn->setBias(0.1 * n);
+        networks.push_back(nn);
+    }
+
+    for (NeuralNetwork *nn : networks) {
+        QVERIFY(!nn->hasResponseTable());
+        double maxError = nn->compileResponseTable();
+        QVERIFY(nn->hasResponseTable());
+        QCOMPARE(nn->getResponseTable().size(), 65u);
+        QVERIFY2(maxError < 0.01,
+                 qPrintable(QString("Response table is too coarse: %1")
+                            .arg(maxError)));
+
+        vector<Matrix> weights = nn->getWeights();
+        for (unsigned int i = 0; i <= 100; i++) {
+            Row in = {i / 100.0};
+            Row expected = reference_feed_forward(weights, in,
+                                                  nn->getBiases(), sigmoid);
+            Row result = nn->feedForward(in);
+            QCOMPARE(result.size(), expected.size());
+            for (unsigned int j = 0; j < result.size(); j++) {
+                QVERIFY2(std::abs(result[j] - expected[j])
+                         <= maxError + 0.0000001,
+                         qPrintable(QString("Response table exceeds its "
+                                            "reported error: %1 != %2")
+                                    .arg(result[j]).arg(expected[j])));
+            }
+        }
+    }
+
+    // Inputs outside the table are clamped to its ends.
+    Row below = {-0.5};
+    Row start = {0.0};
+    QCOMPARE(networks[0]->feedForward(below),
+             networks[0]->feedForward(start));
+
+    BatchEngine engine;
+    engine.pack(networks);
+    Row inputs;
+    for (unsigned int n = 0; n < networks.size(); n++) {
+        inputs.push_back(rand.random_double(0.0, 1.0));
+        engine.setInputs(n, Row{inputs[n]});
+    }
+    engine.run();
+    for (unsigned int n = 0; n < networks.size(); n++) {
+        Row in = {inputs[n]};
+        Row expected = networks[n]->feedForward(in);
+        const double *result = engine.getOutputs(n);
+        for (unsigned int i = 0; i < expected.size(); i++) {
+            QCOMPARE(result[i], expected[i]);
+        }
+    }
+
+    // Changes to the network discard the table.
+    networks[0]->mutate();
+    QVERIFY(!networks[0]->hasResponseTable());
+    networks[1]->setBias(0.5);
+    QVERIFY(!networks[1]->hasResponseTable());
+
+    for (NeuralNetwork *nn : networks) delete nn;
+
+    settings->set_input_type(WALL_DISTANCES);
+    NeuralNetwork nn(settings, rand);
+    QCOMPARE(nn.compileResponseTable(), 0.0);
+    QVERIFY(!nn.hasResponseTable());
+    settings->use_default_settings();
+}
+
+void TestNeuralNetwork::test_neuron_biases()
+{
+    Settings *settings = Settings::get_settings();
+    settings->use_default_settings();
+    settings->set_input_type(WALL_DISTANCES);
+    settings->set_output_type(FIXED_MOVEMENT);
+    settings->set_hidden_neuron_count(7);
+    settings->set_initial_bias(100);
+    settings->set_mutation_probability(100);
+    settings->set_mutation_scale_minimum(-1.0);
+    settings->set_mutation_scale_maximum(1.0);
+    Random rand;
+
+    // Every neuron starts from the initial bias.
+    NeuralNetwork initial(settings, rand);
+    QCOMPARE(initial.getBias(), 0.1);
+    for (const Row &biases : initial.getBiases()) {
+        for (double bias : biases) QCOMPARE(bias, 0.1);
+    }
+
+    std::vector<precision_type> precisions = {DOUBLE_PRECISION,
+                                              SINGLE_PRECISION,
+                                              QUANTIZED_PRECISION};
+    std::vector<double> tolerances = {0.0000001, 0.0001, 0.05};
+    for (unsigned int p = 0; p < precisions.size(); p++) {
+        settings->set_network_precision(precisions[p]);
+        std::vector<NeuralNetwork*> networks;
+        for (unsigned int n = 0; n < 4; n++) {
+            NeuralNetwork *nn = new NeuralNetwork(settings, rand);
+            nn->mutate();
+            networks.push_back(nn);
+        }
+        Row hidden = networks[0]->getBiases()[0];
+        bool spread = false;
+        for (double bias : hidden) {
+            if (bias != hidden[0]) spread = true;
+        }
+        QVERIFY2(spread, "Mutation did not change the biases");
+
+        BatchEngine engine;
+        engine.pack(networks);
+        std::vector<Row> inputs;
+        for (unsigned int n = 0; n < networks.size(); n++) {
+            Row in;
+            for (unsigned int i = 0; i < 4; i++) {
+                in.push_back(rand.random_double(0.0, 1.0));
+            }
+            engine.setInputs(n, in);
+            inputs.push_back(in);
+        }
+        engine.run();
+
+        for (unsigned int n = 0; n < networks.size(); n++) {
+            Row expected = reference_feed_forward(networks[n]->getWeights(),
+                                                  inputs[n],
+                                                  networks[n]->getBiases(),
+                                                  sigmoid);
+            Row result = networks[n]->feedForward(inputs[n]);
+            const double *batched = engine.getOutputs(n);
+            QCOMPARE(result.size(), expected.size());
+            for (unsigned int i = 0; i < expected.size(); i++) {
+                QVERIFY2(near_double(result[i], expected[i], tolerances[p]),
+                         qPrintable(QString("Biased feedForward differs "
+                                            "from the reference: %1 != %2")
+                                    .arg(result[i]).arg(expected[i])));
+                QVERIFY2(near_double(batched[i], result[i], 0.00001),
+                         qPrintable(QString("Batch engine differs from "
+                                            "feedForward: %1 != %2")
+                                    .arg(batched[i]).arg(result[i])));
+            }
+        }
+
+        // Setting the bias starts every neuron over.
+        networks[0]->setBias(-0.2);
+        for (const Row &biases : networks[0]->getBiases()) {
+            for (double bias : biases) QCOMPARE(bias, -0.2);
+        }
+
+        for (NeuralNetwork *nn : networks) delete nn;
+    }
+    settings->use_default_settings();
+}
+
+void TestNeuralNetwork::test_layer_widths()
+{
+    Settings *settings = Settings::get_settings();
+    settings->use_default_settings();
+    settings->set_input_type(WALL_DISTANCES);
+    settings->set_output_type(FIXED_MOVEMENT);
+    settings->set_hidden_layer_widths({13, 6, 3});
+    Random rand;
+
+    std::vector<precision_type> precisions = {DOUBLE_PRECISION,
+                                              SINGLE_PRECISION,
+                                              QUANTIZED_PRECISION};
+    std::vector<double> tolerances = {0.0000001, 0.0001, 0.05};
+    for (unsigned int p = 0; p < precisions.size(); p++) {
+        settings->set_network_precision(precisions[p]);
+        std::vector<NeuralNetwork*> networks;
+        for (unsigned int n = 0; n < 3; n++) {
+            NeuralNetwork *nn = new NeuralNetwork(settings, rand);
+            nn->mutate();
+            nn->setBias(0.1 * n);
+            networks.push_back(nn);
+        }
+        std::vector<unsigned int> layers = {4, 13, 6, 3, 4};
+        QVERIFY(networks[0]->getLayers() == layers);
+
+        BatchEngine engine;
+        engine.pack(networks);
+        std::vector<Row> inputs;
+        for (unsigned int n = 0; n < networks.size(); n++) {
+            Row in;
+            for (unsigned int i = 0; i < 4; i++) {
+                in.push_back(rand.random_double(0.0, 1.0));
+            }
+            engine.setInputs(n, in);
+            inputs.push_back(in);
+        }
+        // Twice, so that any garbage left in the padding would show.
+        engine.run();
+        engine.run();
+
+        for (unsigned int n = 0; n < networks.size(); n++) {
+            Row expected = reference_feed_forward(networks[n]->getWeights(),
+                                                  inputs[n],
+                                                  networks[n]->getBiases(),
+                                                  sigmoid);
+            networks[n]->feedForward(inputs[n]);
+            Row result = networks[n]->feedForward(inputs[n]);
+            const double *batched = engine.getOutputs(n);
+            QCOMPARE(result.size(), expected.size());
+            for (unsigned int i = 0; i < expected.size(); i++) {
+                QVERIFY2(near_double(result[i], expected[i], tolerances[p]),
+                         qPrintable(QString("Tapered network differs from "
+                                            "the reference: %1 != %2")
+                                    .arg(result[i]).arg(expected[i])));
+                QVERIFY2(near_double(batched[i], result[i], 0.00001),
+                         qPrintable(QString("Batch engine differs from "
+                                            "feedForward: %1 != %2")
+                                    .arg(batched[i]).arg(result[i])));
+            }
+        }
+        for (NeuralNetwork *nn : networks) delete nn;
+    }
+
+    // Scenario files.
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    std::string path = dir.filePath("widths.txt").toStdString();
+    Scenario saved(settings);
+    saved.save_scenario(path);
+    settings->use_default_settings();
+    QVERIFY(settings->get_hidden_layer_widths().empty());
+    Scenario loaded(settings);
+    QCOMPARE(loaded.load_scenario(path), 0);
+    loaded.set_settings(settings);
+    std::vector<unsigned int> widths = {13, 6, 3};
+    QVERIFY(settings->get_hidden_layer_widths() == widths);
+
+    // A file without widths, like the sample scenarios, drops them.
+    std::string older = dir.filePath("older.txt").toStdString();
+    std::ofstream file(older);
+    file << "HIDDEN_LAYER_COUNT:3" << std::endl;
+    file.close();
+    QCOMPARE(loaded.load_scenario(older), 0);
+    loaded.set_settings(settings);
+    QVERIFY(settings->get_hidden_layer_widths().empty());
+    QCOMPARE(settings->get_hidden_layer_count(), 3u);
+
+    settings->use_default_settings();
+}
@@ -0,0 +1,244 @@
+#ifndef TEST_NEURALNETWORK_HH
+#define TEST_NEURALNETWORK_HH
+
+#include <QtTest>
+#include "../shipyard/neuralnetwork.hh"
+#include "../shipyard/layerkernel.hh"
+#include "../shipyard/batchengine.hh"
+#include "../shipyard/networkpool.hh"
+#include "../shipyard/crossover.hh"
+#include "../shipyard/mutation.hh"
+#include "../shipyard/sparse.hh"
+#include "../shipyard/binary.hh"
+#include "../shipyard/activation.hh"
+#include "../shipyard/scenario.hh"
+#include "../shipyard/manager.hh"
+
+/*!
+ * \class TestNeuralNetwork
+ * \brief Collection of test cases for the neural network and its
+ * computational kernels.
+ * \author terratenff
+ */
+class TestNeuralNetwork : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestNeuralNetwork();
+    ~TestNeuralNetwork();
+
+private:
+
+    /*!
+     * \fn reference_feed_forward
+     * \brief Straightforward implementation of the feed forward,
+     * computed from the nested weight matrices of a network.
+     * \param weights Weights of the network.
+     * \param inputs Inputs of the network.
+     * \param biases Biases of the network, one row per layer.
+     * \param activation Activation function for every layer.
+     * \return Outputs of the network.
+     */
+    Row reference_feed_forward(const vector<Matrix> &weights,
+                               const Row &inputs,
+                               const vector<Row> &biases,
+                               double (*activation)(double &));
+private slots:
+
+    /*!
+     * \brief Tests the activation kernels.
+     *
+     * Testing consists of a row of values, both positive and negative,
+     * that is activated by the kernel of every activation function
+     * type. The results are compared with the scalar functions of
+     * math.hh.
+     */
+    void test_activation_kernels();
+
+    /*!
+     * \brief Tests the dense layer kernels.
+     *
+     * Testing consists of weight blocks of various sizes (including
+     * ones whose column count is not a multiple of the vector width)
+     * that are run through every kernel the CPU supports. The
+     * results are compared with those of the scalar kernel, using
+     * the tolerance documented by KERNEL_TOLERANCE.
+     */
+    void test_dense_layer_kernels();
+
+    /*!
+     * \brief Tests the function "feedForward".
+     *
+     * Testing consists of a few networks of different shapes. Their
+     * outputs are compared with a reference implementation that
+     * uses the nested weight matrices of the network.
+     */
+    void test_feed_forward();
+
+    /*!
+     * \brief Tests the batch engine.
+     *
+     * Testing consists of a population of networks with differing
+     * biases, including one with a softmax output layer. Inputs are
+     * evaluated both by the batch engine and by each network's own
+     * feedForward, and the outputs are compared.
+     */
+    void test_batch_engine();
+
+    /*!
+     * \brief Tests the single precision mode.
+     *
+     * Testing consists of a population of networks in single
+     * precision mode. Their outputs, computed both by feedForward and
+     * by the batch engine, are compared with those of the reference
+     * implementation in double precision. The float copy of the
+     * weights is also checked to follow mutations.
+     */
+    void test_single_precision();
+
+    /*!
+     * \brief Tests the integer dense layer kernels.
+     *
+     * Testing consists of 8-bit weight blocks of various sizes that
+     * are run through every kernel the CPU supports. Integer sums
+     * are exact, so the results must equal those of the scalar
+     * kernel.
+     */
+    void test_int8_dense_layer_kernels();
+
+    /*!
+     * \brief Tests the quantized precision mode.
+     *
+     * Testing consists of a population of networks in quantized
+     * precision mode. The dequantized weights must stay within half a
+     * quantization step of the originals, and the outputs, computed
+     * both by feedForward and by the batch engine, must stay close
+     * to those of the reference implementation.
+     */
+    void test_quantized_precision();
+
+    /*!
+     * \brief Tests that inference does not allocate memory.
+     *
+     * Testing consists of a population of networks of every precision
+     * that are evaluated for several ticks, both by the batch engine
+     * and by each network's own feedForward with caller-owned
+     * buffers. Every allocation made during the ticks is counted,
+     * and there may be none.
+     */
+    void test_zero_allocation_inference();
+
+    /*!
+     * \brief Tests the recycling of networks.
+     *
+     * Testing consists of a pool of networks whose members are turned
+     * into copies and children of one another several times over.
+     * Copies must equal their source, every weight of a child must
+     * come from one of its parents, and no memory may be allocated.
+     */
+    void test_network_recycling();
+
+    /*!
+     * \brief Tests the crossover functions.
+     *
+     * Testing consists of two and three parents whose weights are
+     * all distinct. Children are created with every crossover method
+     * and every kernel the CPU supports. Each weight of a child must
+     * come from a parent at the same position, padding must stay
+     * zero, and the parents must be picked as the method dictates:
+     * evenly (uniform), in order (single point) or per layer.
+     */
+    void test_crossover();
+
+    /*!
+     * \brief Tests the mutation of weights.
+     *
+     * Testing consists of weight sets that are mutated repeatedly
+     * with various probabilities. The share of mutated weights must
+     * match the probability, padding must stay zero, and every
+     * mutated weight must be the result of one of the mutation kinds,
+     * each of which must occur about equally often.
+     */
+    void test_mutation();
+
+    /*!
+     * \brief Tests the sharing of weight groups between copies.
+     *
+     * Testing consists of a network that is copied and mutated
+     * repeatedly at the default mutation probability. A fresh copy
+     * must share every group with its source, only groups with
+     * mutations may be copied, and many groups must stay shared. The
+     * source must stay unchanged, and once the spare groups exist,
+     * no memory may be allocated.
+     */
+    void test_copy_on_write();
+
+    /*!
+     * \brief Tests pruning and the sparse representation of weights.
+     *
+     * Testing consists of pruning weights with a threshold, comparing
+     * the sparse kernel with the dense kernel, and processing inputs
+     * with a pruned network whose layers are sparse. Results must
+     * match those of the reference implementation, and the batch
+     * engine must compute exactly what feedForward does.
+     */
+    void test_sparse_network();
+
+    /*!
+     * \brief Tests the bit-packed kernels for binary activations.
+     *
+     * Testing consists of comparing the binary kernel with the dense
+     * kernel on weights that binarize exactly, and processing inputs
+     * with networks whose activation functions are SIGN or HEAVISIDE.
+     * Results must match the reference implementation run on the
+     * binarized weights, and the batch engine must compute exactly
+     * what feedForward does.
+     */
+    void test_binary_network();
+
+    /*!
+     * \brief Tests the memoization of results for input types
+     * FOUR_WAY_SEARCH and FOUR_CORNER_SEARCH.
+     *
+     * Testing consists of processing every pattern of nonzero inputs
+     * repeatedly, before and after the weights and the bias change.
+     * Results must match the reference implementation each time. The
+     * batch engine must give the same outputs as feedForward over
+     * ticks of zero and nonzero inputs, in every precision.
+     */
+    void test_memoized_inputs();
+
+    /*!
+     * \brief Tests the response tables of single-input networks.
+     *
+     * Testing consists of comparing the interpolated outputs to the
+     * true outputs, and to the outputs of the batch engine. The table
+     * must be discarded when the weights or the bias change, and it
+     * must not be compiled for networks with several inputs.
+     */
+    void test_response_table();
+
+    /*!
+     * \brief Tests the evolvable biases of every neuron.
+     *
+     * Testing consists of mutating the biases apart and comparing
+     * the results of each precision, with and without the batch
+     * engine, to the reference implementation. Every neuron must
+     * start from the initial bias.
+     */
+    void test_neuron_biases();
+
+    /*!
+     * \brief Tests hidden layers of different widths.
+     *
+     * Testing consists of comparing the results of a tapered network
+     * with widths that do not fill whole SIMD registers to the
+     * reference implementation, in every precision and with the
+     * batch engine. The widths must survive a round trip through a
+     * scenario file.
+     */
+    void test_layer_widths();
+};
+
+#endif // TEST_NEURALNETWORK_HH
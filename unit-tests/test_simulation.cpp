@@ -0,0 +1,288 @@
+#include "test_simulation.hh"
+#include <fstream>
+
+TestSimulation::TestSimulation()
+{
+
+}
+
+TestSimulation::~TestSimulation()
+{
+
+}
+
+namespace
+{
+    /*!
+     * \class CountingObserver
+     * \brief Observer that counts the notifications of a manager.
+     */
+    class CountingObserver : public SimulationObserver
+    {
+    public:
+        unsigned int created = 0;
+        unsigned int updated = 0;
+        unsigned int cleared = 0;
+        unsigned int subjects = 0;
+        std::vector<unsigned int> generations;
+        std::vector<double> best;
+        std::vector<double> positions;
+        std::vector<TransitionTiming> transitions;
+
+        void subjectsCreated(const std::vector<SubjectCore*> &list)
+        {
+            created++;
+            subjects = static_cast<unsigned int>(list.size());
+        }
+
+        void subjectsUpdated(const std::vector<SubjectCore*> &list)
+        {
+            updated++;
+            subjects = static_cast<unsigned int>(list.size());
+            positions.clear();
+            for (SubjectCore *subject : list) {
+                positions.push_back(subject->getCoordinates().x);
+                positions.push_back(subject->getCoordinates().y);
+                positions.push_back(subject->getAngle());
+            }
+        }
+
+        void generationFinished(unsigned int generation,
+                                const std::vector<NeuralNetwork*> &networks)
+        {
+            generations.push_back(generation);
+            best.push_back(networks.front()->getFitness());
+            for (unsigned int i = 1; i < networks.size(); i++) {
+                QVERIFY(networks[i - 1]->getFitness()
+                        >= networks[i]->getFitness());
+            }
+        }
+
+        void transitionFinished(const TransitionTiming &timing)
+        {
+            transitions.push_back(timing);
+        }
+
+        void subjectsCleared()
+        {
+            cleared++;
+        }
+    };
+}
+
+void TestSimulation::test_headless_simulation()
+{
+    Settings *settings = Settings::get_settings();
+    settings->use_default_settings();
+    settings->set_instance_count(12);
+    settings->set_offspring_count(6);
+    settings->set_iteration_count(5);
+    Random rand;
+
+    SubjectCore target;
+    SubjectCore mousePoint;
+    target.setCoordinates(XY(350, 350));
+    SubjectCore::setPublicInstance(&target, 1);
+    SubjectCore::setPublicInstance(&mousePoint, 4);
+
+    CountingObserver observer;
+    {
+        Manager manager(settings, rand);
+        manager.set_observer(&observer);
+        manager.initialize(&target, nullptr, nullptr, &mousePoint, nullptr);
+        QCOMPARE(observer.created, 1u);
+        QCOMPARE(observer.subjects, 12u);
+
+        for (unsigned int i = 0; i < 15; i++) manager.update();
+        QCOMPARE(observer.updated, 15u);
+        QCOMPARE(manager.get_generation_count(), 4u);
+        QVERIFY(manager.get_best_network() != nullptr);
+        std::vector<unsigned int> finished = {1, 2, 3};
+        QVERIFY(observer.generations == finished);
+
+        // Starting over deletes the old subjects first.
+        manager.initialize(&target, nullptr, nullptr, &mousePoint, nullptr);
+        QCOMPARE(observer.cleared, 1u);
+        QCOMPARE(observer.created, 2u);
+    }
+    QCOMPARE(observer.cleared, 2u);
+
+    Manager manager(settings, rand);
+    manager.initialize(&target, nullptr, nullptr, &mousePoint, nullptr);
+    for (unsigned int i = 0; i < 10; i++) manager.update();
+    QCOMPARE(manager.get_generation_count(), 3u);
+
+    SubjectCore::setPublicInstance(nullptr, 1);
+    SubjectCore::setPublicInstance(nullptr, 4);
+    settings->use_default_settings();
+}
+
+void TestSimulation::test_batch_training()
+{
+    Settings *settings = Settings::get_settings();
+    settings->use_default_settings();
+    settings->set_instance_count(12);
+    settings->set_offspring_count(6);
+    settings->set_iteration_count(5);
+
+    SubjectCore target;
+    SubjectCore mousePoint;
+    target.setCoordinates(XY(350, 350));
+    mousePoint.setCoordinates(XY(-100, -100));
+    SubjectCore::setPublicInstance(&target, 1);
+    SubjectCore::setPublicInstance(&mousePoint, 4);
+
+    // The same seed must give the same run.
+    CountingObserver runs[2];
+    for (CountingObserver &observer : runs) {
+        Random rand(2020);
+        Manager manager(settings, rand);
+        manager.set_observer(&observer);
+        manager.initialize(&target, nullptr, nullptr, &mousePoint, nullptr);
+        for (unsigned int i = 0; i < 15; i++) manager.update();
+    }
+    QCOMPARE(static_cast<unsigned int>(runs[0].generations.size()), 3u);
+    QVERIFY(runs[0].generations == runs[1].generations);
+    QVERIFY(runs[0].best == runs[1].best);
+
+    Random rand(2020);
+    std::vector<NeuralNetwork*> networks;
+    for (unsigned int i = 0; i < 3; i++) {
+        networks.push_back(new NeuralNetwork(settings, rand));
+        networks.back()->mutate();
+    }
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    std::string path = dir.filePath("population.txt").toStdString();
+    QCOMPARE(Exporter::save_population(networks, path), 0);
+    QCOMPARE(Exporter::save_population(networks, dir.filePath("none/x.txt")
+                                       .toStdString()), 1);
+
+    // Every weight must survive the round trip through text exactly.
+    std::ifstream file(path);
+    std::string word;
+    unsigned int count = 0;
+    while (file >> word) {
+        if (word != "NETWORK") continue;
+        unsigned int index;
+        file >> index >> word;
+        QCOMPARE(index, count);
+        QCOMPARE(word, std::string("FITNESS"));
+        std::getline(file, word);
+        std::getline(file, word);
+        QCOMPARE(word.substr(0, 6), std::string("LAYERS"));
+        vector<Matrix> weights = networks[index]->getWeights();
+        vector<Row> biases = networks[index]->getBiases();
+        for (unsigned int i = 0; i < weights.size(); i++) {
+            unsigned int block;
+            file >> word >> block;
+            QCOMPARE(word, std::string("WEIGHTS"));
+            QCOMPARE(block, i);
+            for (const Row &row : weights[i]) {
+                for (double weight : row) {
+                    double value;
+                    file >> value;
+                    QVERIFY(value == weight);
+                }
+            }
+            file >> word >> block;
+            QCOMPARE(word, std::string("BIASES"));
+            for (double bias : biases[i]) {
+                double value;
+                file >> value;
+                QVERIFY(value == bias);
+            }
+        }
+        count++;
+    }
+    QCOMPARE(count, 3u);
+    for (NeuralNetwork *nn : networks) delete nn;
+
+    SubjectCore::setPublicInstance(nullptr, 1);
+    SubjectCore::setPublicInstance(nullptr, 4);
+    settings->use_default_settings();
+}
+
+void TestSimulation::test_parallel_update()
+{
+    Settings *settings = Settings::get_settings();
+    settings->use_default_settings();
+    settings->set_input_type(WALL_DISTANCES);
+    settings->set_output_type(FIXED_MOVEMENT);
+    settings->set_fitness_type(CLOSE_PROXIMITY);
+    settings->set_instance_count(150);
+    settings->set_offspring_count(50);
+    settings->set_iteration_count(20);
+    settings->set_breeding_method(CHILD_OF_THREE);
+    settings->set_spawn_location(SCATTERED);
+
+    SubjectCore target;
+    SubjectCore mousePoint;
+    target.setCoordinates(XY(350, 350));
+    mousePoint.setCoordinates(XY(-100, -100));
+    SubjectCore::setPublicInstance(&target, 1);
+    SubjectCore::setPublicInstance(&mousePoint, 4);
+
+    // Chunks run in parallel must give the same simulation as a single
+    // thread, bit for bit, in every precision.
+    std::vector<precision_type> precisions = {
+        DOUBLE_PRECISION, SINGLE_PRECISION, QUANTIZED_PRECISION
+    };
+    for (precision_type precision : precisions) {
+        settings->set_network_precision(precision);
+        std::vector<unsigned int> threadCounts = {1, 3, 8};
+        std::vector<CountingObserver> observers(threadCounts.size());
+        for (unsigned int i = 0; i < threadCounts.size(); i++) {
+            settings->set_thread_count(threadCounts[i]);
+            Random rand(77);
+            Manager manager(settings, rand);
+            manager.set_observer(&observers[i]);
+            manager.initialize(&target, nullptr, nullptr, &mousePoint,
+                               nullptr);
+            for (unsigned int j = 0; j < 50; j++) manager.update();
+
+            std::vector<WorkerStatistics> statistics =
+                    manager.get_worker_statistics();
+            QCOMPARE(static_cast<unsigned int>(statistics.size()),
+                     threadCounts[i]);
+            unsigned long total = 0;
+            for (const WorkerStatistics &worker : statistics) {
+                total += worker.tasks;
+            }
+            QVERIFY(total > 0);
+        }
+        QCOMPARE(static_cast<unsigned int>(observers[0].best.size()), 2u);
+        for (unsigned int i = 1; i < observers.size(); i++) {
+            QVERIFY(observers[i].best == observers[0].best);
+            QVERIFY(observers[i].positions == observers[0].positions);
+        }
+
+        // Every transition is timed, after its generation has ended.
+        for (const CountingObserver &observer : observers) {
+            QCOMPARE(static_cast<unsigned int>(observer.transitions.size()),
+                     2u);
+            for (unsigned int i = 0; i < observer.transitions.size(); i++) {
+                const TransitionTiming &timing = observer.transitions[i];
+                QCOMPARE(timing.generation, observer.generations[i]);
+                QVERIFY(timing.total >= timing.breeding);
+                QVERIFY(timing.total >= timing.restart);
+            }
+        }
+    }
+
+    // Several chunks are needed for the above to mean anything.
+    Random rand;
+    std::vector<NeuralNetwork*> networks;
+    for (unsigned int n = 0; n < 150; n++) {
+        networks.push_back(new NeuralNetwork(settings, rand));
+    }
+    BatchEngine engine;
+    engine.pack(networks);
+    QVERIFY(engine.getChunkSize() < 150);
+    for (NeuralNetwork *nn : networks) delete nn;
+
+    SubjectCore::setPublicInstance(nullptr, 1);
+    SubjectCore::setPublicInstance(nullptr, 4);
+    settings->set_thread_count(0);
+    settings->use_default_settings();
+}
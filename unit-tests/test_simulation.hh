@@ -0,0 +1,52 @@
+#ifndef TESTSIMULATION_HH
+#define TESTSIMULATION_HH
+
+#include <QtTest>
+#include "../shipyard/manager.hh"
+#include "../shipyard/batchengine.hh"
+#include "../shipyard/exporter.hh"
+
+/*!
+ * \class TestSimulation
+ * \brief Collection of test cases for running simulations without
+ * graphics.
+ * \author terratenff
+ */
+class TestSimulation : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestSimulation();
+    ~TestSimulation();
+
+private slots:
+
+    /*!
+     * \brief Tests running a simulation without graphics.
+     *
+     * Testing consists of running a manager through a few
+     * generations with plain subject cores, first with an observer
+     * that counts what it is told and then with no observer at all.
+     */
+    void test_headless_simulation();
+
+    /*!
+     * \brief Tests the pieces of a batch training run.
+     *
+     * Testing consists of running the same seed twice and comparing
+     * the generations, and reading a saved population back.
+     */
+    void test_batch_training();
+
+    /*!
+     * \brief Tests updating the subjects on several threads.
+     *
+     * Testing consists of running the same simulation, breeding
+     * included, with different numbers of threads in every precision
+     * and comparing the subjects afterwards.
+     */
+    void test_parallel_update();
+};
+
+#endif // TESTSIMULATION_HH
@@ -0,0 +1,56 @@
+#include "test_threadpool.hh"
+#include <atomic>
+#include <thread>
+
+TestThreadPool::TestThreadPool()
+{
+
+}
+
+TestThreadPool::~TestThreadPool()
+{
+
+}
+
+void TestThreadPool::test_thread_pool()
+{
+    // Every task runs exactly once, on a worker of the pool.
+    ThreadPool pool(4);
+    QCOMPARE(pool.getThreadCount(), 4u);
+    std::vector<std::atomic<unsigned int>> runs(1000);
+    std::atomic<bool> validWorkers(true);
+    for (unsigned int round = 0; round < 20; round++) {
+        pool.run(static_cast<unsigned int>(runs.size()),
+                 [&](unsigned int task, unsigned int worker) {
+            runs[task]++;
+            if (worker >= 4) validWorkers = false;
+        });
+    }
+    for (std::atomic<unsigned int> &count : runs) QCOMPARE(count.load(), 20u);
+    QVERIFY(validWorkers);
+
+    // Workers that run out of tasks steal the slow ones of worker 0.
+    pool.resetStatistics();
+    pool.run(40u, [](unsigned int task, unsigned int) {
+        if (task < 10) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    });
+    unsigned long tasks = 0;
+    unsigned long steals = 0;
+    for (const WorkerStatistics &statistics : pool.getStatistics()) {
+        tasks += statistics.tasks;
+        steals += statistics.steals;
+        QVERIFY(statistics.utilization >= 0);
+        QVERIFY(statistics.utilization <= 1);
+    }
+    QCOMPARE(tasks, 40ul);
+    QVERIFY(steals > 0);
+    QVERIFY(pool.getStatistics()[0].tasks < 40);
+    pool.resetStatistics();
+    QCOMPARE(pool.getStatistics()[0].tasks, 0ul);
+    pool.setThreadCount(1);
+    QCOMPARE(pool.getThreadCount(), 1u);
+    pool.setThreadCount(0);
+    QCOMPARE(pool.getThreadCount(), ThreadPool::hardware_threads());
+}
@@ -0,0 +1,33 @@
+#ifndef TESTTHREADPOOL_HH
+#define TESTTHREADPOOL_HH
+
+#include <QtTest>
+#include "../shipyard/threadpool.hh"
+
+/*!
+ * \class TestThreadPool
+ * \brief Collection of test cases for the thread pool.
+ * \author terratenff
+ */
+class TestThreadPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestThreadPool();
+    ~TestThreadPool();
+
+private slots:
+
+    /*!
+     * \brief Tests running tasks on the thread pool.
+     *
+     * Testing consists of running many tasks on a pool of four
+     * threads, each of which must run exactly once, and checking
+     * that idle threads steal slow tasks from a busy one. The
+     * statistics of the workers must add up to the tasks run.
+     */
+    void test_thread_pool();
+};
+
+#endif // TESTTHREADPOOL_HH
@@ -0,0 +1,144 @@
+#include "test_trainer.hh"
+#include <fstream>
+#include <sstream>
+
+TestTrainer::TestTrainer()
+{
+
+}
+
+TestTrainer::~TestTrainer()
+{
+
+}
+
+int TestTrainer::parse(std::vector<std::string> arguments,
+                       TrainerOptions &options)
+{
+    std::vector<char*> argv;
+    for (std::string &argument : arguments) argv.push_back(&argument[0]);
+    return Trainer::parse_options(static_cast<int>(argv.size()),
+                                  argv.data(), options);
+}
+
+void TestTrainer::test_parse_options()
+{
+    TrainerOptions options;
+    QCOMPARE(parse({"trainer", "run.txt"}, options), 0);
+    QCOMPARE(options.scenario, std::string("run.txt"));
+    QCOMPARE(options.generations, 100u);
+    QVERIFY(!options.seeded);
+    QCOMPARE(options.threads, 0u);
+    QCOMPARE(options.output, std::string("."));
+
+    options = TrainerOptions();
+    QCOMPARE(parse({"trainer", "-g", "5", "--seed", "42", "-t", "2",
+                    "-o", "results", "run.txt"}, options), 0);
+    QCOMPARE(options.scenario, std::string("run.txt"));
+    QCOMPARE(options.generations, 5u);
+    QVERIFY(options.seeded);
+    QCOMPARE(options.seed, 42u);
+    QCOMPARE(options.threads, 2u);
+    QCOMPARE(options.output, std::string("results"));
+
+    options = TrainerOptions();
+    QCOMPARE(parse({"trainer", "run.txt", "--help"}, options), 1);
+
+    std::vector<std::vector<std::string>> invalid = {
+        {"trainer", "-g", "0", "run.txt"},
+        {"trainer", "-g", "-1", "run.txt"},
+        {"trainer", "run.txt", "-g"},
+        {"trainer", "-s", "abc", "run.txt"},
+        {"trainer", "-s", "12x", "run.txt"},
+        {"trainer", "run.txt", "other.txt"},
+        {"trainer", "--unknown", "run.txt"},
+        {"trainer"}
+    };
+    for (const std::vector<std::string> &arguments : invalid) {
+        options = TrainerOptions();
+        QCOMPARE(parse(arguments, options), 2);
+    }
+}
+
+void TestTrainer::test_run()
+{
+    Settings *settings = Settings::get_settings();
+    settings->use_default_settings();
+    settings->set_instance_count(12);
+    settings->set_offspring_count(6);
+    settings->set_iteration_count(5);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    std::string scenario = dir.filePath("run.txt").toStdString();
+    Scenario(settings).save_scenario(scenario);
+    settings->use_default_settings();
+
+    TrainerOptions options;
+    options.scenario = scenario;
+    options.generations = 2;
+    options.seed = 2020;
+    options.seeded = true;
+    options.threads = 1;
+    options.output = dir.filePath("results").toStdString();
+    QCOMPARE(Trainer(options).run(), 0);
+
+    // A header and a row for each generation.
+    std::ifstream statistics(options.output + "/generations.csv");
+    QVERIFY(statistics.is_open());
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(statistics, line)) lines.push_back(line);
+    QCOMPARE(static_cast<unsigned int>(lines.size()), 3u);
+    QCOMPARE(lines[0],
+             std::string("generation,best,mean,worst,seconds,transition"));
+    QCOMPARE(lines[1].substr(0, 2), std::string("1,"));
+    QCOMPARE(lines[2].substr(0, 2), std::string("2,"));
+
+    // Every network of the final population, and the best one alone.
+    std::ifstream population(options.output + "/population.txt");
+    QVERIFY(population.is_open());
+    std::string word;
+    unsigned int networks = 0;
+    while (population >> word) {
+        if (word == "NETWORK") networks++;
+    }
+    QCOMPARE(networks, 12u);
+    std::ifstream header(options.output + "/best.hh");
+    QVERIFY(header.is_open());
+    std::string text((std::istreambuf_iterator<char>(header)),
+                     std::istreambuf_iterator<char>());
+    QVERIFY(text.find("namespace best\n") != std::string::npos);
+
+    // With response tables, their largest error gets a column.
+    settings->set_instance_count(12);
+    settings->set_offspring_count(6);
+    settings->set_iteration_count(5);
+    settings->set_response_table_size(64);
+    Scenario(settings).save_scenario(scenario);
+    settings->use_default_settings();
+    options.output = dir.filePath("tables").toStdString();
+    QCOMPARE(Trainer(options).run(), 0);
+    std::ifstream tables(options.output + "/generations.csv");
+    lines.clear();
+    while (std::getline(tables, line)) lines.push_back(line);
+    QCOMPARE(static_cast<unsigned int>(lines.size()), 3u);
+    QCOMPARE(lines[0], std::string("generation,best,mean,worst,seconds,"
+                                   "table_error,transition"));
+    for (unsigned int i = 1; i < lines.size(); i++) {
+        std::vector<double> values;
+        std::istringstream row(lines[i]);
+        std::string value;
+        while (std::getline(row, value, ',')) {
+            values.push_back(std::stod(value));
+        }
+        QCOMPARE(static_cast<unsigned int>(values.size()), 7u);
+        QVERIFY(values[5] > 0);
+        QVERIFY(values[5] < 0.1);
+    }
+
+    options.scenario = dir.filePath("none.txt").toStdString();
+    QCOMPARE(Trainer(options).run(), 1);
+
+    settings->use_default_settings();
+}
@@ -0,0 +1,58 @@
+#ifndef TESTTRAINER_HH
+#define TESTTRAINER_HH
+
+#include <QtTest>
+#include "../trainer/trainer.hh"
+#include "../shipyard/scenario.hh"
+
+/*!
+ * \class TestTrainer
+ * \brief Collection of test cases for the command-line batch trainer.
+ * \author terratenff
+ */
+class TestTrainer : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestTrainer();
+    ~TestTrainer();
+
+private:
+
+    /*!
+     * \fn parse
+     * \brief Convenient function for parsing a command line.
+     * \param arguments Arguments, the first of which is the program
+     * name.
+     * \param options Options to fill in.
+     * \return Outcome of Trainer::parse_options.
+     */
+    int parse(std::vector<std::string> arguments, TrainerOptions &options);
+
+private slots:
+
+    /*!
+     * \brief Tests reading the options of a run.
+     *
+     * Testing consists of valid command lines, with and without
+     * options, a request for help and invalid command lines: zero
+     * generations, an option without its value, a seed that is not a
+     * number, a second scenario file and no scenario file at all.
+     */
+    void test_parse_options();
+
+    /*!
+     * \brief Tests a short batch training run.
+     *
+     * Testing consists of running a saved scenario for two
+     * generations into a new directory. The statistics of both
+     * generations, the final population and the header of its best
+     * network must be written there. With response tables, their
+     * largest error must be recorded for each generation. A missing
+     * scenario file must fail the run.
+     */
+    void test_run();
+};
+
+#endif // TESTTRAINER_HH
@@ -1,23 +1,43 @@
 QT += testlib
 QT -= gui
 
-CONFIG += qt console warn_on depend_includepath testcase
+CONFIG += qt console warn_on depend_includepath testcase c++17
 CONFIG -= app_bundle
 
 TEMPLATE = app
 
 SOURCES +=  \
-    ../shipyard/fitness.cpp \
-    ../shipyard/inputoutput.cpp \
-    ../shipyard/math.cpp \
-    ../shipyard/settings.cpp \
-    ../shipyard/scenario.cpp \
+    ../trainer/trainer.cpp \
+    test_exporter.cpp \
     test_inputoutput.cpp \
     test_main.cpp \
     test_math.cpp \
-    test_fitness.cpp
+    test_fitness.cpp \
+    test_neuralnetwork.cpp \
+    test_simulation.cpp \
+    test_threadpool.cpp \
+    test_trainer.cpp
 
 HEADERS += \
+    ../trainer/trainer.hh \
+    exported_network.hh \
+    test_exporter.hh \
     test_inputoutput.hh \
     test_fitness.hh \
-    test_math.hh
+    test_math.hh \
+    test_neuralnetwork.hh \
+    test_simulation.hh \
+    test_threadpool.hh \
+    test_trainer.hh
+
+unix:!macx: LIBS += -lstdc++fs
+
+win32:CONFIG(release, debug|release): LIBS += -L$$OUT_PWD/../core/release/ -lcore
+else:win32:CONFIG(debug, debug|release): LIBS += -L$$OUT_PWD/../core/debug/ -lcore
+else:unix: LIBS += -L$$OUT_PWD/../core/ -lcore
+
+win32-g++:CONFIG(release, debug|release): PRE_TARGETDEPS += $$OUT_PWD/../core/release/libcore.a
+else:win32-g++:CONFIG(debug, debug|release): PRE_TARGETDEPS += $$OUT_PWD/../core/debug/libcore.a
+else:win32:!win32-g++:CONFIG(release, debug|release): PRE_TARGETDEPS += $$OUT_PWD/../core/release/core.lib
+else:win32:!win32-g++:CONFIG(debug, debug|release): PRE_TARGETDEPS += $$OUT_PWD/../core/debug/core.lib
+else:unix: PRE_TARGETDEPS += $$OUT_PWD/../core/libcore.a
@@ -1,5 +1,11 @@
 TEMPLATE = subdirs
 
 SUBDIRS += \
+    core \
     shipyard \
+    trainer \
     unit-tests
+
+shipyard.depends = core
+trainer.depends = core
+unit-tests.depends = core